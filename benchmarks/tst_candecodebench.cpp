@@ -0,0 +1,163 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <cstring>
+#include "../src/Controllers/can/include/candecoder.h"
+#include "../src/Controllers/can/include/signaldatabase.h"
+
+/**
+ * @brief Hand-written CANDecoder functions against compiled DBC decode plans
+ *
+ * Decodes the same mix of 0x071-0x076 packets with both. The hand-written row
+ * follows the parser workers (extract payload, switch on ID, decodeX); the
+ * plan row looks the ID up and runs the plan loop on the packet in place.
+ * Both fold every decoded value into a checksum so nothing is optimized away.
+ */
+class CanDecodeBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void planMatchesHandwritten();
+    void handwritten();
+    void handwrittenNoCopy();
+    void decodePlan();
+
+private:
+    static double decodeHandwritten(uint32_t canId, const QByteArray &payload);
+
+    SignalDatabase m_database;
+    QList<QByteArray> m_packets;
+};
+
+static const int FRAME_COUNT = 100000;
+static const int MAX_SIGNALS = 16;
+
+static QByteArray makePacket(uint32_t canId, uint64_t payload)
+{
+    QByteArray packet(CANDecoder::PACKET_SIZE, '\0');
+    std::memcpy(packet.data() + 4, &canId, sizeof(canId));
+    packet[8] = 8;
+    std::memcpy(packet.data() + 9, &payload, sizeof(payload));
+    return packet;
+}
+
+void CanDecodeBench::initTestCase()
+{
+    QString error;
+    QVERIFY2(m_database.loadFile(QStringLiteral(ASURT_DBC_PATH), &error), qPrintable(error));
+
+    QRandomGenerator rng(0x5eed);
+    const uint32_t ids[] = {
+        CANDecoder::CAN_ID_IMU_ANGLE, CANDecoder::CAN_ID_IMU_ACCEL, CANDecoder::CAN_ID_ADC,
+        CANDecoder::CAN_ID_PROXIMITY_ENCODER, CANDecoder::CAN_ID_GPS, CANDecoder::CAN_ID_TEMPERATURES
+    };
+    m_packets.reserve(FRAME_COUNT);
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        uint64_t payload = rng.generate64();
+        const uint32_t canId = ids[i % 6];
+        if (canId == CANDecoder::CAN_ID_GPS) {
+            // Keep coordinates finite so the checksums compare
+            const float coords[2] = {31.2f + (i % 100) * 1e-4f, 30.0f - (i % 50) * 1e-4f};
+            std::memcpy(&payload, coords, sizeof(payload));
+        }
+        m_packets.append(makePacket(canId, payload));
+    }
+}
+
+double CanDecodeBench::decodeHandwritten(uint32_t canId, const QByteArray &payload)
+{
+    switch (canId) {
+    case CANDecoder::CAN_ID_IMU_ANGLE: {
+        const CANDecoder::IMUAngle d = CANDecoder::decodeIMUAngle(payload);
+        return d.ang_x + d.ang_y + d.ang_z;
+    }
+    case CANDecoder::CAN_ID_IMU_ACCEL: {
+        const CANDecoder::IMUAccel d = CANDecoder::decodeIMUAccel(payload);
+        return d.longitudinal_g + d.lateral_g + d.accel_z;
+    }
+    case CANDecoder::CAN_ID_ADC: {
+        const CANDecoder::ADCData d = CANDecoder::decodeADC(payload);
+        return d.sus_1 + d.sus_2 + d.sus_3 + d.sus_4 + d.brake_pedal + d.acc_pedal;
+    }
+    case CANDecoder::CAN_ID_PROXIMITY_ENCODER: {
+        const CANDecoder::ProximityAndEncoder d = CANDecoder::decodeProximityAndEncoder(payload);
+        return d.speed_fl + d.speed_fr + d.speed_bl + d.speed_br + d.encoder_angle + d.speed_kmh;
+    }
+    case CANDecoder::CAN_ID_GPS: {
+        const CANDecoder::GPS d = CANDecoder::decodeGPS(payload);
+        return double(d.longitude) + double(d.latitude);
+    }
+    case CANDecoder::CAN_ID_TEMPERATURES: {
+        const CANDecoder::Temperatures d = CANDecoder::decodeTemperatures(payload);
+        return d.temp_fl + d.temp_fr + d.temp_rl + d.temp_rr;
+    }
+    default:
+        return 0.0;
+    }
+}
+
+void CanDecodeBench::planMatchesHandwritten()
+{
+    double values[MAX_SIGNALS];
+    for (const QByteArray &packet : std::as_const(m_packets)) {
+        const uint32_t canId = CANDecoder::extractCANId(packet);
+        const double expected = decodeHandwritten(canId, CANDecoder::extractPayload(packet));
+
+        const int count = m_database.decode(canId, reinterpret_cast<const uint8_t *>(packet.constData()) + 9, values, MAX_SIGNALS);
+        QVERIFY(count > 0);
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i) {
+            sum += values[i];
+        }
+        // Scales are stored as decimals in the DBC, so allow rounding differences
+        QVERIFY2(qAbs(sum - expected) <= 1e-6 * qMax(1.0, qAbs(expected)),
+                 qPrintable(QString("ID 0x%1: %2 != %3").arg(canId, 0, 16).arg(sum).arg(expected)));
+    }
+}
+
+void CanDecodeBench::handwritten()
+{
+    double checksum = 0.0;
+    QBENCHMARK {
+        for (const QByteArray &packet : std::as_const(m_packets)) {
+            checksum += decodeHandwritten(CANDecoder::extractCANId(packet), CANDecoder::extractPayload(packet));
+        }
+    }
+    QVERIFY(checksum != 0.0);
+}
+
+void CanDecodeBench::handwrittenNoCopy()
+{
+    // Same decoders without the payload copy, to compare the decode alone
+    double checksum = 0.0;
+    QBENCHMARK {
+        for (const QByteArray &packet : std::as_const(m_packets)) {
+            const QByteArray payload = QByteArray::fromRawData(packet.constData() + 9, 8);
+            checksum += decodeHandwritten(CANDecoder::extractCANId(packet), payload);
+        }
+    }
+    QVERIFY(checksum != 0.0);
+}
+
+void CanDecodeBench::decodePlan()
+{
+    double checksum = 0.0;
+    double values[MAX_SIGNALS];
+    QBENCHMARK {
+        for (const QByteArray &packet : std::as_const(m_packets)) {
+            const uint8_t *data = reinterpret_cast<const uint8_t *>(packet.constData());
+            uint32_t canId;
+            std::memcpy(&canId, data + 4, sizeof(canId));
+
+            const int count = m_database.decode(canId, data + 9, values, MAX_SIGNALS);
+            for (int i = 0; i < count; ++i) {
+                checksum += values[i];
+            }
+        }
+    }
+    QVERIFY(checksum != 0.0);
+}
+
+QTEST_GUILESS_MAIN(CanDecodeBench)
+#include "tst_candecodebench.moc"
@@ -0,0 +1,147 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "../src/Controllers/can/include/candecoder.h"
+#include "../src/Controllers/can/include/candispatchtable.h"
+
+/**
+ * @brief CAN ID dispatch throughput with 256 registered IDs
+ *
+ * 200 standard and 56 extended IDs are registered. The frame stream picks
+ * registered IDs at random, plus 5% unregistered ones. The dense-array table
+ * is compared with a hash for every ID, and with a binary search over the
+ * sorted IDs, which is what a compiler makes of a large sparse switch.
+ * Results are reported in frames per second.
+ */
+class CanDispatchBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void dispatchTable();
+    void hashOnly();
+    void sortedSearch();
+
+private:
+    struct Context {
+        quint64 hits[4] = {};
+        quint64 unknown = 0;
+    };
+    using Table = CANDispatchTable<Context>;
+    using Handler = Table::Handler;
+
+    template <int N>
+    static bool count(const CANDecoder::Frame &, Context &context)
+    {
+        ++context.hits[N];
+        return true;
+    }
+
+    template <typename Lookup>
+    void run(Lookup &&lookup);
+
+    Table m_table;
+    QHash<uint32_t, Handler> m_hash;
+    std::vector<std::pair<uint32_t, Handler>> m_sorted;
+    std::vector<CANDecoder::Frame> m_frames;
+    quint64 m_expectedUnknown = 0;
+};
+
+static const int STANDARD_IDS = 200;
+static const int EXTENDED_IDS = 56;
+static const int FRAME_COUNT = 1000000;
+static const int RUNS = 3;
+
+void CanDispatchBench::initTestCase()
+{
+    static const Handler handlers[] = {count<0>, count<1>, count<2>, count<3>};
+    static const char payload[8] = {};
+
+    QRandomGenerator rng(0x5eed);
+    std::vector<uint32_t> ids;
+    while (ids.size() < size_t(STANDARD_IDS + EXTENDED_IDS)) {
+        const uint32_t id = ids.size() < size_t(STANDARD_IDS)
+            ? rng.bounded(CANDecoder::CAN_SFF_MASK + 1)
+            : CANDecoder::CAN_EFF_FLAG | (rng.generate() & CANDecoder::CAN_EFF_MASK);
+        const Handler handler = handlers[ids.size() % 4];
+        if (m_table.registerHandler(id, handler)) {
+            ids.push_back(id);
+            m_hash.insert(id, handler);
+            m_sorted.emplace_back(id, handler);
+        }
+    }
+    std::sort(m_sorted.begin(), m_sorted.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    QCOMPARE(m_table.size(), STANDARD_IDS + EXTENDED_IDS);
+    QVERIFY(!m_table.registerHandler(ids.front(), handlers[0]));
+
+    m_frames.resize(FRAME_COUNT);
+    for (CANDecoder::Frame &frame : m_frames) {
+        frame.timestamp = 0;
+        frame.dlc = 8;
+        frame.fd = false;
+        frame.payload = QByteArrayView(payload, sizeof(payload));
+        if (rng.bounded(100) < 5) {
+            // Unregistered standard ID
+            do {
+                frame.id = rng.bounded(CANDecoder::CAN_SFF_MASK + 1);
+            } while (m_table.find(frame.id));
+            ++m_expectedUnknown;
+        } else {
+            frame.id = ids[rng.bounded(int(ids.size()))];
+        }
+    }
+}
+
+template <typename Lookup>
+void CanDispatchBench::run(Lookup &&lookup)
+{
+    qint64 bestNs = std::numeric_limits<qint64>::max();
+    Context context;
+    for (int r = 0; r < RUNS; ++r) {
+        context = Context();
+        QElapsedTimer timer;
+        timer.start();
+        for (const CANDecoder::Frame &frame : m_frames) {
+            if (const Handler handler = lookup(frame.id)) {
+                handler(frame, context);
+            } else {
+                ++context.unknown;
+            }
+        }
+        bestNs = qMin(bestNs, timer.nsecsElapsed());
+    }
+    QCOMPARE(context.unknown, m_expectedUnknown);
+    QCOMPARE(context.hits[0] + context.hits[1] + context.hits[2] + context.hits[3],
+             quint64(FRAME_COUNT) - m_expectedUnknown);
+    QTest::setBenchmarkResult(FRAME_COUNT * 1e9 / bestNs, QTest::FramesPerSecond);
+}
+
+void CanDispatchBench::dispatchTable()
+{
+    run([this](uint32_t id) { return m_table.find(id); });
+}
+
+void CanDispatchBench::hashOnly()
+{
+    run([this](uint32_t id) { return m_hash.value(id, nullptr); });
+}
+
+void CanDispatchBench::sortedSearch()
+{
+    run([this](uint32_t id) -> Handler {
+        const auto it = std::lower_bound(m_sorted.begin(), m_sorted.end(), id,
+                                         [](const std::pair<uint32_t, Handler> &entry, uint32_t key) {
+                                             return entry.first < key;
+                                         });
+        return it != m_sorted.end() && it->first == id ? it->second : nullptr;
+    });
+}
+
+QTEST_GUILESS_MAIN(CanDispatchBench)
+#include "tst_candispatchbench.moc"
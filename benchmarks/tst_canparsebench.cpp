@@ -0,0 +1,268 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <cstring>
+#include "../src/Controllers/can/include/candecoder.h"
+#include "../src/Controllers/logging/include/asynclogger.h"
+#include "../src/Controllers/mqtt/include/mqttparserworker.h"
+#include "../src/Controllers/serial/include/serialparserworker.h"
+#include "../src/Controllers/udp/include/udpparserworker.h"
+
+/**
+ * @brief Baseline cost of the CAN hot path, from one decoder to a whole parse
+ *
+ * decode times each CANDecoder::decodeX on 1000 payloads of its own ID.
+ * extractCANId reads the ID of every packet in the frame mix. parsePath feeds
+ * the mix to each parser worker's parse function on the benchmark thread,
+ * with the dispatch table, state writes, error counting and AsyncLogger
+ * included but not the queue. The mix follows the car's message rates, plus
+ * 1% unknown IDs and 0.5% truncated records. Deduplication is off, so every
+ * iteration takes the full path instead of dropping repeats.
+ */
+class CanParseBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void decode_data();
+    void decode();
+    void extractCANId_data();
+    void extractCANId();
+    void parsePath_data();
+    void parsePath();
+
+private:
+    template <typename Decode>
+    void benchDecode(Decode &&decode);
+
+    template <typename Worker, typename Parse>
+    void benchParse(Worker *worker, Parse &&parse);
+
+    QTemporaryDir m_logDir;
+    QList<QByteArray> m_payloads;
+    QList<QByteArray> m_packets;
+};
+
+static const int PAYLOAD_COUNT = 1000;
+static const int FRAME_COUNT = 10000;
+static const uint32_t UNKNOWN_ID = 0x7FF;
+
+// Messages per second on the car
+static const struct {
+    uint32_t id;
+    int rateHz;
+} MESSAGE_RATES[] = {
+    {CANDecoder::CAN_ID_IMU_ANGLE, 100},
+    {CANDecoder::CAN_ID_IMU_ACCEL, 100},
+    {CANDecoder::CAN_ID_ADC, 100},
+    {CANDecoder::CAN_ID_PROXIMITY_ENCODER, 50},
+    {CANDecoder::CAN_ID_GPS, 10},
+    {CANDecoder::CAN_ID_TEMPERATURES, 1},
+};
+
+static QByteArray makePacket(uint32_t timestamp, uint32_t canId, uint64_t payload)
+{
+    QByteArray packet(CANDecoder::PACKET_SIZE, '\0');
+    std::memcpy(packet.data(), &timestamp, sizeof(timestamp));
+    std::memcpy(packet.data() + 4, &canId, sizeof(canId));
+    packet[8] = 8;
+    std::memcpy(packet.data() + 9, &payload, sizeof(payload));
+    return packet;
+}
+
+void CanParseBench::initTestCase()
+{
+    QVERIFY(m_logDir.isValid());
+    AsyncLogger::instance().initialize(m_logDir.path());
+    QVERIFY(AsyncLogger::instance().waitUntilReady());
+
+    QRandomGenerator rng(0x5eed);
+    m_payloads.reserve(PAYLOAD_COUNT);
+    for (int i = 0; i < PAYLOAD_COUNT; ++i) {
+        const uint64_t payload = rng.generate64();
+        m_payloads.append(QByteArray(reinterpret_cast<const char *>(&payload), sizeof(payload)));
+    }
+
+    int totalRate = 0;
+    for (const auto &message : MESSAGE_RATES) {
+        totalRate += message.rateHz;
+    }
+
+    m_packets.reserve(FRAME_COUNT);
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        const uint32_t timestamp = static_cast<uint32_t>(i + 1);
+        const int roll = rng.bounded(1000);
+        if (roll < 5) {
+            m_packets.append(makePacket(timestamp, CANDecoder::CAN_ID_ADC, rng.generate64()).left(12));
+            continue;
+        }
+        if (roll < 15) {
+            m_packets.append(makePacket(timestamp, UNKNOWN_ID, rng.generate64()));
+            continue;
+        }
+
+        int pick = rng.bounded(totalRate);
+        uint32_t canId = MESSAGE_RATES[0].id;
+        for (const auto &message : MESSAGE_RATES) {
+            if (pick < message.rateHz) {
+                canId = message.id;
+                break;
+            }
+            pick -= message.rateHz;
+        }
+        m_packets.append(makePacket(timestamp, canId, rng.generate64()));
+    }
+}
+
+void CanParseBench::cleanupTestCase()
+{
+    AsyncLogger::instance().shutdown();
+}
+
+template <typename Decode>
+void CanParseBench::benchDecode(Decode &&decode)
+{
+    double checksum = 0.0;
+    QBENCHMARK {
+        for (const QByteArray &payload : std::as_const(m_payloads)) {
+            checksum += decode(QByteArrayView(payload));
+        }
+    }
+    QVERIFY(checksum != 0.0);
+}
+
+void CanParseBench::decode_data()
+{
+    QTest::addColumn<uint>("canId");
+    QTest::newRow("imuAngle") << uint(CANDecoder::CAN_ID_IMU_ANGLE);
+    QTest::newRow("imuAccel") << uint(CANDecoder::CAN_ID_IMU_ACCEL);
+    QTest::newRow("adc") << uint(CANDecoder::CAN_ID_ADC);
+    QTest::newRow("proximityEncoder") << uint(CANDecoder::CAN_ID_PROXIMITY_ENCODER);
+    QTest::newRow("gps") << uint(CANDecoder::CAN_ID_GPS);
+    QTest::newRow("temperatures") << uint(CANDecoder::CAN_ID_TEMPERATURES);
+}
+
+void CanParseBench::decode()
+{
+    QFETCH(uint, canId);
+
+    switch (canId) {
+    case CANDecoder::CAN_ID_IMU_ANGLE:
+        benchDecode([](QByteArrayView payload) {
+            const CANDecoder::IMUAngle d = CANDecoder::decodeIMUAngle(payload);
+            return double(d.ang_x + d.ang_y + d.ang_z);
+        });
+        break;
+    case CANDecoder::CAN_ID_IMU_ACCEL:
+        benchDecode([](QByteArrayView payload) {
+            const CANDecoder::IMUAccel d = CANDecoder::decodeIMUAccel(payload);
+            return d.lateral_g + d.longitudinal_g + d.accel_z;
+        });
+        break;
+    case CANDecoder::CAN_ID_ADC:
+        benchDecode([](QByteArrayView payload) {
+            const CANDecoder::ADCData d = CANDecoder::decodeADC(payload);
+            return double(d.sus_1 + d.sus_2 + d.sus_3 + d.sus_4 + d.brake_pedal + d.acc_pedal);
+        });
+        break;
+    case CANDecoder::CAN_ID_PROXIMITY_ENCODER:
+        benchDecode([](QByteArrayView payload) {
+            const CANDecoder::ProximityAndEncoder d = CANDecoder::decodeProximityAndEncoder(payload);
+            return d.speed_fl + d.speed_fr + d.speed_bl + d.speed_br + d.encoder_angle + d.speed_kmh;
+        });
+        break;
+    case CANDecoder::CAN_ID_GPS:
+        benchDecode([](QByteArrayView payload) {
+            // Random bits include NaNs; fold the raw words instead of the floats
+            const CANDecoder::GPS d = CANDecoder::decodeGPS(payload);
+            uint32_t bits[2];
+            std::memcpy(&bits[0], &d.longitude, sizeof(bits[0]));
+            std::memcpy(&bits[1], &d.latitude, sizeof(bits[1]));
+            return double(bits[0] ^ bits[1]);
+        });
+        break;
+    case CANDecoder::CAN_ID_TEMPERATURES:
+        benchDecode([](QByteArrayView payload) {
+            const CANDecoder::Temperatures d = CANDecoder::decodeTemperatures(payload);
+            return double(d.temp_fl + d.temp_fr + d.temp_rl + d.temp_rr);
+        });
+        break;
+    default:
+        QFAIL("No decoder for this ID");
+    }
+}
+
+void CanParseBench::extractCANId_data()
+{
+    QTest::addColumn<bool>("view");
+    QTest::newRow("byteArray") << false;
+    QTest::newRow("view") << true;
+}
+
+void CanParseBench::extractCANId()
+{
+    QFETCH(bool, view);
+
+    quint64 checksum = 0;
+    if (view) {
+        QBENCHMARK {
+            for (const QByteArray &packet : std::as_const(m_packets)) {
+                checksum += CANDecoder::extractCANId(QByteArrayView(packet));
+            }
+        }
+    } else {
+        QBENCHMARK {
+            for (const QByteArray &packet : std::as_const(m_packets)) {
+                checksum += CANDecoder::extractCANId(packet);
+            }
+        }
+    }
+    QVERIFY(checksum != 0);
+}
+
+template <typename Worker, typename Parse>
+void CanParseBench::benchParse(Worker *worker, Parse &&parse)
+{
+    QBENCHMARK {
+        for (const QByteArray &packet : std::as_const(m_packets)) {
+            parse(worker, QByteArrayView(packet));
+        }
+    }
+    delete worker;
+}
+
+void CanParseBench::parsePath_data()
+{
+    QTest::addColumn<QString>("transport");
+    QTest::newRow("udp") << QStringLiteral("udp");
+    QTest::newRow("serial") << QStringLiteral("serial");
+    QTest::newRow("mqtt") << QStringLiteral("mqtt");
+}
+
+void CanParseBench::parsePath()
+{
+    QFETCH(QString, transport);
+
+    TelemetryState state(1);
+    FrameErrorCounters errors;
+    if (transport == QLatin1String("udp")) {
+        benchParse(new UdpParserWorker(&state, nullptr, &errors, 0),
+                   [](UdpParserWorker *worker, QByteArrayView packet) { worker->parseDatagram(packet); });
+    } else if (transport == QLatin1String("serial")) {
+        benchParse(new SerialParserWorker(&state, nullptr, &errors, 0),
+                   [](SerialParserWorker *worker, QByteArrayView packet) { worker->parseData(packet); });
+    } else {
+        benchParse(new MqttParserWorker(&state, nullptr, &errors, 0),
+                   [](MqttParserWorker *worker, QByteArrayView packet) { worker->parseMessage(packet); });
+    }
+
+    // Unknown and truncated frames took the error path, nothing threw
+    QVERIFY(errors.total(FrameErrorCounters::UnknownId) > 0);
+    QVERIFY(errors.total(FrameErrorCounters::InvalidRecord) > 0);
+    QCOMPARE(errors.total(FrameErrorCounters::DecodeFailure), quint64(0));
+}
+
+QTEST_GUILESS_MAIN(CanParseBench)
+#include "tst_canparsebench.moc"
@@ -0,0 +1,158 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <cstring>
+#include <vector>
+#include "../src/Controllers/can/include/candecoder.h"
+#include "../src/Controllers/can/include/canunpack.h"
+
+/**
+ * @brief SIMD unpack kernels against the scalar CANDecoder functions
+ *
+ * Every kernel set the CPU supports is first checked bit for bit against
+ * CANDecoder::decodeADC and decodeProximityAndEncoder, then timed on the
+ * same random payloads. The frame count is odd so the scalar tails run too.
+ */
+class CanUnpackBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void bitExact_data();
+    void bitExact();
+    void unpackADC_data();
+    void unpackADC();
+    void unpackProximityEncoder_data();
+    void unpackProximityEncoder();
+
+private:
+    static void addIsaRows();
+
+    std::vector<uint64_t> m_raw;
+};
+
+static const qsizetype FRAME_COUNT = 1000003;
+
+void CanUnpackBench::initTestCase()
+{
+    QRandomGenerator rng(0x5eed);
+    m_raw.resize(FRAME_COUNT);
+    for (uint64_t &raw : m_raw) {
+        raw = rng.generate64();
+    }
+    qInfo() << "Detected kernel set:" << CANUnpack::detectedIsa();
+}
+
+void CanUnpackBench::cleanupTestCase()
+{
+    CANUnpack::setActiveIsa(CANUnpack::detectedIsa());
+}
+
+void CanUnpackBench::addIsaRows()
+{
+    QTest::addColumn<int>("isa");
+    QTest::newRow("scalar") << int(CANUnpack::Scalar);
+    if (CANUnpack::detectedIsa() >= CANUnpack::Sse41) {
+        QTest::newRow("sse4.1") << int(CANUnpack::Sse41);
+    }
+    if (CANUnpack::detectedIsa() >= CANUnpack::Avx2) {
+        QTest::newRow("avx2") << int(CANUnpack::Avx2);
+    }
+}
+
+void CanUnpackBench::bitExact_data()
+{
+    addIsaRows();
+}
+
+void CanUnpackBench::bitExact()
+{
+    QFETCH(int, isa);
+    QVERIFY(CANUnpack::setActiveIsa(static_cast<CANUnpack::Isa>(isa)));
+
+    std::vector<uint16_t> adc[6];
+    for (std::vector<uint16_t> &column : adc) {
+        column.resize(FRAME_COUNT);
+    }
+    CANUnpack::unpackADC(m_raw.data(), FRAME_COUNT, {
+        adc[0].data(), adc[1].data(), adc[2].data(), adc[3].data(), adc[4].data(), adc[5].data()
+    });
+
+    std::vector<double> speed[4];
+    for (std::vector<double> &column : speed) {
+        column.resize(FRAME_COUNT);
+    }
+    std::vector<uint16_t> encoder(FRAME_COUNT);
+    std::vector<uint8_t> speedKmh(FRAME_COUNT);
+    CANUnpack::unpackProximityEncoder(m_raw.data(), FRAME_COUNT, {
+        speed[0].data(), speed[1].data(), speed[2].data(), speed[3].data(), encoder.data(), speedKmh.data()
+    });
+
+    QByteArray payload(8, '\0');
+    for (qsizetype i = 0; i < FRAME_COUNT; ++i) {
+        std::memcpy(payload.data(), &m_raw[i], sizeof(uint64_t));
+
+        const CANDecoder::ADCData a = CANDecoder::decodeADC(payload);
+        const uint16_t expectedAdc[6] = {a.sus_1, a.sus_2, a.sus_3, a.sus_4, a.brake_pedal, a.acc_pedal};
+        for (int field = 0; field < 6; ++field) {
+            QCOMPARE(adc[field][i], expectedAdc[field]);
+        }
+
+        const CANDecoder::ProximityAndEncoder p = CANDecoder::decodeProximityAndEncoder(payload);
+        const double expectedSpeed[4] = {p.speed_fl, p.speed_fr, p.speed_bl, p.speed_br};
+        for (int wheel = 0; wheel < 4; ++wheel) {
+            // Compare the bits, not the values
+            QVERIFY(std::memcmp(&speed[wheel][i], &expectedSpeed[wheel], sizeof(double)) == 0);
+        }
+        QCOMPARE(encoder[i], p.encoder_angle);
+        QCOMPARE(speedKmh[i], p.speed_kmh);
+    }
+}
+
+void CanUnpackBench::unpackADC_data()
+{
+    addIsaRows();
+}
+
+void CanUnpackBench::unpackADC()
+{
+    QFETCH(int, isa);
+    QVERIFY(CANUnpack::setActiveIsa(static_cast<CANUnpack::Isa>(isa)));
+
+    std::vector<uint16_t> adc[6];
+    for (std::vector<uint16_t> &column : adc) {
+        column.resize(FRAME_COUNT);
+    }
+    QBENCHMARK {
+        CANUnpack::unpackADC(m_raw.data(), FRAME_COUNT, {
+            adc[0].data(), adc[1].data(), adc[2].data(), adc[3].data(), adc[4].data(), adc[5].data()
+        });
+    }
+}
+
+void CanUnpackBench::unpackProximityEncoder_data()
+{
+    addIsaRows();
+}
+
+void CanUnpackBench::unpackProximityEncoder()
+{
+    QFETCH(int, isa);
+    QVERIFY(CANUnpack::setActiveIsa(static_cast<CANUnpack::Isa>(isa)));
+
+    std::vector<double> speed[4];
+    for (std::vector<double> &column : speed) {
+        column.resize(FRAME_COUNT);
+    }
+    std::vector<uint16_t> encoder(FRAME_COUNT);
+    std::vector<uint8_t> speedKmh(FRAME_COUNT);
+    QBENCHMARK {
+        CANUnpack::unpackProximityEncoder(m_raw.data(), FRAME_COUNT, {
+            speed[0].data(), speed[1].data(), speed[2].data(), speed[3].data(), encoder.data(), speedKmh.data()
+        });
+    }
+}
+
+QTEST_GUILESS_MAIN(CanUnpackBench)
+#include "tst_canunpackbench.moc"
@@ -0,0 +1,151 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "../src/Controllers/can/include/candecoder.h"
+#include "../src/Controllers/logging/include/logblockcodec.h"
+
+/**
+ * @brief Compression ratio and writer cost of compressed telemetry logs
+ *
+ * Ten minutes of synthetic capture at the car's message rates, each signal
+ * a slow random walk with sensor noise and each host timestamp (MonotonicClock
+ * ns) up to 200 us of receive jitter after its send time, is cut into blocks
+ * of blockRecords records and compressed. qCompress compresses the records as
+ * they are; blockCodec is LogBlockCodec (per-ID delta, byte shuffle, then
+ * qCompress). A block of 4096 records is what a busy bus fills; at these
+ * rates a 200 ms flush writes blocks of about 72 records, so 64 and 256
+ * show what short flush delays cost. Every block is decoded again and
+ * checked.
+ *
+ * Results are encode ns per record, best of RUNS; the ratio (raw bytes over
+ * compressed bytes, block headers included) is printed for each row.
+ */
+class LogCompressBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void compress_data();
+    void compress();
+
+private:
+    std::vector<TelemetryLog::Record> m_records;
+};
+
+enum Method { PlainQCompress, BlockCodec };
+
+static const int SESSION_SECONDS = 600;
+static const int RUNS = 3;
+
+// Messages per second on the car
+static const struct {
+    uint32_t id;
+    int rateHz;
+} MESSAGE_RATES[] = {
+    {CANDecoder::CAN_ID_IMU_ANGLE, 100},
+    {CANDecoder::CAN_ID_IMU_ACCEL, 100},
+    {CANDecoder::CAN_ID_ADC, 100},
+    {CANDecoder::CAN_ID_PROXIMITY_ENCODER, 50},
+    {CANDecoder::CAN_ID_GPS, 10},
+    {CANDecoder::CAN_ID_TEMPERATURES, 1},
+};
+
+void LogCompressBench::initTestCase()
+{
+    QRandomGenerator rng(0x5eed);
+    qint16 signal[std::size(MESSAGE_RATES)][4] = {};
+
+    // Millisecond ticks; each message is sent when its period comes round
+    for (int ms = 0; ms < SESSION_SECONDS * 1000; ++ms) {
+        for (size_t m = 0; m < std::size(MESSAGE_RATES); ++m) {
+            if (ms % (1000 / MESSAGE_RATES[m].rateHz) != 0) {
+                continue;
+            }
+            for (qint16 &channel : signal[m]) {
+                channel = qint16(channel + rng.bounded(-8, 9));
+            }
+
+            TelemetryLog::Record record = {};
+            record.timestamp = qint64(ms) * 1000000 + rng.bounded(200000);
+            record.canId = MESSAGE_RATES[m].id;
+            record.dlc = 8;
+            std::memcpy(record.payload, signal[m], sizeof(record.payload));
+            record.deviceTimestamp = quint32(ms);
+            m_records.push_back(record);
+        }
+    }
+}
+
+void LogCompressBench::compress_data()
+{
+    QTest::addColumn<int>("method");
+    QTest::addColumn<int>("level");
+    QTest::addColumn<int>("blockRecords");
+
+    for (int method : {PlainQCompress, BlockCodec}) {
+        for (int level : {1, 6}) {
+            for (int blockRecords : {64, 256, LogBlockCodec::RECORDS_PER_BLOCK}) {
+                QTest::newRow(qPrintable(QString("%1 level %2, %3 records")
+                                             .arg(method == BlockCodec ? "blockCodec" : "qCompress")
+                                             .arg(level)
+                                             .arg(blockRecords)))
+                    << method << level << blockRecords;
+            }
+        }
+    }
+}
+
+void LogCompressBench::compress()
+{
+    QFETCH(int, method);
+    QFETCH(int, level);
+    QFETCH(int, blockRecords);
+
+    const qsizetype total = qsizetype(m_records.size());
+    LogBlockCodec codec(level);
+    std::vector<TelemetryLog::Record> decoded(blockRecords);
+
+    qint64 bestNs = std::numeric_limits<qint64>::max();
+    qint64 compressedBytes = 0;
+    for (int r = 0; r < RUNS; ++r) {
+        compressedBytes = 0;
+        qint64 spentNs = 0;
+        QElapsedTimer timer;
+        for (qsizetype first = 0; first < total; first += blockRecords) {
+            const qsizetype count = qMin<qsizetype>(blockRecords, total - first);
+            const TelemetryLog::Record *records = m_records.data() + first;
+            LogBlockCodec::BlockHeader header;
+
+            timer.start();
+            const QByteArray data = method == BlockCodec
+                ? codec.encode(records, count, header)
+                : qCompress(reinterpret_cast<const uchar *>(records),
+                            count * qsizetype(sizeof(TelemetryLog::Record)), level);
+            spentNs += timer.nsecsElapsed();
+            compressedBytes += qint64(sizeof(header)) + data.size();
+
+            if (r == 0) {
+                if (method == BlockCodec) {
+                    QVERIFY(codec.decode(header, data.constData(), decoded.data()));
+                    QVERIFY(std::memcmp(decoded.data(), records, count * sizeof(TelemetryLog::Record)) == 0);
+                } else {
+                    QCOMPARE(qUncompress(data).size(), count * qsizetype(sizeof(TelemetryLog::Record)));
+                }
+            }
+        }
+        bestNs = qMin(bestNs, spentNs);
+    }
+
+    const qint64 rawBytes = total * qint64(sizeof(TelemetryLog::Record));
+    qInfo("%lld records, %lld -> %lld bytes, ratio %.2f", static_cast<long long>(total),
+          static_cast<long long>(rawBytes), static_cast<long long>(compressedBytes),
+          double(rawBytes) / compressedBytes);
+    QTest::setBenchmarkResult(double(bestNs) / total, QTest::WalltimeNanoseconds);
+}
+
+QTEST_GUILESS_MAIN(LogCompressBench)
+#include "tst_logcompressbench.moc"
@@ -0,0 +1,116 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QThread>
+#include <cstring>
+#include <limits>
+#include "../src/Controllers/can/include/candecoder.h"
+#include "../src/Controllers/logging/include/logexporter.h"
+#include "../src/Controllers/logging/include/logfilewriter.h"
+#include "../src/Controllers/logging/include/logsegmentindex.h"
+
+/**
+ * @brief Offline export cost per logged record
+ *
+ * A synthetic session of SEGMENTS segments with their indexes, RECORDS
+ * records in all, over the six decoded messages and one unknown ID, is
+ * exported as CSV (IMU angle and suspension only) and as a columnar file
+ * (every frame and signal) with 1 thread and with one per core. Results are
+ * ns per record, best of RUNS, files already in the page cache.
+ */
+class LogExportBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void exportSession_data();
+    void exportSession();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_session;
+};
+
+enum Format { Csv, Columnar };
+
+static const int SEGMENTS = 8;
+static const int RECORDS = 4000000;
+static const int RUNS = 3;
+
+static const uint32_t IDS[] = {
+    CANDecoder::CAN_ID_IMU_ANGLE, CANDecoder::CAN_ID_IMU_ACCEL, CANDecoder::CAN_ID_ADC,
+    CANDecoder::CAN_ID_PROXIMITY_ENCODER, CANDecoder::CAN_ID_GPS, CANDecoder::CAN_ID_TEMPERATURES,
+    0x7FF,
+};
+
+void LogExportBench::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_session = m_dir.filePath("session");
+    QVERIFY(QDir().mkpath(m_session));
+
+    QRandomGenerator rng(0x5eed);
+    const MonotonicClock::Anchor anchor = {1700000000000000000, 0};
+    qint64 timestamp = 0; // 4 kHz of frames, in MonotonicClock ns
+    for (int s = 0; s < SEGMENTS; ++s) {
+        const QString base = QString("%1/segment_%2").arg(m_session).arg(s, 4, 10, QChar('0'));
+        LogFileWriter writer;
+        QVERIFY2(writer.open(base + ".bin", 0), qPrintable(writer.errorString()));
+        const QByteArray header = TelemetryLog::header(anchor);
+        QVERIFY(writer.append(header.constData(), header.size()));
+
+        LogSegmentIndex index;
+        for (int i = 0; i < RECORDS / SEGMENTS; ++i) {
+            TelemetryLog::Record record = {};
+            record.timestamp = timestamp;
+            timestamp += 250000;
+            record.canId = IDS[rng.bounded(int(std::size(IDS)))];
+            record.dlc = 8;
+            const quint64 payload = rng.generate64();
+            std::memcpy(record.payload, &payload, sizeof(payload));
+            record.deviceTimestamp = quint32(record.timestamp / 1000000);
+            index.add(record, writer.size());
+            QVERIFY(writer.append(&record, sizeof(record)));
+        }
+        writer.close();
+        QVERIFY(index.save(base + ".idx"));
+    }
+}
+
+void LogExportBench::exportSession_data()
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("csv") << int(Csv) << 1;
+    QTest::newRow("columnar, 1 thread") << int(Columnar) << 1;
+    const int cores = QThread::idealThreadCount();
+    if (cores > 1) {
+        QTest::newRow(qPrintable(QString("columnar, %1 threads").arg(cores))) << int(Columnar) << cores;
+    }
+}
+
+void LogExportBench::exportSession()
+{
+    QFETCH(int, format);
+    QFETCH(int, threads);
+
+    const QString output = m_dir.filePath("export");
+    qint64 bestNs = std::numeric_limits<qint64>::max();
+    for (int r = 0; r < RUNS; ++r) {
+        QString error;
+        QElapsedTimer timer;
+        timer.start();
+        const bool ok = format == Csv
+            ? LogExporter::exportCsv(m_session, output, &error)
+            : LogExporter::exportColumnar(m_session, output + ".tcol", &error, threads);
+        bestNs = qMin(bestNs, timer.nsecsElapsed());
+        QVERIFY2(ok, qPrintable(error));
+    }
+    QTest::setBenchmarkResult(double(bestNs) / RECORDS, QTest::WalltimeNanoseconds);
+}
+
+QTEST_GUILESS_MAIN(LogExportBench)
+#include "tst_logexportbench.moc"
@@ -0,0 +1,197 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QThread>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../src/Controllers/logging/include/asynclogger.h"
+
+/**
+ * @brief Cost of handing a log record to the logger thread, per producer
+ *
+ * N producer threads each queue ENTRIES_PER_PRODUCER records while one
+ * consumer drains. ringPush uses AsyncLogger's LogRing; queuedSignal is the
+ * previous design, a queued Qt signal per record to a QObject on another
+ * thread. Results are ns per entry as seen by one producer (the wall time of
+ * the whole run divided by ENTRIES_PER_PRODUCER), best of RUNS.
+ */
+class LogRingBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void ringPush_data();
+    void ringPush();
+    void queuedSignal_data();
+    void queuedSignal();
+
+private:
+    static void addProducerRows();
+};
+
+static const int ENTRIES_PER_PRODUCER = 200000;
+static const int RUNS = 3;
+
+Q_DECLARE_METATYPE(TelemetryLog::Record)
+
+static TelemetryLog::Record makeRecord(int producer, int index)
+{
+    TelemetryLog::Record record = {};
+    record.timestamp = index;
+    record.canId = 0x071 + producer;
+    record.dlc = 8;
+    return record;
+}
+
+// Receives the queued signals on its own thread
+class SignalSink : public QObject
+{
+    Q_OBJECT
+
+public:
+    std::atomic<quint64> received{0};
+
+public slots:
+    void consume(const TelemetryLog::Record &record)
+    {
+        if (record.dlc == 8) {
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+class SignalSource : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void entryReady(const TelemetryLog::Record &record);
+};
+
+void LogRingBench::initTestCase()
+{
+    qRegisterMetaType<TelemetryLog::Record>("TelemetryLog::Record");
+}
+
+void LogRingBench::addProducerRows()
+{
+    QTest::addColumn<int>("producers");
+    for (int producers : {1, 2, 4, 8}) {
+        QTest::newRow(qPrintable(QString("%1 producers").arg(producers))) << producers;
+    }
+}
+
+void LogRingBench::ringPush_data()
+{
+    addProducerRows();
+}
+
+void LogRingBench::ringPush()
+{
+    QFETCH(int, producers);
+    const quint64 total = quint64(producers) * ENTRIES_PER_PRODUCER;
+
+    qint64 bestNs = std::numeric_limits<qint64>::max();
+    quint64 dropped = 0;
+    for (int r = 0; r < RUNS; ++r) {
+        auto ring = std::make_unique<LogRing>();
+        std::atomic<bool> go{false};
+        std::atomic<int> finished{0};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                while (!go.load(std::memory_order_acquire)) {
+                }
+                for (int i = 0; i < ENTRIES_PER_PRODUCER; ++i) {
+                    ring->push(makeRecord(p, i));
+                }
+                finished.fetch_add(1, std::memory_order_release);
+            });
+        }
+
+        // Drain on this thread the way LoggerWorker does, until every push landed
+        TelemetryLog::Record batch[512];
+        quint64 drained = 0;
+        QElapsedTimer timer;
+        timer.start();
+        go.store(true, std::memory_order_release);
+        qint64 producerNs = 0;
+        for (;;) {
+            const bool done = finished.load(std::memory_order_acquire) == producers;
+            if (done && producerNs == 0) {
+                producerNs = timer.nsecsElapsed();
+            }
+            const qsizetype count = ring->drain(batch, std::size(batch));
+            drained += count;
+            if (done && count == 0) {
+                break;
+            }
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        QCOMPARE(drained + ring->dropped(), total);
+        dropped = ring->dropped();
+        bestNs = qMin(bestNs, producerNs);
+    }
+    qInfo("%d producers: %llu of %llu entries dropped in the last run", producers,
+          static_cast<unsigned long long>(dropped), static_cast<unsigned long long>(total));
+    QTest::setBenchmarkResult(double(bestNs) / ENTRIES_PER_PRODUCER, QTest::WalltimeNanoseconds);
+}
+
+void LogRingBench::queuedSignal_data()
+{
+    addProducerRows();
+}
+
+void LogRingBench::queuedSignal()
+{
+    QFETCH(int, producers);
+    const quint64 total = quint64(producers) * ENTRIES_PER_PRODUCER;
+
+    qint64 bestNs = std::numeric_limits<qint64>::max();
+    for (int r = 0; r < RUNS; ++r) {
+        QThread consumerThread;
+        SignalSink sink;
+        sink.moveToThread(&consumerThread);
+        SignalSource source;
+        connect(&source, &SignalSource::entryReady, &sink, &SignalSink::consume, Qt::QueuedConnection);
+        consumerThread.start();
+
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                while (!go.load(std::memory_order_acquire)) {
+                }
+                for (int i = 0; i < ENTRIES_PER_PRODUCER; ++i) {
+                    emit source.entryReady(makeRecord(p, i));
+                }
+            });
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        go.store(true, std::memory_order_release);
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        bestNs = qMin(bestNs, timer.nsecsElapsed());
+
+        // Let the consumer catch up before the next run
+        while (sink.received.load(std::memory_order_relaxed) < total) {
+            QThread::msleep(1);
+        }
+        consumerThread.quit();
+        consumerThread.wait();
+    }
+    QTest::setBenchmarkResult(double(bestNs) / ENTRIES_PER_PRODUCER, QTest::WalltimeNanoseconds);
+}
+
+QTEST_GUILESS_MAIN(LogRingBench)
+#include "tst_logringbench.moc"
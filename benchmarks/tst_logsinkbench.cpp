@@ -0,0 +1,197 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <memory>
+#include <vector>
+#include "../src/Controllers/can/include/candecoder.h"
+#include "../src/Controllers/logging/include/logfilewriter.h"
+#include "../src/Controllers/logging/include/mappedlogwriter.h"
+#include "../src/Controllers/logging/include/telemetrylog.h"
+
+/**
+ * @brief Logger thread cost per record, by backend and record rate
+ *
+ * Each row runs for RUN_MS of real time and feeds the backend the way
+ * LoggerWorker does: one batch every DRAIN_INTERVAL_MS, a flush every
+ * FLUSH_INTERVAL_MS, close at the end. Only the backend calls are timed.
+ *
+ * - csvTextStream: the logger before binary logs, one formatted CSV line per
+ *   IMU record through QTextStream, flushed after every line
+ * - writev: LogFileWriter, the default backend
+ * - mmap: MappedLogWriter, stores into a preallocated mapping
+ *
+ * Results are ns per record, close included.
+ */
+class LogSinkBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void logging_data();
+    void logging();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+enum Backend { CsvTextStream, WriteV, Mapped };
+
+static const int RUN_MS = 2000;
+static const int DRAIN_INTERVAL_MS = 10;
+static const int FLUSH_INTERVAL_MS = 200;
+
+static TelemetryLog::Record makeRecord(qint64 index)
+{
+    TelemetryLog::Record record = {};
+    record.timestamp = index * 1000000;
+    record.canId = CANDecoder::CAN_ID_IMU_ANGLE;
+    record.dlc = 8;
+    for (int i = 0; i < 8; ++i) {
+        record.payload[i] = quint8(index + i);
+    }
+    return record;
+}
+
+// The pre-binary logger: decode, format, write a line and flush it
+class CsvBackend
+{
+public:
+    bool open(const QString &path)
+    {
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            return false;
+        }
+        m_stream.setDevice(&m_file);
+        m_stream << "timestamp,IMU_Ang_X,IMU_Ang_Y,IMU_Ang_Z" << "\n";
+        m_stream.flush();
+        return true;
+    }
+
+    void append(const TelemetryLog::Record &record)
+    {
+        const CANDecoder::IMUAngle angle = CANDecoder::decodeIMUAngle(
+            QByteArrayView(reinterpret_cast<const char *>(record.payload), record.dlc));
+        const QString data = QString("%1,%2,%3").arg(angle.ang_x).arg(angle.ang_y).arg(angle.ang_z);
+        m_stream << record.timestamp << "," << data << "\n";
+        m_stream.flush();
+    }
+
+    void close()
+    {
+        m_stream.flush();
+        m_file.close();
+    }
+
+private:
+    QFile m_file;
+    QTextStream m_stream;
+};
+
+void LogSinkBench::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void LogSinkBench::logging_data()
+{
+    QTest::addColumn<int>("backend");
+    QTest::addColumn<int>("rate");
+
+    const struct {
+        Backend backend;
+        const char *name;
+    } backends[] = {{CsvTextStream, "csvTextStream"}, {WriteV, "writev"}, {Mapped, "mmap"}};
+
+    for (const auto &backend : backends) {
+        if (backend.backend == Mapped && !MappedLogWriter::isSupported()) {
+            continue;
+        }
+        for (int rate : {1000, 10000, 100000}) {
+            QTest::newRow(qPrintable(QString("%1 %2 records/s").arg(backend.name).arg(rate)))
+                << int(backend.backend) << rate;
+        }
+    }
+}
+
+void LogSinkBench::logging()
+{
+    QFETCH(int, backend);
+    QFETCH(int, rate);
+
+    const int intervals = RUN_MS / DRAIN_INTERVAL_MS;
+    const int perInterval = rate * DRAIN_INTERVAL_MS / 1000;
+    const qint64 total = qint64(intervals) * perInterval;
+    const QString path = m_dir.filePath(QString("log_%1_%2.bin").arg(backend).arg(rate));
+
+    std::vector<TelemetryLog::Record> batch(perInterval);
+
+    CsvBackend csv;
+    std::unique_ptr<LogSink> sink;
+    if (backend == CsvTextStream) {
+        QVERIFY(csv.open(path));
+    } else {
+        if (backend == Mapped) {
+            sink = std::make_unique<MappedLogWriter>();
+        } else {
+            sink = std::make_unique<LogFileWriter>();
+        }
+        const QByteArray header = TelemetryLog::header(MonotonicClock::anchor());
+        QVERIFY2(sink->open(path, header.size() + total * qint64(sizeof(TelemetryLog::Record))),
+                 qPrintable(sink->errorString()));
+        sink->trackCommittedLength(TelemetryLog::committedLengthOffset());
+        QVERIFY(sink->append(header.constData(), header.size()));
+    }
+
+    QElapsedTimer clock;
+    QElapsedTimer timer;
+    qint64 spentNs = 0;
+    qint64 index = 0;
+    clock.start();
+    for (int interval = 0; interval < intervals; ++interval) {
+        while (clock.elapsed() < qint64(interval) * DRAIN_INTERVAL_MS) {
+            QThread::usleep(200);
+        }
+        for (TelemetryLog::Record &record : batch) {
+            record = makeRecord(index++);
+        }
+
+        timer.start();
+        if (backend == CsvTextStream) {
+            for (const TelemetryLog::Record &record : batch) {
+                csv.append(record);
+            }
+        } else {
+            QVERIFY(sink->append(batch.data(), qsizetype(batch.size() * sizeof(TelemetryLog::Record))));
+            if ((interval + 1) % (FLUSH_INTERVAL_MS / DRAIN_INTERVAL_MS) == 0) {
+                QVERIFY(sink->flush());
+            }
+        }
+        spentNs += timer.nsecsElapsed();
+    }
+
+    timer.start();
+    if (backend == CsvTextStream) {
+        csv.close();
+    } else {
+        sink->close();
+    }
+    spentNs += timer.nsecsElapsed();
+
+    if (backend != CsvTextStream) {
+        TelemetryLogReader reader;
+        QString error;
+        QVERIFY2(reader.open(path, &error), qPrintable(error));
+        QCOMPARE(reader.recordCount(), total);
+    }
+    QFile::remove(path);
+
+    QTest::setBenchmarkResult(double(spentNs) / total, QTest::WalltimeNanoseconds);
+}
+
+QTEST_GUILESS_MAIN(LogSinkBench)
+#include "tst_logsinkbench.moc"
@@ -0,0 +1,226 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include "../src/Controllers/can/include/candecoder.h"
+#include "../src/Controllers/logging/include/asynclogger.h"
+#include "../src/Controllers/mqtt/include/mqttparserworker.h"
+#include "../src/Controllers/serial/include/serialparserworker.h"
+#include "../src/Controllers/udp/include/udpparserworker.h"
+
+/**
+ * @brief Heap allocations per frame on the parser worker hot path
+ *
+ * Every allocation in the process is counted, on every thread. Each parser
+ * runs in a thread pool like in the app and is fed pre-built packets one at
+ * a time; after a warm-up, parsing must not allocate at all. Every frame is
+ * also captured by AsyncLogger, so its ring and writer thread are held to
+ * the same rule. Every tenth frame carries an unregistered ID, so the error
+ * path is too.
+ */
+class ParserAllocBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void udpParser();
+    void serialParser();
+    void mqttParser();
+    void cleanupTestCase();
+
+private:
+    // handled() counts frames parsed or rejected as unknown
+    template <typename Worker, typename Enqueue, typename Handled>
+    void countAllocations(Worker *worker, Enqueue &&enqueue, Handled &&handled);
+
+    QTemporaryDir m_logDir;
+    QList<QByteArray> m_packets;
+};
+
+static std::atomic<quint64> s_allocations{0};
+
+// glibc lets the executable interpose malloc, which also catches QByteArray
+// and other Qt containers that bypass operator new. Elsewhere only operator
+// new is counted
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+void *operator new(std::size_t size)
+{
+#if !defined(__GLIBC__)
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+static const uint32_t UNKNOWN_ID = 0x7FF;
+static const int UNKNOWN_EVERY = 10;
+static const int WARMUP_FRAMES = 1000;
+static const int FRAME_COUNT = 100000;
+static const qint64 FRAME_TIMEOUT_NS = 5000000000LL;
+
+void ParserAllocBench::initTestCase()
+{
+    // Not 0x071: IMU angle frames are only logged, so they never count as parsed
+    static const uint32_t ids[] = {
+        CANDecoder::CAN_ID_IMU_ACCEL,
+        CANDecoder::CAN_ID_ADC,
+        CANDecoder::CAN_ID_PROXIMITY_ENCODER,
+        CANDecoder::CAN_ID_GPS,
+        CANDecoder::CAN_ID_TEMPERATURES
+    };
+
+    QVERIFY(m_logDir.isValid());
+    AsyncLogger::instance().initialize(m_logDir.path());
+    QVERIFY(AsyncLogger::instance().waitUntilReady());
+
+    m_packets.reserve(FRAME_COUNT);
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        QByteArray packet(CANDecoder::PACKET_SIZE, '\0');
+        const uint32_t timestamp = static_cast<uint32_t>(i + 1); // Unique, so the deduplicator keeps every frame
+        const uint32_t canId = i % UNKNOWN_EVERY == UNKNOWN_EVERY - 1 ? UNKNOWN_ID : ids[i % std::size(ids)];
+        const uint64_t payload = 0x0123456789abcdefULL * (i + 1);
+        std::memcpy(packet.data(), &timestamp, sizeof(timestamp));
+        std::memcpy(packet.data() + 4, &canId, sizeof(canId));
+        packet[8] = 8;
+        std::memcpy(packet.data() + 9, &payload, sizeof(payload));
+        m_packets.append(packet);
+    }
+}
+
+template <typename Worker, typename Enqueue, typename Handled>
+void ParserAllocBench::countAllocations(Worker *worker, Enqueue &&enqueue, Handled &&handled)
+{
+    QThreadPool pool;
+    worker->setAutoDelete(false); // Deleted below, once its run() has returned
+    pool.start(worker);
+
+    // Feed one frame at a time and wait for it, so none is dropped by the
+    // queue and nothing but the parser runs while allocations are counted
+    bool timedOut = false;
+    quint64 allocationsBefore = 0;
+    for (int i = 0; i < FRAME_COUNT && !timedOut; ++i) {
+        if (i == WARMUP_FRAMES) {
+            allocationsBefore = s_allocations.load();
+        }
+        enqueue(m_packets.at(i));
+
+        QElapsedTimer timer;
+        timer.start();
+        while (handled() < quint64(i + 1)) {
+            if (timer.nsecsElapsed() > FRAME_TIMEOUT_NS) {
+                timedOut = true;
+                break;
+            }
+            QThread::yieldCurrentThread();
+        }
+    }
+    const quint64 allocations = s_allocations.load() - allocationsBefore;
+
+    worker->stop();
+    pool.waitForDone();
+    delete worker;
+
+    QVERIFY2(!timedOut, "Parser stopped consuming frames");
+    qInfo("%llu allocations in %d steady-state frames", allocations, FRAME_COUNT - WARMUP_FRAMES);
+    QCOMPARE(allocations, quint64(0));
+}
+
+void ParserAllocBench::udpParser()
+{
+    TelemetryState state(1);
+    FrameDeduplicator deduplicator;
+    FrameErrorCounters errors;
+    UdpParserWorker *worker = new UdpParserWorker(&state, &deduplicator, &errors, 0);
+    countAllocations(worker,
+                     [worker](const QByteArray &packet) { worker->queueDatagram(packet); },
+                     [worker, &errors] { return worker->datagramsParsed() + errors.total(FrameErrorCounters::UnknownId); });
+}
+
+void ParserAllocBench::serialParser()
+{
+    TelemetryState state(1);
+    FrameDeduplicator deduplicator;
+    FrameErrorCounters errors;
+    SerialParserWorker *worker = new SerialParserWorker(&state, &deduplicator, &errors, 0);
+    countAllocations(worker,
+                     [worker](const QByteArray &packet) { worker->queueData(packet); },
+                     [worker, &errors] { return worker->packetsParsed() + errors.total(FrameErrorCounters::UnknownId); });
+}
+
+void ParserAllocBench::mqttParser()
+{
+    TelemetryState state(1);
+    FrameDeduplicator deduplicator;
+    FrameErrorCounters errors;
+    MqttParserWorker *worker = new MqttParserWorker(&state, &deduplicator, &errors, 0);
+    countAllocations(worker,
+                     [worker](const QByteArray &packet) { worker->queueMessage(packet); },
+                     [worker, &errors] { return worker->messagesParsed() + errors.total(FrameErrorCounters::UnknownId); });
+}
+
+void ParserAllocBench::cleanupTestCase()
+{
+    AsyncLogger::instance().shutdown();
+}
+
+QTEST_GUILESS_MAIN(ParserAllocBench)
+#include "tst_parserallocbench.moc"
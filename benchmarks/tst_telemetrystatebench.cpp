@@ -0,0 +1,134 @@
+#include <QtTest>
+#include <QMutex>
+#include <QThread>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../src/Controllers/telemetry/include/telemetrystate.h"
+
+/**
+ * @brief Contention benchmark for the shared telemetry state
+ *
+ * Scales parser threads from 1 to idealThreadCount() while one reader thread
+ * keeps taking snapshots, the way the GUI flush does. The seqlock state is
+ * compared against the previous design: one mutex-protected snapshot shared
+ * by every parser.
+ */
+class TelemetryStateBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void seqlock_data();
+    void seqlock();
+    void mutexBaseline_data();
+    void mutexBaseline();
+
+private:
+    static void addWriterRows();
+};
+
+static const int UPDATES_PER_WRITER = 200000;
+
+// Writes one ProximityEncoder frame worth of values, like the 0x074 decode
+static void fillProximity(TelemetrySnapshot &s, int i)
+{
+    s.speed = static_cast<float>(i % 120);
+    s.speedFL = i;
+    s.speedFR = i + 1;
+    s.speedBL = i + 2;
+    s.speedBR = i + 3;
+    s.encoderAngle = i * 0.25;
+}
+
+template <typename WriteFn, typename ReadFn>
+static void runContended(int writers, WriteFn &&write, ReadFn &&read)
+{
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            read();
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&write] { write(); });
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+
+    done.store(true, std::memory_order_relaxed);
+    reader.join();
+}
+
+void TelemetryStateBench::addWriterRows()
+{
+    QTest::addColumn<int>("writers");
+    const int maxWriters = qMax(1, QThread::idealThreadCount());
+    for (int writers = 1; writers <= maxWriters; writers *= 2) {
+        QTest::newRow(qPrintable(QString("%1 writers").arg(writers))) << writers;
+    }
+    if ((maxWriters & (maxWriters - 1)) != 0) {
+        QTest::newRow(qPrintable(QString("%1 writers").arg(maxWriters))) << maxWriters;
+    }
+}
+
+void TelemetryStateBench::seqlock_data()
+{
+    addWriterRows();
+}
+
+void TelemetryStateBench::seqlock()
+{
+    QFETCH(int, writers);
+
+    TelemetryState state(writers);
+    TelemetrySnapshot snapshot;
+
+    QBENCHMARK {
+        runContended(writers,
+            [&state] {
+                TelemetryState::Writer *writer = state.acquireWriter();
+                for (int i = 0; i < UPDATES_PER_WRITER; ++i) {
+                    writer->update(TelemetryState::ProximityEncoder, [i](TelemetrySnapshot &s) {
+                        fillProximity(s, i);
+                    });
+                }
+                state.releaseWriter(writer);
+            },
+            [&state, &snapshot] { state.takeSnapshot(snapshot); });
+    }
+}
+
+void TelemetryStateBench::mutexBaseline_data()
+{
+    addWriterRows();
+}
+
+void TelemetryStateBench::mutexBaseline()
+{
+    QFETCH(int, writers);
+
+    QMutex mutex;
+    TelemetrySnapshot shared;
+    TelemetrySnapshot snapshot;
+
+    QBENCHMARK {
+        runContended(writers,
+            [&mutex, &shared] {
+                for (int i = 0; i < UPDATES_PER_WRITER; ++i) {
+                    QMutexLocker locker(&mutex);
+                    fillProximity(shared, i);
+                }
+            },
+            [&mutex, &shared, &snapshot] {
+                QMutexLocker locker(&mutex);
+                snapshot = shared;
+            });
+    }
+}
+
+QTEST_GUILESS_MAIN(TelemetryStateBench)
+#include "tst_telemetrystatebench.moc"
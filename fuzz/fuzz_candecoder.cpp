@@ -0,0 +1,148 @@
+#include <QByteArray>
+#include <QByteArrayView>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "../src/Controllers/can/include/canbatchdecoder.h"
+#include "../src/Controllers/can/include/candecoder.h"
+
+/*
+ * libFuzzer target for every CANDecoder entry point, plus CANDecoder's batch
+ * counterpart. The input is used three ways: as one record, as a stream of
+ * records walked with recordSize() like a capture file, and as a run of
+ * 20-byte packets for CANBatchDecoder. Besides the sanitizers, a broken
+ * invariant aborts, so libFuzzer keeps the input as a crash.
+ */
+
+namespace {
+
+#define FUZZ_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::abort(); \
+        } \
+    } while (false)
+
+volatile uint64_t g_sink; // Keeps the decoded values alive
+
+template <typename T>
+void consume(const T &value)
+{
+    uint64_t word = 0;
+    std::memcpy(&word, &value, sizeof(value) < sizeof(word) ? sizeof(value) : sizeof(word));
+    g_sink = g_sink + word;
+}
+
+void decodeAll(QByteArrayView payload)
+{
+    const QByteArray copy = payload.toByteArray();
+
+    consume(CANDecoder::decodeIMUAngle(payload));
+    consume(CANDecoder::decodeIMUAngle(copy));
+    consume(CANDecoder::decodeIMUAccel(payload).accel_z);
+    consume(CANDecoder::decodeIMUAccel(copy).accel_z);
+    consume(CANDecoder::decodeADC(payload));
+    consume(CANDecoder::decodeADC(copy));
+    consume(CANDecoder::decodeProximityAndEncoder(payload).encoder_angle);
+    consume(CANDecoder::decodeProximityAndEncoder(copy).encoder_angle);
+    consume(CANDecoder::decodeGPS(payload));
+    consume(CANDecoder::decodeGPS(copy));
+    consume(CANDecoder::decodeTemperatures(payload));
+    consume(CANDecoder::decodeTemperatures(copy));
+}
+
+void checkRecord(QByteArrayView record)
+{
+    const QByteArray copy = record.toByteArray();
+
+    // Both overloads of the packet accessors agree
+    FUZZ_CHECK(CANDecoder::extractCANId(record) == CANDecoder::extractCANId(copy));
+    FUZZ_CHECK(CANDecoder::extractTimestamp(record) == CANDecoder::extractTimestamp(copy));
+    const QByteArrayView payload = CANDecoder::payloadView(record);
+    const QByteArray payloadCopy = CANDecoder::extractPayload(copy);
+    FUZZ_CHECK(payload.size() == payloadCopy.size());
+    FUZZ_CHECK(payload.isEmpty() || std::memcmp(payload.data(), payloadCopy.constData(), payload.size()) == 0);
+    decodeAll(payload);
+
+    const int size = CANDecoder::recordSize(record);
+    FUZZ_CHECK(size == -1 || (size >= CANDecoder::HEADER_SIZE && size <= CANDecoder::MAX_RECORD_SIZE && size % 4 == 0));
+
+    CANDecoder::Frame frame;
+    if (!CANDecoder::parseFrame(record, frame)) {
+        return;
+    }
+
+    // An accepted record is exactly one frame, and its payload lies inside it
+    FUZZ_CHECK(size == record.size());
+    FUZZ_CHECK(frame.payload.size() == CANDecoder::dataLength(frame.dlc, frame.fd));
+    FUZZ_CHECK(frame.payload.data() == record.data() + CANDecoder::HEADER_SIZE);
+    FUZZ_CHECK(frame.payload.size() <= (frame.fd ? CANDecoder::MAX_FD_PAYLOAD : 8));
+    FUZZ_CHECK((frame.id & CANDecoder::CAN_FD_FLAG) == 0);
+    FUZZ_CHECK(frame.isExtended() ? (frame.id & ~(CANDecoder::CAN_EFF_FLAG | CANDecoder::CAN_EFF_MASK)) == 0
+                                  : frame.id <= CANDecoder::CAN_SFF_MASK);
+    FUZZ_CHECK(frame.timestamp == CANDecoder::extractTimestamp(record));
+    decodeAll(frame.payload);
+}
+
+void checkBatch(QByteArrayView packets)
+{
+    CANBatchDecoder::Columns columns;
+    const qsizetype count = CANBatchDecoder::decode(packets, columns);
+    FUZZ_CHECK(count == packets.size() / CANDecoder::PACKET_SIZE);
+
+    const qsizetype decoded = qsizetype(columns.imuAngle.timestamp.size() + columns.imuAccel.timestamp.size()
+                                        + columns.adc.timestamp.size() + columns.proximityEncoder.timestamp.size()
+                                        + columns.gps.timestamp.size() + columns.temperatures.timestamp.size());
+    FUZZ_CHECK(decoded + columns.unknownFrames == count);
+
+    // The unpack kernels match the scalar decoder on the integer signals
+    std::size_t adc = 0;
+    std::size_t temperatures = 0;
+    for (qsizetype i = 0; i < count; ++i) {
+        const QByteArrayView packet = packets.sliced(i * CANDecoder::PACKET_SIZE, CANDecoder::PACKET_SIZE);
+        const uint32_t canId = CANDecoder::extractCANId(packet);
+        if (canId == CANDecoder::CAN_ID_ADC) {
+            const CANDecoder::ADCData expected = CANDecoder::decodeADC(CANDecoder::payloadView(packet));
+            FUZZ_CHECK(columns.adc.sus_1[adc] == expected.sus_1 && columns.adc.sus_2[adc] == expected.sus_2
+                       && columns.adc.sus_3[adc] == expected.sus_3 && columns.adc.sus_4[adc] == expected.sus_4
+                       && columns.adc.brake_pedal[adc] == expected.brake_pedal
+                       && columns.adc.acc_pedal[adc] == expected.acc_pedal);
+            ++adc;
+        } else if (canId == CANDecoder::CAN_ID_TEMPERATURES) {
+            const CANDecoder::Temperatures expected = CANDecoder::decodeTemperatures(CANDecoder::payloadView(packet));
+            FUZZ_CHECK(columns.temperatures.temp_fl[temperatures] == expected.temp_fl
+                       && columns.temperatures.temp_fr[temperatures] == expected.temp_fr
+                       && columns.temperatures.temp_rl[temperatures] == expected.temp_rl
+                       && columns.temperatures.temp_rr[temperatures] == expected.temp_rr);
+            ++temperatures;
+        }
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    const QByteArrayView input(data, qsizetype(size));
+
+    if (size >= 2) {
+        const int length = CANDecoder::dataLength(data[0], data[1] & 1);
+        FUZZ_CHECK(data[0] > 15 ? length == -1 : length >= 0 && length <= CANDecoder::MAX_FD_PAYLOAD);
+    }
+
+    checkRecord(input);
+
+    // Walk the input as a capture of back-to-back records
+    for (QByteArrayView rest = input; !rest.isEmpty();) {
+        const int size = CANDecoder::recordSize(rest);
+        if (size < 0 || size > rest.size()) {
+            break;
+        }
+        checkRecord(rest.first(size));
+        rest = rest.sliced(size);
+    }
+
+    checkBatch(input);
+    return 0;
+}
@@ -1,20 +1,169 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QQuickWindow>
 #include <QThread>
+#include <QTimer>
+#include <csignal>
 #include <src/Controllers/communication_manager/include/communicationmanager.h>
+#include <src/Controllers/headless/include/headlessrecorder.h>
 #include <src/Controllers/logging/include/asynclogger.h>
+#include <src/Controllers/logging/include/logexporter.h>
 #include <src/Controllers/mqtt/include/mqttclient.h>
 #include <src/Controllers/serial/include/serialmanager.h>
+#include <src/Controllers/telemetry/include/framepublisher.h>
 #include <src/Controllers/udp/include/udpclient.h>
 
-int main(int argc, char *argv[]) {
-  QGuiApplication app(argc, argv);
-
+static void setApplicationInfo() {
   // Set application information for QSettings
   QCoreApplication::setOrganizationName("ASURT");
   QCoreApplication::setOrganizationDomain("asurt.eu");
   QCoreApplication::setApplicationName("Car_Dashboard");
+}
+
+// Set by the SIGINT/SIGTERM handler: a flag is all a handler may safely touch
+static volatile std::sig_atomic_t stopRequested = 0;
+
+// Checked before any application object exists, to pick the application type
+static bool hasFlag(int argc, char *argv[], const char *flag) {
+  for (int i = 1; i < argc; ++i) {
+    if (qstrcmp(argv[i], flag) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Offline conversion of a binary telemetry log; no transports or logger
+static int runExport(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  setApplicationInfo();
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Converts a binary telemetry log.");
+  parser.addHelpOption();
+  QCommandLineOption csvOption("export-csv", "Export the log <file> or session directory as CSV.",
+                               "file");
+  QCommandLineOption columnarOption("export-columnar",
+                                    "Export the log <file> or session directory as telemetry.tcol, "
+                                    "one typed column per signal.",
+                                    "file");
+  QCommandLineOption outputOption("output", "Write the export to <dir>.", "dir",
+                                  ".");
+  parser.addOptions({csvOption, columnarOption, outputOption});
+  parser.process(app);
+
+  QString error;
+  if (parser.isSet(csvOption) &&
+      !LogExporter::exportCsv(parser.value(csvOption),
+                              parser.value(outputOption), &error)) {
+    qCritical().noquote() << "Export failed:" << error;
+    return 1;
+  }
+  if (parser.isSet(columnarOption)) {
+    const QDir outputDir(parser.value(outputOption));
+    if (!outputDir.exists() && !outputDir.mkpath(".")) {
+      qCritical().noquote() << "Export failed: cannot create" << outputDir.path();
+      return 1;
+    }
+    if (!LogExporter::exportColumnar(parser.value(columnarOption),
+                                     outputDir.filePath("telemetry.tcol"), &error)) {
+      qCritical().noquote() << "Export failed:" << error;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Ingest and logging only: no QGuiApplication, QML engine or window
+static int runHeadless(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  setApplicationInfo();
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Records telemetry without the dashboard.");
+  parser.addHelpOption();
+  QCommandLineOption headlessOption("headless", "Run without GUI.");
+  QCommandLineOption udpOption("udp", "Listen for UDP telemetry on <port>.",
+                               "port");
+  QCommandLineOption serialOption("serial", "Read telemetry from serial <port>.",
+                                  "port");
+  QCommandLineOption baudOption("baud", "Serial baud rate.", "rate", "115200");
+  QCommandLineOption statsOption(
+      "stats-interval", "Print a stats line every <ms> (0 = never).", "ms",
+      "1000");
+  QCommandLineOption debugOption("debug", "Enable transport debug output.");
+  parser.addOptions({headlessOption, udpOption, serialOption, baudOption,
+                     statsOption, debugOption});
+  parser.process(app);
+
+  HeadlessRecorder::Options options;
+  bool ok = true;
+  if (parser.isSet(udpOption)) {
+    options.udpPort = parser.value(udpOption).toUShort(&ok);
+    if (!ok || options.udpPort == 0) {
+      qCritical().noquote() << "Invalid UDP port:" << parser.value(udpOption);
+      return 1;
+    }
+  }
+  options.serialPort = parser.value(serialOption);
+  options.baudRate = parser.value(baudOption).toInt(&ok);
+  if (!ok || options.baudRate <= 0) {
+    qCritical().noquote() << "Invalid baud rate:" << parser.value(baudOption);
+    return 1;
+  }
+  options.statsIntervalMs = parser.value(statsOption).toInt(&ok);
+  if (!ok || options.statsIntervalMs < 0) {
+    qCritical().noquote() << "Invalid stats interval:"
+                          << parser.value(statsOption);
+    return 1;
+  }
+  options.debugMode = parser.isSet(debugOption);
+
+  if (options.udpPort == 0 && options.serialPort.isEmpty()) {
+    qCritical() << "Headless mode needs --udp <port> and/or --serial <port>";
+    return 1;
+  }
+
+  // Leave the event loop on Ctrl+C / SIGTERM so the logger is shut down
+  // cleanly. Qt is not async-signal-safe, so the handler only sets a flag
+  // and the event loop polls it
+  std::signal(SIGINT, [](int) { stopRequested = 1; });
+  std::signal(SIGTERM, [](int) { stopRequested = 1; });
+  QTimer stopPoll;
+  QObject::connect(&stopPoll, &QTimer::timeout, &app, [] {
+    if (stopRequested) {
+      QCoreApplication::quit();
+    }
+  });
+  stopPoll.start(100);
+
+  int result = 1;
+  {
+    HeadlessRecorder recorder(options);
+    if (recorder.start()) {
+      result = app.exec();
+    }
+  }
+
+  AsyncLogger::instance().shutdown();
+  return result;
+}
+
+int main(int argc, char *argv[]) {
+  if (hasFlag(argc, argv, "--export-csv") ||
+      hasFlag(argc, argv, "--export-columnar")) {
+    return runExport(argc, argv);
+  }
+  if (hasFlag(argc, argv, "--headless")) {
+    return runHeadless(argc, argv);
+  }
+
+  QGuiApplication app(argc, argv);
+  setApplicationInfo();
 
   QQmlApplicationEngine engine;
   UdpClient udpClient;
@@ -28,15 +177,28 @@ int main(int argc, char *argv[]) {
   engine.rootContext()->setContextProperty("udpClient", &udpClient);
   engine.rootContext()->setContextProperty("serialManager", &serialManager);
   engine.rootContext()->setContextProperty("mqttClient", &mqttClient);
+  engine.rootContext()->setContextProperty("framePublisher",
+                                           &FramePublisher::instance());
 
   QObject::connect(
       &engine, &QQmlApplicationEngine::objectCreationFailed, &app,
       []() { QCoreApplication::exit(-1); }, Qt::QueuedConnection);
   engine.loadFromModule("GUI", "Main");
 
+  // Publish telemetry in step with the main window's frames
+  if (!engine.rootObjects().isEmpty()) {
+    FramePublisher::instance().setWindow(
+        qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst()));
+  }
+
   int result = app.exec();
 
-  // Ensure proper cleanup before exit
+  // Ensure proper cleanup before exit: no frame may reach the logger after
+  // it has shut down
+  communicationManager.stop();
+  udpClient.stop();
+  serialManager.stop();
+  mqttClient.stop();
   AsyncLogger::instance().shutdown();
 
   return result;
@@ -38,14 +38,16 @@ COMM_CAN_ID_TEMP         = 0x076
 def create_can_packet(can_id, data_bytes):
     """
     Creates a 20-byte binary packet compatible with the dashboard's unpack logic.
-    Format: Padding(4) + ID(4) + DLC(1) + Data(8) + Padding(3)
+    Format: Timestamp(4) + ID(4) + DLC(1) + Data(8) + Padding(3)
+    The timestamp (ms, little endian) lets the dashboard drop copies of a
+    frame received over more than one link.
     """
     if len(data_bytes) < 8:
         data_bytes += b'\x00' * (8 - len(data_bytes))
     elif len(data_bytes) > 8:
         data_bytes = data_bytes[:8]
 
-    header = b'\x00\x00\x00\x00'
+    header = struct.pack("<L", max(1, int(time.monotonic() * 1000) & 0xFFFFFFFF))
     packet_id = struct.pack("<L", can_id)
     dlc = struct.pack("B", 8)
     
@@ -0,0 +1,108 @@
+#ifndef CANBATCHDECODER_H
+#define CANBATCHDECODER_H
+
+#include <QByteArrayView>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Decodes many 20-byte CAN packets at once into struct-of-arrays columns
+ *
+ * Meant for log import, replay and batched ingest. The input is a contiguous
+ * run of classic 20-byte packets in the CANDecoder layout; CAN FD records
+ * are not supported. Frames are first grouped by CAN ID
+ * (a counting sort of frame indices), then each group is decoded in one loop
+ * that writes every signal into its own contiguous column, next to a column
+ * of device timestamps. Values and units match CANDecoder.
+ */
+class CANBatchDecoder
+{
+public:
+    struct IMUAngleColumns {
+        std::vector<uint32_t> timestamp; // Device time, ms
+        std::vector<int16_t> ang_x;
+        std::vector<int16_t> ang_y;
+        std::vector<int16_t> ang_z;
+    };
+
+    struct IMUAccelColumns {
+        std::vector<uint32_t> timestamp;
+        std::vector<double> lateral_g;
+        std::vector<double> longitudinal_g;
+        std::vector<int16_t> accel_z;
+    };
+
+    struct ADCColumns {
+        std::vector<uint32_t> timestamp;
+        std::vector<uint16_t> sus_1;
+        std::vector<uint16_t> sus_2;
+        std::vector<uint16_t> sus_3;
+        std::vector<uint16_t> sus_4;
+        std::vector<uint16_t> brake_pedal;
+        std::vector<uint16_t> acc_pedal;
+    };
+
+    struct ProximityEncoderColumns {
+        std::vector<uint32_t> timestamp;
+        std::vector<double> speed_fl; // km/h
+        std::vector<double> speed_fr;
+        std::vector<double> speed_bl;
+        std::vector<double> speed_br;
+        std::vector<uint16_t> encoder_angle;
+        std::vector<uint8_t> speed_kmh;
+    };
+
+    struct GPSColumns {
+        std::vector<uint32_t> timestamp;
+        std::vector<float> longitude;
+        std::vector<float> latitude;
+    };
+
+    struct TemperatureColumns {
+        std::vector<uint32_t> timestamp;
+        std::vector<int16_t> temp_fl;
+        std::vector<int16_t> temp_fr;
+        std::vector<int16_t> temp_rl;
+        std::vector<int16_t> temp_rr;
+    };
+
+    struct Columns {
+        IMUAngleColumns imuAngle;
+        IMUAccelColumns imuAccel;
+        ADCColumns adc;
+        ProximityEncoderColumns proximityEncoder;
+        GPSColumns gps;
+        TemperatureColumns temperatures;
+        qsizetype unknownFrames = 0; // Frames with a CAN ID not listed above
+    };
+
+    /**
+     * @brief Decode every whole packet in @p packets, replacing the contents of @p out
+     *
+     * Within each message the columns keep the input order. Trailing bytes
+     * that do not form a whole packet are ignored.
+     * @return Number of packets read
+     */
+    static qsizetype decode(QByteArrayView packets, Columns &out);
+
+private:
+    enum MessageKind : uint8_t {
+        IMUAngle,
+        IMUAccel,
+        ADC,
+        ProximityEncoder,
+        GPS,
+        Temperatures,
+        Unknown,
+        KindCount
+    };
+
+    static void decodeIMUAngle(const uchar *data, const uint32_t *frames, qsizetype count, IMUAngleColumns &out);
+    static void decodeIMUAccel(const uchar *data, const uint32_t *frames, qsizetype count, IMUAccelColumns &out);
+    static void decodeADC(const uchar *data, const uint32_t *frames, qsizetype count, ADCColumns &out);
+    static void decodeProximityEncoder(const uchar *data, const uint32_t *frames, qsizetype count, ProximityEncoderColumns &out);
+    static void decodeGPS(const uchar *data, const uint32_t *frames, qsizetype count, GPSColumns &out);
+    static void decodeTemperatures(const uchar *data, const uint32_t *frames, qsizetype count, TemperatureColumns &out);
+};
+
+#endif // CANBATCHDECODER_H
@@ -2,17 +2,24 @@
 #define CANDECODER_H
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <cstdint>
+#include "canlayout.h"
 
 /**
- * @brief CAN message decoder for 20-byte fixed packets
+ * @brief CAN message decoder for 20-byte fixed packets and CAN FD records
  * 
  * Packet structure:
- * - Bytes 0-3: Timestamp (skipped)
- * - Bytes 4-7: CAN ID (uint32_t, little endian)
- * - Byte 8: DLC (skipped)
- * - Bytes 9-16: Payload (8 bytes)
+ * - Bytes 0-3: Device timestamp (uint32_t ms, little endian, 0 = not stamped)
+ * - Bytes 4-7: CAN ID (uint32_t, little endian) and frame flags
+ * - Byte 8: DLC
+ * - Bytes 9-16: Payload (8 bytes, the first DLC of them valid)
  * - Bytes 17-19: Padding (ignored)
+ *
+ * The ID word carries the frame format in its top bits. CAN_EFF_FLAG marks a
+ * 29-bit extended ID. CAN_FD_FLAG marks a CAN FD record: the same 9-byte
+ * header followed by the DLC's FD data length (up to 64 bytes), padded to a
+ * multiple of 4 bytes. Classic frames always use the 20-byte record.
  */
 class CANDecoder
 {
@@ -30,6 +37,50 @@ public:
     static constexpr uint32_t CAN_ID_GPS = 0x075;
     static constexpr uint32_t CAN_ID_TEMPERATURES = 0x076;
     
+    // Frame flags and ID masks of the ID word
+    static constexpr uint32_t CAN_EFF_FLAG = 0x80000000; // 29-bit extended ID
+    static constexpr uint32_t CAN_FD_FLAG = 0x40000000;  // CAN FD record
+    static constexpr uint32_t CAN_SFF_MASK = 0x000007FF;
+    static constexpr uint32_t CAN_EFF_MASK = 0x1FFFFFFF;
+    
+    static constexpr int HEADER_SIZE = 9;
+    static constexpr int MAX_FD_PAYLOAD = 64;
+    static constexpr int MAX_RECORD_SIZE = 76; // FD record with 64 data bytes
+    
+    /**
+     * @brief One frame record, parsed in place
+     */
+    struct Frame {
+        uint32_t timestamp;     // Device time, ms
+        uint32_t id;            // 11-bit ID, or 29-bit ID with CAN_EFF_FLAG set
+        uint8_t dlc;
+        bool fd;
+        QByteArrayView payload; // Data bytes the DLC covers; points into the record
+    
+        bool isExtended() const { return (id & CAN_EFF_FLAG) != 0; }
+    };
+    
+    /**
+     * @brief Parse one classic or FD record without copying it
+     *
+     * Classic records take a fixed-size fast path. The record must be exactly
+     * one frame long, with a valid DLC and no stray bits in the ID word.
+     * @return False if @p record is malformed; @p frame is then unspecified
+     */
+    static bool parseFrame(QByteArrayView record, Frame &frame);
+    
+    /**
+     * @brief Size of the record whose header starts @p record
+     * @return -1 if the header is incomplete or the DLC is invalid
+     */
+    static int recordSize(QByteArrayView record);
+    
+    /**
+     * @brief Data length for @p dlc: at most 8 for classic CAN, up to 64 for FD
+     * @return -1 if @p dlc is not a 4-bit DLC
+     */
+    static int dataLength(uint8_t dlc, bool fd);
+    
     /**
      * @brief Extract CAN ID from 20-byte packet
      * @param packet The 20-byte CAN packet
@@ -37,6 +88,13 @@ public:
      */
     static uint32_t extractCANId(const QByteArray &packet);
     
+    /**
+     * @brief Extract device timestamp from 20-byte packet
+     * @param packet The 20-byte CAN packet
+     * @return Device timestamp in milliseconds (little endian), 0 if not stamped
+     */
+    static uint32_t extractTimestamp(const QByteArray &packet);
+    
     /**
      * @brief Extract 8-byte payload from packet
      * @param packet The 20-byte CAN packet
@@ -44,6 +102,33 @@ public:
      */
     static QByteArray extractPayload(const QByteArray &packet);
     
+    // Allocation-free overloads for the parser hot path
+    static uint32_t extractCANId(QByteArrayView packet);
+    static uint32_t extractTimestamp(QByteArrayView packet);
+    
+    /**
+     * @brief View of the 8-byte payload inside @p packet, without copying
+     * @return Empty view if @p packet is too short
+     */
+    static QByteArrayView payloadView(QByteArrayView packet);
+    
+    // Bit layouts of the bit-packed messages (64-bit little-endian payload word)
+    using ADCLayout = canlayout::Message<
+        canlayout::Signal<"sus_1", 0, 10>,
+        canlayout::Signal<"sus_2", 10, 10>,
+        canlayout::Signal<"sus_3", 20, 10>,
+        canlayout::Signal<"sus_4", 30, 10>,
+        canlayout::Signal<"brake_pedal", 40, 10>, // PRESSURE_1
+        canlayout::Signal<"acc_pedal", 50, 10>>;  // PRESSURE_2; bits 60-63 unused
+
+    using ProximityEncoderLayout = canlayout::Message<
+        canlayout::Signal<"rpm_fl", 0, 11>,
+        canlayout::Signal<"rpm_fr", 11, 11>,
+        canlayout::Signal<"rpm_rl", 22, 11>,
+        canlayout::Signal<"rpm_rr", 33, 11>,
+        canlayout::Signal<"encoder_angle", 44, 10>,
+        canlayout::Signal<"speed_kmh", 54, 8>>;
+    
     // Decoder structures for each CAN ID
     
     struct IMUAngle {
@@ -129,27 +214,35 @@ public:
      * @return Decoded temperature data
      */
     static Temperatures decodeTemperatures(const QByteArray &payload);
+    
+    // Same decoders over a payload view, e.g. from payloadView()
+    static IMUAngle decodeIMUAngle(QByteArrayView payload);
+    static IMUAccel decodeIMUAccel(QByteArrayView payload);
+    static ADCData decodeADC(QByteArrayView payload);
+    static ProximityAndEncoder decodeProximityAndEncoder(QByteArrayView payload);
+    static GPS decodeGPS(QByteArrayView payload);
+    static Temperatures decodeTemperatures(QByteArrayView payload);
 
 private:
     /**
      * @brief Read int16_t from byte array (little endian)
      */
-    static int16_t readInt16LE(const QByteArray &data, int offset);
+    static int16_t readInt16LE(QByteArrayView data, int offset);
     
     /**
      * @brief Read uint32_t from byte array (little endian)
      */
-    static uint32_t readUInt32LE(const QByteArray &data, int offset);
+    static uint32_t readUInt32LE(QByteArrayView data, int offset);
     
     /**
      * @brief Read uint64_t from byte array (little endian)
      */
-    static uint64_t readUInt64LE(const QByteArray &data, int offset);
+    static uint64_t readUInt64LE(QByteArrayView data, int offset);
     
     /**
      * @brief Read float from byte array (little endian)
      */
-    static float readFloatLE(const QByteArray &data, int offset);
+    static float readFloatLE(QByteArrayView data, int offset);
     
     /**
      * @brief Convert RPM to km/h
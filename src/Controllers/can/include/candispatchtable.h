@@ -0,0 +1,76 @@
+#ifndef CANDISPATCHTABLE_H
+#define CANDISPATCHTABLE_H
+
+#include <QHash>
+#include <array>
+#include <cstdint>
+#include "candecoder.h"
+
+/**
+ * @brief Maps CAN IDs to frame handlers in a single lookup
+ *
+ * Standard 11-bit IDs index a dense 2048-entry array. Extended 29-bit IDs
+ * (CANDecoder::Frame::id with CAN_EFF_FLAG set) are looked up in a hash.
+ * Handlers are plain function pointers that receive the parsed frame and a
+ * caller-defined context, such as the parser's state writer.
+ *
+ * Register handlers at startup, before any parser runs: lookups are not
+ * synchronised against registration.
+ */
+template <typename Context>
+class CANDispatchTable
+{
+public:
+    /**
+     * @return True if the handler applied the frame, false if it ignored it
+     */
+    using Handler = bool (*)(const CANDecoder::Frame &frame, Context &context);
+
+    /**
+     * @brief Route frames with @p id to @p handler
+     * @param id 11-bit ID, or 29-bit ID with CAN_EFF_FLAG set
+     * @return False if @p id is malformed or already has a handler
+     */
+    bool registerHandler(uint32_t id, Handler handler)
+    {
+        if (!handler) {
+            return false;
+        }
+        if (id & CANDecoder::CAN_EFF_FLAG) {
+            if ((id & ~(CANDecoder::CAN_EFF_FLAG | CANDecoder::CAN_EFF_MASK)) || m_extended.contains(id)) {
+                return false;
+            }
+            m_extended.insert(id, handler);
+            return true;
+        }
+        if (id > CANDecoder::CAN_SFF_MASK || m_standard[id]) {
+            return false;
+        }
+        m_standard[id] = handler;
+        ++m_standardCount;
+        return true;
+    }
+
+    /**
+     * @return Handler for @p id, or nullptr if no handler is registered
+     */
+    Handler find(uint32_t id) const
+    {
+        if (!(id & CANDecoder::CAN_EFF_FLAG)) {
+            return id <= CANDecoder::CAN_SFF_MASK ? m_standard[id] : nullptr;
+        }
+        return m_extended.value(id, nullptr);
+    }
+
+    /**
+     * @brief Number of registered IDs
+     */
+    int size() const { return m_standardCount + int(m_extended.size()); }
+
+private:
+    std::array<Handler, CANDecoder::CAN_SFF_MASK + 1> m_standard{};
+    QHash<uint32_t, Handler> m_extended;
+    int m_standardCount = 0;
+};
+
+#endif // CANDISPATCHTABLE_H
@@ -0,0 +1,168 @@
+#ifndef CANLAYOUT_H
+#define CANLAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Compile-time bit layouts of CAN payloads
+ *
+ * A message is declared as a list of signals over the 64-bit little-endian
+ * payload word, e.g.
+ *
+ * @code
+ * using ADC = canlayout::Message<
+ *     canlayout::Signal<"sus_1", 0, 10>,
+ *     canlayout::Signal<"sus_2", 10, 10>>;
+ *
+ * uint16_t sus2 = ADC::get<"sus_2">(raw);
+ * @endcode
+ *
+ * Each get<>() is a constexpr shift and mask with the constants folded in,
+ * so it compiles to the same instructions as hand-written extraction. Signals
+ * that leave the payload, overlap or share a name fail to compile.
+ */
+namespace canlayout {
+
+enum Signedness {
+    Unsigned,
+    Signed
+};
+
+/**
+ * @brief String literal usable as a template argument
+ */
+template <std::size_t N>
+struct FixedString {
+    char value[N];
+
+    constexpr FixedString(const char (&text)[N])
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            value[i] = text[i];
+        }
+    }
+
+    template <std::size_t M>
+    constexpr bool operator==(const FixedString<M> &other) const
+    {
+        if (N != M) {
+            return false;
+        }
+        for (std::size_t i = 0; i < N; ++i) {
+            if (value[i] != other.value[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+namespace detail {
+
+// Smallest standard integer holding Length bits
+template <unsigned Length, Signedness Sign>
+using RawType = std::conditional_t<Sign == Signed,
+    std::conditional_t<(Length <= 8), int8_t,
+        std::conditional_t<(Length <= 16), int16_t,
+            std::conditional_t<(Length <= 32), int32_t, int64_t>>>,
+    std::conditional_t<(Length <= 8), uint8_t,
+        std::conditional_t<(Length <= 16), uint16_t,
+            std::conditional_t<(Length <= 32), uint32_t, uint64_t>>>>;
+
+} // namespace detail
+
+/**
+ * @brief One signal: @p Length bits starting at bit @p Start of the payload word
+ */
+template <FixedString Name, unsigned Start, unsigned Length, Signedness Sign = Unsigned>
+struct Signal {
+    static_assert(Length >= 1 && Length <= 64, "signal length must be 1-64 bits");
+    static_assert(Start + Length <= 64, "signal exceeds the 8-byte payload");
+
+    using Type = detail::RawType<Length, Sign>;
+
+    static constexpr auto name = Name;
+    static constexpr unsigned start = Start;
+    static constexpr unsigned length = Length;
+    static constexpr uint64_t mask = Length == 64 ? ~uint64_t(0) : (uint64_t(1) << Length) - 1;
+
+    static constexpr Type extract(uint64_t raw)
+    {
+        if constexpr (Sign == Signed && Length < 64) {
+            // Move the field's sign bit to bit 63 and shift back arithmetically
+            return static_cast<Type>(static_cast<int64_t>(raw << (64 - Start - Length)) >> (64 - Length));
+        } else {
+            return static_cast<Type>((raw >> Start) & mask);
+        }
+    }
+};
+
+namespace detail {
+
+template <typename... Signals>
+constexpr bool noOverlap()
+{
+    constexpr std::size_t count = sizeof...(Signals);
+    constexpr unsigned starts[] = {Signals::start...};
+    constexpr unsigned lengths[] = {Signals::length...};
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = i + 1; j < count; ++j) {
+            if (starts[i] < starts[j] + lengths[j] && starts[j] < starts[i] + lengths[i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename First, typename... Rest>
+constexpr bool uniqueNames()
+{
+    if constexpr (sizeof...(Rest) == 0) {
+        return true;
+    } else {
+        return (!(First::name == Rest::name) && ...) && uniqueNames<Rest...>();
+    }
+}
+
+template <auto Name, typename First, typename... Rest>
+constexpr auto findSignal()
+{
+    if constexpr (First::name == Name) {
+        return First{};
+    } else {
+        static_assert(sizeof...(Rest) > 0, "no signal with this name in the message");
+        if constexpr (sizeof...(Rest) > 0) {
+            return findSignal<Name, Rest...>();
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief All signals of one CAN message
+ */
+template <typename... Signals>
+struct Message {
+    static_assert(sizeof...(Signals) > 0, "a message needs at least one signal");
+    static_assert(detail::noOverlap<Signals...>(), "signals of a message overlap");
+    static_assert(detail::uniqueNames<Signals...>(), "signal names of a message must be unique");
+
+    static constexpr std::size_t signalCount = sizeof...(Signals);
+
+    template <FixedString Name>
+    using SignalNamed = decltype(detail::findSignal<Name, Signals...>());
+
+    template <FixedString Name>
+    static constexpr auto get(uint64_t raw)
+    {
+        return SignalNamed<Name>::extract(raw);
+    }
+};
+
+} // namespace canlayout
+
+#endif // CANLAYOUT_H
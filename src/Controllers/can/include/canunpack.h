@@ -0,0 +1,66 @@
+#ifndef CANUNPACK_H
+#define CANUNPACK_H
+
+#include <QtGlobal>
+#include <cstdint>
+
+/**
+ * @brief Multi-frame unpacking of the bit-packed ADC and wheel-speed messages
+ *
+ * Takes the 64-bit payload words of many frames of one message and writes
+ * each field into its own column, converting wheel RPM to km/h on the way.
+ * AVX2 (4 frames per step) and SSE4.1 (2 frames per step) kernels are picked
+ * at runtime from the CPU; a scalar loop is the fallback and handles the
+ * tail. All kernels produce results bit-identical to CANDecoder::decodeADC
+ * and CANDecoder::decodeProximityAndEncoder.
+ */
+class CANUnpack
+{
+public:
+    enum Isa {
+        Scalar,
+        Sse41,
+        Avx2
+    };
+
+    struct ADCOutput {
+        uint16_t *sus_1;
+        uint16_t *sus_2;
+        uint16_t *sus_3;
+        uint16_t *sus_4;
+        uint16_t *brake_pedal;
+        uint16_t *acc_pedal;
+    };
+
+    struct ProximityEncoderOutput {
+        double *speed_fl; // km/h
+        double *speed_fr;
+        double *speed_bl;
+        double *speed_br;
+        uint16_t *encoder_angle;
+        uint8_t *speed_kmh;
+    };
+
+    /**
+     * @brief Best kernel set this CPU supports
+     */
+    static Isa detectedIsa();
+
+    /**
+     * @brief Kernel set currently used; detectedIsa() unless overridden
+     */
+    static Isa activeIsa();
+
+    /**
+     * @brief Force a kernel set, e.g. to compare them in tests and benchmarks
+     *
+     * Not thread-safe; call before decoding starts.
+     * @return False if this CPU does not support @p isa
+     */
+    static bool setActiveIsa(Isa isa);
+
+    static void unpackADC(const uint64_t *raw, qsizetype count, const ADCOutput &out);
+    static void unpackProximityEncoder(const uint64_t *raw, qsizetype count, const ProximityEncoderOutput &out);
+};
+
+#endif // CANUNPACK_H
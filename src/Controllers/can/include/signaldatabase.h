@@ -0,0 +1,115 @@
+#ifndef SIGNALDATABASE_H
+#define SIGNALDATABASE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief CAN signal database loaded from a DBC file
+ *
+ * Holds the messages (BO_) and signals (SG_) of a DBC file: start bit, length,
+ * byte order, signedness, scale, offset and unit. SIG_VALTYPE_ entries mark
+ * IEEE float/double signals.
+ *
+ * At load time every message is compiled into a flat decode plan: per-signal
+ * shift, mask, sign and scale arrays stored back to back for all IDs. decode()
+ * then runs one tight loop over a message's entries with no per-signal
+ * branching on the DBC description.
+ *
+ * Lookups take CAN IDs as in CANDecoder::Frame::id: 29-bit IDs carry
+ * CAN_EFF_FLAG, so a standard and an extended message may share a number.
+ */
+class SignalDatabase
+{
+public:
+    enum ValueType {
+        Integer,
+        Float32,
+        Float64
+    };
+
+    struct SignalInfo {
+        QString name;
+        int startBit = 0;       // As written in the DBC (MSB for big endian)
+        int length = 0;
+        bool bigEndian = false; // @0 (Motorola) in the DBC
+        bool isSigned = false;
+        ValueType valueType = Integer;
+        double scale = 1.0;
+        double offset = 0.0;
+        double minimum = 0.0;
+        double maximum = 0.0;
+        QString unit;
+    };
+
+    struct MessageInfo {
+        uint32_t id = 0;        // Without the DBC extended-frame flag
+        bool extended = false;
+        QString name;
+        int dlc = 0;
+        QList<SignalInfo> signalList;
+    };
+
+    /**
+     * @brief Load and compile a DBC file, replacing the current contents
+     * @param error Set to a description with line number on failure
+     * @return False if the file cannot be read or parsed
+     */
+    bool loadFile(const QString &path, QString *error = nullptr);
+
+    /**
+     * @brief Load and compile DBC text, replacing the current contents
+     */
+    bool loadDbc(const QByteArray &dbc, QString *error = nullptr);
+
+    const QList<MessageInfo> &messages() const { return m_messages; }
+    const MessageInfo *message(uint32_t canId) const;
+
+    /**
+     * @brief Index of signal @p name within the decode() output of @p canId
+     * @return -1 if the message or signal is unknown
+     */
+    int signalIndex(uint32_t canId, const QString &name) const;
+
+    /**
+     * @brief Decode all signals of one frame using the compiled plan
+     * @param payload 8 data bytes
+     * @param values Receives the physical values in DBC signal order
+     * @param capacity Size of @p values
+     * @return Number of values written, or -1 if @p canId is unknown or
+     *         @p capacity is too small
+     */
+    int decode(uint32_t canId, const uint8_t *payload, double *values, int capacity) const;
+
+    int decode(uint32_t canId, const QByteArray &payload, double *values, int capacity) const;
+
+private:
+    // Range of plan entries belonging to one message
+    struct PlanRange {
+        int first;
+        int count;
+    };
+
+    bool parse(const QByteArray &dbc, QString *error);
+    void compile();
+    void clear();
+
+    QList<MessageInfo> m_messages;
+    QHash<uint32_t, int> m_messageIndex;
+
+    // Compiled plans for all messages, one entry per signal
+    QHash<uint32_t, PlanRange> m_planIndex;
+    std::vector<uint8_t> m_shift;     // Right shift of the LSB in the selected word
+    std::vector<uint8_t> m_word;      // 0 = little-endian word, 1 = big-endian word
+    std::vector<uint8_t> m_signShift; // 64 - length, for sign extension
+    std::vector<uint8_t> m_type;      // Unsigned, signed, float or double
+    std::vector<uint64_t> m_mask;
+    std::vector<double> m_scale;
+    std::vector<double> m_offset;
+};
+
+#endif // SIGNALDATABASE_H
@@ -0,0 +1,194 @@
+#include "../include/canbatchdecoder.h"
+#include "../include/candecoder.h"
+#include "../include/canunpack.h"
+#include <array>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// Offsets within a CANDecoder packet
+constexpr int TIMESTAMP_OFFSET = 0;
+constexpr int CAN_ID_OFFSET = 4;
+constexpr int PAYLOAD_OFFSET = 9;
+
+inline uint32_t loadUInt32(const uchar *p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value; // Assumes little-endian system, like CANDecoder
+}
+
+inline uint64_t loadUInt64(const uchar *p)
+{
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline const uchar *packetAt(const uchar *data, uint32_t index)
+{
+    return data + static_cast<qsizetype>(index) * CANDecoder::PACKET_SIZE;
+}
+
+// Same conversion as CANDecoder
+inline double toG(int16_t accel)
+{
+    return static_cast<double>(accel) / CANDecoder::GRAVITY_ACCEL;
+}
+
+} // namespace
+
+qsizetype CANBatchDecoder::decode(QByteArrayView packets, Columns &out)
+{
+    const qsizetype count = packets.size() / CANDecoder::PACKET_SIZE;
+    const uchar *data = reinterpret_cast<const uchar *>(packets.data());
+    Q_ASSERT(count <= std::numeric_limits<uint32_t>::max());
+
+    // Pass 1: classify every frame and count frames per message
+    std::vector<uint8_t> kinds(count);
+    std::array<qsizetype, KindCount> groupSize{};
+    for (qsizetype i = 0; i < count; ++i) {
+        const uint32_t index = loadUInt32(data + i * CANDecoder::PACKET_SIZE + CAN_ID_OFFSET) - CANDecoder::CAN_ID_IMU_ANGLE;
+        const uint8_t kind = index < Unknown ? static_cast<uint8_t>(index) : static_cast<uint8_t>(Unknown);
+        kinds[i] = kind;
+        ++groupSize[kind];
+    }
+
+    // Pass 2: stable counting sort of frame indices by message
+    std::array<qsizetype, KindCount> groupStart{};
+    for (int k = 1; k < KindCount; ++k) {
+        groupStart[k] = groupStart[k - 1] + groupSize[k - 1];
+    }
+    std::vector<uint32_t> order(count);
+    std::array<qsizetype, KindCount> next = groupStart;
+    for (qsizetype i = 0; i < count; ++i) {
+        order[next[kinds[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    // Pass 3: decode each group into its columns
+    const uint32_t *groups = order.data();
+    decodeIMUAngle(data, groups + groupStart[IMUAngle], groupSize[IMUAngle], out.imuAngle);
+    decodeIMUAccel(data, groups + groupStart[IMUAccel], groupSize[IMUAccel], out.imuAccel);
+    decodeADC(data, groups + groupStart[ADC], groupSize[ADC], out.adc);
+    decodeProximityEncoder(data, groups + groupStart[ProximityEncoder], groupSize[ProximityEncoder], out.proximityEncoder);
+    decodeGPS(data, groups + groupStart[GPS], groupSize[GPS], out.gps);
+    decodeTemperatures(data, groups + groupStart[Temperatures], groupSize[Temperatures], out.temperatures);
+    out.unknownFrames = groupSize[Unknown];
+
+    return count;
+}
+
+void CANBatchDecoder::decodeIMUAngle(const uchar *data, const uint32_t *frames, qsizetype count, IMUAngleColumns &out)
+{
+    out.timestamp.resize(count);
+    out.ang_x.resize(count);
+    out.ang_y.resize(count);
+    out.ang_z.resize(count);
+
+    for (qsizetype i = 0; i < count; ++i) {
+        const uchar *packet = packetAt(data, frames[i]);
+        const uint64_t raw = loadUInt64(packet + PAYLOAD_OFFSET);
+        out.timestamp[i] = loadUInt32(packet + TIMESTAMP_OFFSET);
+        out.ang_x[i] = static_cast<int16_t>(raw);
+        out.ang_y[i] = static_cast<int16_t>(raw >> 16);
+        out.ang_z[i] = static_cast<int16_t>(raw >> 32);
+    }
+}
+
+void CANBatchDecoder::decodeIMUAccel(const uchar *data, const uint32_t *frames, qsizetype count, IMUAccelColumns &out)
+{
+    out.timestamp.resize(count);
+    out.lateral_g.resize(count);
+    out.longitudinal_g.resize(count);
+    out.accel_z.resize(count);
+
+    for (qsizetype i = 0; i < count; ++i) {
+        const uchar *packet = packetAt(data, frames[i]);
+        const uint64_t raw = loadUInt64(packet + PAYLOAD_OFFSET);
+        out.timestamp[i] = loadUInt32(packet + TIMESTAMP_OFFSET);
+        out.longitudinal_g[i] = toG(static_cast<int16_t>(raw));
+        out.lateral_g[i] = toG(static_cast<int16_t>(raw >> 16));
+        out.accel_z[i] = static_cast<int16_t>(raw >> 32);
+    }
+}
+
+void CANBatchDecoder::decodeADC(const uchar *data, const uint32_t *frames, qsizetype count, ADCColumns &out)
+{
+    out.timestamp.resize(count);
+    out.sus_1.resize(count);
+    out.sus_2.resize(count);
+    out.sus_3.resize(count);
+    out.sus_4.resize(count);
+    out.brake_pedal.resize(count);
+    out.acc_pedal.resize(count);
+
+    // Gather the payload words, then unpack all frames with the SIMD kernels
+    std::vector<uint64_t> raw(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const uchar *packet = packetAt(data, frames[i]);
+        out.timestamp[i] = loadUInt32(packet + TIMESTAMP_OFFSET);
+        raw[i] = loadUInt64(packet + PAYLOAD_OFFSET);
+    }
+
+    CANUnpack::unpackADC(raw.data(), count, {
+        out.sus_1.data(), out.sus_2.data(), out.sus_3.data(), out.sus_4.data(),
+        out.brake_pedal.data(), out.acc_pedal.data()
+    });
+}
+
+void CANBatchDecoder::decodeProximityEncoder(const uchar *data, const uint32_t *frames, qsizetype count, ProximityEncoderColumns &out)
+{
+    out.timestamp.resize(count);
+    out.speed_fl.resize(count);
+    out.speed_fr.resize(count);
+    out.speed_bl.resize(count);
+    out.speed_br.resize(count);
+    out.encoder_angle.resize(count);
+    out.speed_kmh.resize(count);
+
+    std::vector<uint64_t> raw(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const uchar *packet = packetAt(data, frames[i]);
+        out.timestamp[i] = loadUInt32(packet + TIMESTAMP_OFFSET);
+        raw[i] = loadUInt64(packet + PAYLOAD_OFFSET);
+    }
+
+    CANUnpack::unpackProximityEncoder(raw.data(), count, {
+        out.speed_fl.data(), out.speed_fr.data(), out.speed_bl.data(), out.speed_br.data(),
+        out.encoder_angle.data(), out.speed_kmh.data()
+    });
+}
+
+void CANBatchDecoder::decodeGPS(const uchar *data, const uint32_t *frames, qsizetype count, GPSColumns &out)
+{
+    out.timestamp.resize(count);
+    out.longitude.resize(count);
+    out.latitude.resize(count);
+
+    for (qsizetype i = 0; i < count; ++i) {
+        const uchar *packet = packetAt(data, frames[i]);
+        out.timestamp[i] = loadUInt32(packet + TIMESTAMP_OFFSET);
+        std::memcpy(&out.longitude[i], packet + PAYLOAD_OFFSET, sizeof(float));
+        std::memcpy(&out.latitude[i], packet + PAYLOAD_OFFSET + 4, sizeof(float));
+    }
+}
+
+void CANBatchDecoder::decodeTemperatures(const uchar *data, const uint32_t *frames, qsizetype count, TemperatureColumns &out)
+{
+    out.timestamp.resize(count);
+    out.temp_fl.resize(count);
+    out.temp_fr.resize(count);
+    out.temp_rl.resize(count);
+    out.temp_rr.resize(count);
+
+    for (qsizetype i = 0; i < count; ++i) {
+        const uchar *packet = packetAt(data, frames[i]);
+        const uint64_t raw = loadUInt64(packet + PAYLOAD_OFFSET);
+        out.timestamp[i] = loadUInt32(packet + TIMESTAMP_OFFSET);
+        out.temp_fl[i] = static_cast<int16_t>(raw);
+        out.temp_fr[i] = static_cast<int16_t>(raw >> 16);
+        out.temp_rl[i] = static_cast<int16_t>(raw >> 32);
+        out.temp_rr[i] = static_cast<int16_t>(raw >> 48);
+    }
+}
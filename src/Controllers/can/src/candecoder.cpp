@@ -1,7 +1,41 @@
 #include "../include/candecoder.h"
 #include <cstring>
 
+namespace {
+
+// CAN FD data length for each DLC
+constexpr uint8_t FD_DATA_LENGTH[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+// Header plus data, padded like the 20-byte classic record
+constexpr int fdRecordSize(int dataLength)
+{
+    return (CANDecoder::HEADER_SIZE + dataLength + 3) & ~3;
+}
+
+static_assert(fdRecordSize(8) == CANDecoder::PACKET_SIZE, "FD records must pad like classic ones");
+static_assert(fdRecordSize(CANDecoder::MAX_FD_PAYLOAD) == CANDecoder::MAX_RECORD_SIZE, "MAX_RECORD_SIZE is out of date");
+
+} // namespace
+
 uint32_t CANDecoder::extractCANId(const QByteArray &packet)
+{
+    return extractCANId(QByteArrayView(packet));
+}
+
+uint32_t CANDecoder::extractTimestamp(const QByteArray &packet)
+{
+    return extractTimestamp(QByteArrayView(packet));
+}
+
+QByteArray CANDecoder::extractPayload(const QByteArray &packet)
+{
+    if (packet.size() < 17) {
+        return QByteArray();
+    }
+    return packet.mid(9, 8);
+}
+
+uint32_t CANDecoder::extractCANId(QByteArrayView packet)
 {
     if (packet.size() < 8) {
         return 0;
@@ -9,15 +43,108 @@ uint32_t CANDecoder::extractCANId(const QByteArray &packet)
     return readUInt32LE(packet, 4);
 }
 
-QByteArray CANDecoder::extractPayload(const QByteArray &packet)
+uint32_t CANDecoder::extractTimestamp(QByteArrayView packet)
+{
+    if (packet.size() < 4) {
+        return 0;
+    }
+    return readUInt32LE(packet, 0);
+}
+
+QByteArrayView CANDecoder::payloadView(QByteArrayView packet)
 {
     if (packet.size() < 17) {
-        return QByteArray();
+        return QByteArrayView();
     }
-    return packet.mid(9, 8);
+    return packet.sliced(9, 8);
+}
+
+int CANDecoder::dataLength(uint8_t dlc, bool fd)
+{
+    if (dlc > 15) {
+        return -1;
+    }
+    if (fd) {
+        return FD_DATA_LENGTH[dlc];
+    }
+    return dlc < 8 ? dlc : 8; // Classic DLC 9-15 still means 8 bytes
+}
+
+int CANDecoder::recordSize(QByteArrayView record)
+{
+    if (record.size() < HEADER_SIZE) {
+        return -1;
+    }
+    if (!(readUInt32LE(record, 4) & CAN_FD_FLAG)) {
+        return PACKET_SIZE;
+    }
+    const int length = dataLength(static_cast<uint8_t>(record[8]), true);
+    return length < 0 ? -1 : fdRecordSize(length);
+}
+
+bool CANDecoder::parseFrame(QByteArrayView record, Frame &frame)
+{
+    if (record.size() < HEADER_SIZE) {
+        return false;
+    }
+    const uint32_t word = readUInt32LE(record, 4);
+    const uint8_t dlc = static_cast<uint8_t>(record[8]);
+    const bool fd = (word & CAN_FD_FLAG) != 0;
+    const int length = dataLength(dlc, fd);
+    if (length < 0) {
+        return false;
+    }
+
+    // Classic frames keep the fixed 20-byte record
+    if (record.size() != (fd ? fdRecordSize(length) : PACKET_SIZE)) {
+        return false;
+    }
+
+    const uint32_t id = word & ~CAN_FD_FLAG;
+    const uint32_t idMask = (id & CAN_EFF_FLAG) ? (CAN_EFF_FLAG | CAN_EFF_MASK) : CAN_SFF_MASK;
+    if (id & ~idMask) {
+        return false;
+    }
+
+    frame.timestamp = readUInt32LE(record, 0);
+    frame.id = id;
+    frame.dlc = dlc;
+    frame.fd = fd;
+    frame.payload = record.sliced(HEADER_SIZE, length);
+    return true;
 }
 
 CANDecoder::IMUAngle CANDecoder::decodeIMUAngle(const QByteArray &payload)
+{
+    return decodeIMUAngle(QByteArrayView(payload));
+}
+
+CANDecoder::IMUAccel CANDecoder::decodeIMUAccel(const QByteArray &payload)
+{
+    return decodeIMUAccel(QByteArrayView(payload));
+}
+
+CANDecoder::ADCData CANDecoder::decodeADC(const QByteArray &payload)
+{
+    return decodeADC(QByteArrayView(payload));
+}
+
+CANDecoder::ProximityAndEncoder CANDecoder::decodeProximityAndEncoder(const QByteArray &payload)
+{
+    return decodeProximityAndEncoder(QByteArrayView(payload));
+}
+
+CANDecoder::GPS CANDecoder::decodeGPS(const QByteArray &payload)
+{
+    return decodeGPS(QByteArrayView(payload));
+}
+
+CANDecoder::Temperatures CANDecoder::decodeTemperatures(const QByteArray &payload)
+{
+    return decodeTemperatures(QByteArrayView(payload));
+}
+
+CANDecoder::IMUAngle CANDecoder::decodeIMUAngle(QByteArrayView payload)
 {
     IMUAngle result;
     result.ang_x = readInt16LE(payload, 0);
@@ -26,7 +153,7 @@ CANDecoder::IMUAngle CANDecoder::decodeIMUAngle(const QByteArray &payload)
     return result;
 }
 
-CANDecoder::IMUAccel CANDecoder::decodeIMUAccel(const QByteArray &payload)
+CANDecoder::IMUAccel CANDecoder::decodeIMUAccel(QByteArrayView payload)
 {
     IMUAccel result;
     int16_t accel_x = readInt16LE(payload, 0);
@@ -40,35 +167,34 @@ CANDecoder::IMUAccel CANDecoder::decodeIMUAccel(const QByteArray &payload)
     return result;
 }
 
-CANDecoder::ADCData CANDecoder::decodeADC(const QByteArray &payload)
+CANDecoder::ADCData CANDecoder::decodeADC(QByteArrayView payload)
 {
     ADCData result;
     uint64_t raw_data = readUInt64LE(payload, 0);
     
     // Extract bit-packed values
-    result.sus_1 = (raw_data >> 0) & 0x3FF;   // 10 bits
-    result.sus_2 = (raw_data >> 10) & 0x3FF;  // 10 bits
-    result.sus_3 = (raw_data >> 20) & 0x3FF;  // 10 bits
-    result.sus_4 = (raw_data >> 30) & 0x3FF;  // 10 bits
-    result.brake_pedal = (raw_data >> 40) & 0x3FF;  // 10 bits (PRESSURE_1)
-    result.acc_pedal = (raw_data >> 50) & 0x3FF;    // 10 bits (PRESSURE_2)
-    // Bits 60-63 are ignored
+    result.sus_1 = ADCLayout::get<"sus_1">(raw_data);
+    result.sus_2 = ADCLayout::get<"sus_2">(raw_data);
+    result.sus_3 = ADCLayout::get<"sus_3">(raw_data);
+    result.sus_4 = ADCLayout::get<"sus_4">(raw_data);
+    result.brake_pedal = ADCLayout::get<"brake_pedal">(raw_data);
+    result.acc_pedal = ADCLayout::get<"acc_pedal">(raw_data);
     
     return result;
 }
 
-CANDecoder::ProximityAndEncoder CANDecoder::decodeProximityAndEncoder(const QByteArray &payload)
+CANDecoder::ProximityAndEncoder CANDecoder::decodeProximityAndEncoder(QByteArrayView payload)
 {
     ProximityAndEncoder result;
     uint64_t raw_data = readUInt64LE(payload, 0);
     
     // Extract bit-packed values
-    uint16_t rpm_fl = (raw_data >> 0) & 0x7FF;   // 11 bits
-    uint16_t rpm_fr = (raw_data >> 11) & 0x7FF;  // 11 bits
-    uint16_t rpm_rl = (raw_data >> 22) & 0x7FF;  // 11 bits
-    uint16_t rpm_rr = (raw_data >> 33) & 0x7FF;  // 11 bits
-    result.encoder_angle = (raw_data >> 44) & 0x3FF;  // 10 bits
-    result.speed_kmh = (raw_data >> 54) & 0xFF;       // 8 bits
+    uint16_t rpm_fl = ProximityEncoderLayout::get<"rpm_fl">(raw_data);
+    uint16_t rpm_fr = ProximityEncoderLayout::get<"rpm_fr">(raw_data);
+    uint16_t rpm_rl = ProximityEncoderLayout::get<"rpm_rl">(raw_data);
+    uint16_t rpm_rr = ProximityEncoderLayout::get<"rpm_rr">(raw_data);
+    result.encoder_angle = ProximityEncoderLayout::get<"encoder_angle">(raw_data);
+    result.speed_kmh = ProximityEncoderLayout::get<"speed_kmh">(raw_data);
     
     // Convert RPM to km/h
     result.speed_fl = rpmToKmh(rpm_fl);
@@ -79,7 +205,7 @@ CANDecoder::ProximityAndEncoder CANDecoder::decodeProximityAndEncoder(const QByt
     return result;
 }
 
-CANDecoder::GPS CANDecoder::decodeGPS(const QByteArray &payload)
+CANDecoder::GPS CANDecoder::decodeGPS(QByteArrayView payload)
 {
     GPS result;
     result.longitude = readFloatLE(payload, 0);
@@ -87,7 +213,7 @@ CANDecoder::GPS CANDecoder::decodeGPS(const QByteArray &payload)
     return result;
 }
 
-CANDecoder::Temperatures CANDecoder::decodeTemperatures(const QByteArray &payload)
+CANDecoder::Temperatures CANDecoder::decodeTemperatures(QByteArrayView payload)
 {
     Temperatures result;
     result.temp_fl = readInt16LE(payload, 0);
@@ -99,7 +225,7 @@ CANDecoder::Temperatures CANDecoder::decodeTemperatures(const QByteArray &payloa
 
 // Private helper methods
 
-int16_t CANDecoder::readInt16LE(const QByteArray &data, int offset)
+int16_t CANDecoder::readInt16LE(QByteArrayView data, int offset)
 {
     if (offset + 2 > data.size()) {
         return 0;
@@ -109,7 +235,7 @@ int16_t CANDecoder::readInt16LE(const QByteArray &data, int offset)
     return value;  // Assumes little-endian system
 }
 
-uint32_t CANDecoder::readUInt32LE(const QByteArray &data, int offset)
+uint32_t CANDecoder::readUInt32LE(QByteArrayView data, int offset)
 {
     if (offset + 4 > data.size()) {
         return 0;
@@ -119,7 +245,7 @@ uint32_t CANDecoder::readUInt32LE(const QByteArray &data, int offset)
     return value;  // Assumes little-endian system
 }
 
-uint64_t CANDecoder::readUInt64LE(const QByteArray &data, int offset)
+uint64_t CANDecoder::readUInt64LE(QByteArrayView data, int offset)
 {
     if (offset + 8 > data.size()) {
         return 0;
@@ -129,7 +255,7 @@ uint64_t CANDecoder::readUInt64LE(const QByteArray &data, int offset)
     return value;  // Assumes little-endian system
 }
 
-float CANDecoder::readFloatLE(const QByteArray &data, int offset)
+float CANDecoder::readFloatLE(QByteArrayView data, int offset)
 {
     if (offset + 4 > data.size()) {
         return 0.0f;
@@ -0,0 +1,317 @@
+#include "../include/canunpack.h"
+#include "../include/candecoder.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CAN_UNPACK_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2/SSE4.1 code inside functions marked for it,
+// so the rest of the build keeps the baseline instruction set; MSVC always can
+#if defined(CAN_UNPACK_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CAN_TARGET_AVX2 __attribute__((target("avx2")))
+#define CAN_TARGET_SSE41 __attribute__((target("sse4.1")))
+#else
+#define CAN_TARGET_AVX2
+#define CAN_TARGET_SSE41
+#endif
+
+namespace {
+
+using ADC = CANDecoder::ADCLayout;
+using Proximity = CANDecoder::ProximityEncoderLayout;
+
+// Field positions come from the layouts; the kernels only need them as immediates
+constexpr int SUS_1 = ADC::SignalNamed<"sus_1">::start;
+constexpr int SUS_2 = ADC::SignalNamed<"sus_2">::start;
+constexpr int SUS_3 = ADC::SignalNamed<"sus_3">::start;
+constexpr int SUS_4 = ADC::SignalNamed<"sus_4">::start;
+constexpr int BRAKE_PEDAL = ADC::SignalNamed<"brake_pedal">::start;
+constexpr int ACC_PEDAL = ADC::SignalNamed<"acc_pedal">::start;
+constexpr uint64_t ADC_MASK = ADC::SignalNamed<"sus_1">::mask;
+
+constexpr int RPM_FL = Proximity::SignalNamed<"rpm_fl">::start;
+constexpr int RPM_FR = Proximity::SignalNamed<"rpm_fr">::start;
+constexpr int RPM_RL = Proximity::SignalNamed<"rpm_rl">::start;
+constexpr int RPM_RR = Proximity::SignalNamed<"rpm_rr">::start;
+constexpr int ENCODER_ANGLE = Proximity::SignalNamed<"encoder_angle">::start;
+constexpr int SPEED_KMH = Proximity::SignalNamed<"speed_kmh">::start;
+constexpr uint64_t RPM_MASK = Proximity::SignalNamed<"rpm_fl">::mask;
+constexpr uint64_t ENCODER_MASK = Proximity::SignalNamed<"encoder_angle">::mask;
+constexpr uint64_t SPEED_MASK = Proximity::SignalNamed<"speed_kmh">::mask;
+
+static_assert(ADC::SignalNamed<"acc_pedal">::mask == ADC_MASK && ADC::SignalNamed<"brake_pedal">::mask == ADC_MASK,
+              "ADC kernels assume equal field widths");
+static_assert(Proximity::SignalNamed<"rpm_rr">::mask == RPM_MASK, "wheel-speed kernels assume equal RPM widths");
+
+// Same operations, in the same order, as CANDecoder::rpmToKmh
+inline double rpmToKmh(uint64_t rpm)
+{
+    return (static_cast<double>(rpm) * CANDecoder::WHEEL_CIRCUMFERENCE * 60.0) / 1000.0;
+}
+
+void unpackADCScalar(const uint64_t *raw, qsizetype begin, qsizetype count, const CANUnpack::ADCOutput &out)
+{
+    for (qsizetype i = begin; i < count; ++i) {
+        const uint64_t r = raw[i];
+        out.sus_1[i] = static_cast<uint16_t>((r >> SUS_1) & ADC_MASK);
+        out.sus_2[i] = static_cast<uint16_t>((r >> SUS_2) & ADC_MASK);
+        out.sus_3[i] = static_cast<uint16_t>((r >> SUS_3) & ADC_MASK);
+        out.sus_4[i] = static_cast<uint16_t>((r >> SUS_4) & ADC_MASK);
+        out.brake_pedal[i] = static_cast<uint16_t>((r >> BRAKE_PEDAL) & ADC_MASK);
+        out.acc_pedal[i] = static_cast<uint16_t>((r >> ACC_PEDAL) & ADC_MASK);
+    }
+}
+
+void unpackProximityScalar(const uint64_t *raw, qsizetype begin, qsizetype count, const CANUnpack::ProximityEncoderOutput &out)
+{
+    for (qsizetype i = begin; i < count; ++i) {
+        const uint64_t r = raw[i];
+        out.speed_fl[i] = rpmToKmh((r >> RPM_FL) & RPM_MASK);
+        out.speed_fr[i] = rpmToKmh((r >> RPM_FR) & RPM_MASK);
+        out.speed_bl[i] = rpmToKmh((r >> RPM_RL) & RPM_MASK);
+        out.speed_br[i] = rpmToKmh((r >> RPM_RR) & RPM_MASK);
+        out.encoder_angle[i] = static_cast<uint16_t>((r >> ENCODER_ANGLE) & ENCODER_MASK);
+        out.speed_kmh[i] = static_cast<uint8_t>((r >> SPEED_KMH) & SPEED_MASK);
+    }
+}
+
+#ifdef CAN_UNPACK_X86
+
+// AVX2: 4 frames per step. Fields are extracted per 64-bit lane, then the
+// low dwords are gathered into one 128-bit register and narrowed from there
+
+CAN_TARGET_AVX2 inline __m128i avx2Narrow(__m256i lanes)
+{
+    const __m256i lowDwords = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(lanes, lowDwords));
+}
+
+template <int Shift>
+CAN_TARGET_AVX2 inline __m128i avx2Field(__m256i raw, __m256i mask)
+{
+    return avx2Narrow(_mm256_and_si256(_mm256_srli_epi64(raw, Shift), mask));
+}
+
+CAN_TARGET_AVX2 inline void storeU16x4(uint16_t *dst, __m128i values)
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packus_epi32(values, values));
+}
+
+CAN_TARGET_AVX2 inline void storeU8x4(uint8_t *dst, __m128i values)
+{
+    const __m128i words = _mm_packus_epi32(values, values);
+    const int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+    std::memcpy(dst, &bytes, sizeof(bytes));
+}
+
+CAN_TARGET_AVX2 inline void storeKmhx4(double *dst, __m128i rpm)
+{
+    __m256d speed = _mm256_cvtepi32_pd(rpm);
+    speed = _mm256_mul_pd(speed, _mm256_set1_pd(CANDecoder::WHEEL_CIRCUMFERENCE));
+    speed = _mm256_mul_pd(speed, _mm256_set1_pd(60.0));
+    speed = _mm256_div_pd(speed, _mm256_set1_pd(1000.0));
+    _mm256_storeu_pd(dst, speed);
+}
+
+CAN_TARGET_AVX2 void unpackADCAvx2(const uint64_t *raw, qsizetype count, const CANUnpack::ADCOutput &out)
+{
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(ADC_MASK));
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(raw + i));
+        storeU16x4(out.sus_1 + i, avx2Field<SUS_1>(r, mask));
+        storeU16x4(out.sus_2 + i, avx2Field<SUS_2>(r, mask));
+        storeU16x4(out.sus_3 + i, avx2Field<SUS_3>(r, mask));
+        storeU16x4(out.sus_4 + i, avx2Field<SUS_4>(r, mask));
+        storeU16x4(out.brake_pedal + i, avx2Field<BRAKE_PEDAL>(r, mask));
+        storeU16x4(out.acc_pedal + i, avx2Field<ACC_PEDAL>(r, mask));
+    }
+    unpackADCScalar(raw, i, count, out);
+}
+
+CAN_TARGET_AVX2 void unpackProximityAvx2(const uint64_t *raw, qsizetype count, const CANUnpack::ProximityEncoderOutput &out)
+{
+    const __m256i rpmMask = _mm256_set1_epi64x(static_cast<long long>(RPM_MASK));
+    const __m256i encoderMask = _mm256_set1_epi64x(static_cast<long long>(ENCODER_MASK));
+    const __m256i speedMask = _mm256_set1_epi64x(static_cast<long long>(SPEED_MASK));
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(raw + i));
+        storeKmhx4(out.speed_fl + i, avx2Field<RPM_FL>(r, rpmMask));
+        storeKmhx4(out.speed_fr + i, avx2Field<RPM_FR>(r, rpmMask));
+        storeKmhx4(out.speed_bl + i, avx2Field<RPM_RL>(r, rpmMask));
+        storeKmhx4(out.speed_br + i, avx2Field<RPM_RR>(r, rpmMask));
+        storeU16x4(out.encoder_angle + i, avx2Field<ENCODER_ANGLE>(r, encoderMask));
+        storeU8x4(out.speed_kmh + i, avx2Field<SPEED_KMH>(r, speedMask));
+    }
+    unpackProximityScalar(raw, i, count, out);
+}
+
+// SSE4.1: 2 frames per step, same scheme with 128-bit registers
+
+CAN_TARGET_SSE41 inline __m128i sseNarrow(__m128i lanes)
+{
+    return _mm_shuffle_epi32(lanes, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+template <int Shift>
+CAN_TARGET_SSE41 inline __m128i sseField(__m128i raw, __m128i mask)
+{
+    return sseNarrow(_mm_and_si128(_mm_srli_epi64(raw, Shift), mask));
+}
+
+CAN_TARGET_SSE41 inline void storeU16x2(uint16_t *dst, __m128i values)
+{
+    const int words = _mm_cvtsi128_si32(_mm_packus_epi32(values, values));
+    std::memcpy(dst, &words, 2 * sizeof(uint16_t));
+}
+
+CAN_TARGET_SSE41 inline void storeU8x2(uint8_t *dst, __m128i values)
+{
+    const __m128i words = _mm_packus_epi32(values, values);
+    const int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+    std::memcpy(dst, &bytes, 2 * sizeof(uint8_t));
+}
+
+CAN_TARGET_SSE41 inline void storeKmhx2(double *dst, __m128i rpm)
+{
+    __m128d speed = _mm_cvtepi32_pd(rpm);
+    speed = _mm_mul_pd(speed, _mm_set1_pd(CANDecoder::WHEEL_CIRCUMFERENCE));
+    speed = _mm_mul_pd(speed, _mm_set1_pd(60.0));
+    speed = _mm_div_pd(speed, _mm_set1_pd(1000.0));
+    _mm_storeu_pd(dst, speed);
+}
+
+CAN_TARGET_SSE41 void unpackADCSse41(const uint64_t *raw, qsizetype count, const CANUnpack::ADCOutput &out)
+{
+    const __m128i mask = _mm_set1_epi64x(static_cast<long long>(ADC_MASK));
+    qsizetype i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + i));
+        storeU16x2(out.sus_1 + i, sseField<SUS_1>(r, mask));
+        storeU16x2(out.sus_2 + i, sseField<SUS_2>(r, mask));
+        storeU16x2(out.sus_3 + i, sseField<SUS_3>(r, mask));
+        storeU16x2(out.sus_4 + i, sseField<SUS_4>(r, mask));
+        storeU16x2(out.brake_pedal + i, sseField<BRAKE_PEDAL>(r, mask));
+        storeU16x2(out.acc_pedal + i, sseField<ACC_PEDAL>(r, mask));
+    }
+    unpackADCScalar(raw, i, count, out);
+}
+
+CAN_TARGET_SSE41 void unpackProximitySse41(const uint64_t *raw, qsizetype count, const CANUnpack::ProximityEncoderOutput &out)
+{
+    const __m128i rpmMask = _mm_set1_epi64x(static_cast<long long>(RPM_MASK));
+    const __m128i encoderMask = _mm_set1_epi64x(static_cast<long long>(ENCODER_MASK));
+    const __m128i speedMask = _mm_set1_epi64x(static_cast<long long>(SPEED_MASK));
+    qsizetype i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + i));
+        storeKmhx2(out.speed_fl + i, sseField<RPM_FL>(r, rpmMask));
+        storeKmhx2(out.speed_fr + i, sseField<RPM_FR>(r, rpmMask));
+        storeKmhx2(out.speed_bl + i, sseField<RPM_RL>(r, rpmMask));
+        storeKmhx2(out.speed_br + i, sseField<RPM_RR>(r, rpmMask));
+        storeU16x2(out.encoder_angle + i, sseField<ENCODER_ANGLE>(r, encoderMask));
+        storeU8x2(out.speed_kmh + i, sseField<SPEED_KMH>(r, speedMask));
+    }
+    unpackProximityScalar(raw, i, count, out);
+}
+
+#endif // CAN_UNPACK_X86
+
+CANUnpack::Isa detectIsa()
+{
+#if defined(CAN_UNPACK_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return CANUnpack::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return CANUnpack::Sse41;
+    }
+#elif defined(CAN_UNPACK_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) { // OS saves YMM state
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    if (avx2) {
+        return CANUnpack::Avx2;
+    }
+    if (sse41) {
+        return CANUnpack::Sse41;
+    }
+#endif
+    return CANUnpack::Scalar;
+}
+
+CANUnpack::Isa s_activeIsa = CANUnpack::detectedIsa();
+
+} // namespace
+
+CANUnpack::Isa CANUnpack::detectedIsa()
+{
+    static const Isa detected = detectIsa();
+    return detected;
+}
+
+CANUnpack::Isa CANUnpack::activeIsa()
+{
+    return s_activeIsa;
+}
+
+bool CANUnpack::setActiveIsa(Isa isa)
+{
+    if (isa > detectedIsa()) {
+        return false;
+    }
+    s_activeIsa = isa;
+    return true;
+}
+
+void CANUnpack::unpackADC(const uint64_t *raw, qsizetype count, const ADCOutput &out)
+{
+    switch (s_activeIsa) {
+#ifdef CAN_UNPACK_X86
+    case Avx2:
+        unpackADCAvx2(raw, count, out);
+        return;
+    case Sse41:
+        unpackADCSse41(raw, count, out);
+        return;
+#endif
+    default:
+        unpackADCScalar(raw, 0, count, out);
+        return;
+    }
+}
+
+void CANUnpack::unpackProximityEncoder(const uint64_t *raw, qsizetype count, const ProximityEncoderOutput &out)
+{
+    switch (s_activeIsa) {
+#ifdef CAN_UNPACK_X86
+    case Avx2:
+        unpackProximityAvx2(raw, count, out);
+        return;
+    case Sse41:
+        unpackProximitySse41(raw, count, out);
+        return;
+#endif
+    default:
+        unpackProximityScalar(raw, 0, count, out);
+        return;
+    }
+}
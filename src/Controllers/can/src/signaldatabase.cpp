@@ -0,0 +1,298 @@
+#include "../include/signaldatabase.h"
+#include "../include/candecoder.h"
+#include <QFile>
+#include <QRegularExpression>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+// Plan entry kinds; the DBC description is reduced to these at compile time
+enum PlanKind : uint8_t {
+    UnsignedInt,
+    SignedInt,
+    IeeeFloat32,
+    IeeeFloat64
+};
+
+constexpr uint32_t DBC_EXTENDED_FLAG = 0x80000000u;
+constexpr int PAYLOAD_BITS = 64;
+
+// Index key of a message: its ID in the CANDecoder::Frame::id convention, so
+// a standard and an extended message with the same number stay apart
+uint32_t frameId(const SignalDatabase::MessageInfo &info)
+{
+    return info.id | (info.extended ? CANDecoder::CAN_EFF_FLAG : 0);
+}
+
+uint32_t frameId(uint32_t dbcId)
+{
+    return (dbcId & ~DBC_EXTENDED_FLAG) | ((dbcId & DBC_EXTENDED_FLAG) ? CANDecoder::CAN_EFF_FLAG : 0);
+}
+
+// Bit position of a big-endian signal's MSB, counted from the MSB of the
+// payload read as a big-endian 64-bit word
+int bigEndianMsbPosition(int startBit)
+{
+    return (startBit / 8) * 8 + (7 - startBit % 8);
+}
+
+bool setError(QString *error, int line, const QString &message)
+{
+    if (error) {
+        *error = QStringLiteral("line %1: %2").arg(line).arg(message);
+    }
+    return false;
+}
+
+} // namespace
+
+bool SignalDatabase::loadFile(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        clear();
+        return false;
+    }
+    return loadDbc(file.readAll(), error);
+}
+
+bool SignalDatabase::loadDbc(const QByteArray &dbc, QString *error)
+{
+    clear();
+    if (!parse(dbc, error)) {
+        clear();
+        return false;
+    }
+    compile();
+    return true;
+}
+
+const SignalDatabase::MessageInfo *SignalDatabase::message(uint32_t canId) const
+{
+    const auto it = m_messageIndex.constFind(canId);
+    return it == m_messageIndex.constEnd() ? nullptr : &m_messages.at(*it);
+}
+
+int SignalDatabase::signalIndex(uint32_t canId, const QString &name) const
+{
+    const MessageInfo *info = message(canId);
+    if (!info) {
+        return -1;
+    }
+    for (int i = 0; i < info->signalList.size(); ++i) {
+        if (info->signalList.at(i).name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int SignalDatabase::decode(uint32_t canId, const uint8_t *payload, double *values, int capacity) const
+{
+    const auto it = m_planIndex.constFind(canId);
+    if (it == m_planIndex.constEnd() || it->count > capacity) {
+        return -1;
+    }
+
+    // Both byte orders are read once per frame; each entry picks its word
+    const uint64_t le = qFromLittleEndian<quint64>(payload);
+    const uint64_t words[2] = {le, qbswap(le)};
+
+    const int end = it->first + it->count;
+    for (int i = it->first; i < end; ++i) {
+        const uint64_t raw = (words[m_word[i]] >> m_shift[i]) & m_mask[i];
+
+        double value;
+        switch (m_type[i]) {
+        case SignedInt:
+            value = static_cast<double>(static_cast<int64_t>(raw << m_signShift[i]) >> m_signShift[i]);
+            break;
+        case IeeeFloat32: {
+            const uint32_t bits = static_cast<uint32_t>(raw);
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            value = f;
+            break;
+        }
+        case IeeeFloat64:
+            std::memcpy(&value, &raw, sizeof(value));
+            break;
+        default:
+            value = static_cast<double>(raw);
+            break;
+        }
+
+        *values++ = value * m_scale[i] + m_offset[i];
+    }
+    return it->count;
+}
+
+int SignalDatabase::decode(uint32_t canId, const QByteArray &payload, double *values, int capacity) const
+{
+    if (payload.size() < 8) {
+        return -1;
+    }
+    return decode(canId, reinterpret_cast<const uint8_t *>(payload.constData()), values, capacity);
+}
+
+bool SignalDatabase::parse(const QByteArray &dbc, QString *error)
+{
+    static const QRegularExpression messageRe(
+        QStringLiteral(R"(^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+\S+)"));
+    static const QRegularExpression signalRe(
+        QStringLiteral(R"(^SG_\s+(\w+)\s*(\w*)\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*)"
+                       R"(\(\s*([^,\s]+)\s*,\s*([^)\s]+)\s*\)\s*)"
+                       R"re(\[\s*([^|\s]+)\s*\|\s*([^\]\s]+)\s*\]\s*"([^"]*)")re"));
+    static const QRegularExpression valueTypeRe(
+        QStringLiteral(R"(^SIG_VALTYPE_\s+(\d+)\s+(\w+)\s*:?\s*([0-3])\s*;)"));
+
+    const QList<QByteArray> lines = dbc.split('\n');
+    MessageInfo *current = nullptr;
+
+    for (int lineNo = 1; lineNo <= lines.size(); ++lineNo) {
+        const QString line = QString::fromUtf8(lines.at(lineNo - 1)).trimmed();
+
+        if (line.startsWith(QLatin1String("BO_ "))) {
+            const QRegularExpressionMatch match = messageRe.match(line);
+            if (!match.hasMatch()) {
+                return setError(error, lineNo, QStringLiteral("malformed BO_ entry"));
+            }
+
+            MessageInfo info;
+            const uint32_t rawId = match.captured(1).toUInt();
+            info.extended = (rawId & DBC_EXTENDED_FLAG) != 0;
+            info.id = rawId & ~DBC_EXTENDED_FLAG;
+            info.name = match.captured(2);
+            info.dlc = match.captured(3).toInt();
+
+            if (m_messageIndex.contains(frameId(info))) {
+                return setError(error, lineNo, QStringLiteral("duplicate message ID %1").arg(rawId));
+            }
+            m_messageIndex.insert(frameId(info), m_messages.size());
+            m_messages.append(info);
+            current = &m_messages.last();
+        } else if (line.startsWith(QLatin1String("SG_ "))) {
+            if (!current) {
+                return setError(error, lineNo, QStringLiteral("SG_ outside of a message"));
+            }
+            const QRegularExpressionMatch match = signalRe.match(line);
+            if (!match.hasMatch()) {
+                return setError(error, lineNo, QStringLiteral("malformed SG_ entry"));
+            }
+            if (!match.captured(2).isEmpty()) {
+                return setError(error, lineNo, QStringLiteral("multiplexed signals are not supported"));
+            }
+
+            SignalInfo info;
+            info.name = match.captured(1);
+            info.startBit = match.captured(3).toInt();
+            info.length = match.captured(4).toInt();
+            info.bigEndian = match.captured(5) == QLatin1String("0");
+            info.isSigned = match.captured(6) == QLatin1String("-");
+            info.scale = match.captured(7).toDouble();
+            info.offset = match.captured(8).toDouble();
+            info.minimum = match.captured(9).toDouble();
+            info.maximum = match.captured(10).toDouble();
+            info.unit = match.captured(11);
+
+            const int lastBit = info.bigEndian
+                ? bigEndianMsbPosition(info.startBit) + info.length
+                : info.startBit + info.length;
+            if (info.length < 1 || info.length > PAYLOAD_BITS || info.startBit >= PAYLOAD_BITS || lastBit > PAYLOAD_BITS) {
+                return setError(error, lineNo, QStringLiteral("signal %1 does not fit in 8 bytes").arg(info.name));
+            }
+            current->signalList.append(info);
+        } else if (line.startsWith(QLatin1String("SIG_VALTYPE_ "))) {
+            const QRegularExpressionMatch match = valueTypeRe.match(line);
+            if (!match.hasMatch()) {
+                return setError(error, lineNo, QStringLiteral("malformed SIG_VALTYPE_ entry"));
+            }
+
+            const auto it = m_messageIndex.constFind(frameId(match.captured(1).toUInt()));
+            if (it == m_messageIndex.constEnd()) {
+                return setError(error, lineNo, QStringLiteral("unknown message %1").arg(match.captured(1)));
+            }
+
+            bool found = false;
+            for (SignalInfo &info : m_messages[*it].signalList) {
+                if (info.name != match.captured(2)) {
+                    continue;
+                }
+                const int type = match.captured(3).toInt();
+                info.valueType = type == 1 ? Float32 : (type == 2 ? Float64 : Integer);
+                if ((info.valueType == Float32 && info.length != 32) || (info.valueType == Float64 && info.length != 64)) {
+                    return setError(error, lineNo, QStringLiteral("signal %1 has the wrong length for its float type").arg(info.name));
+                }
+                found = true;
+            }
+            if (!found) {
+                return setError(error, lineNo, QStringLiteral("unknown signal %1").arg(match.captured(2)));
+            }
+        } else if (!line.isEmpty()) {
+            current = nullptr; // Any other section ends the current message
+        }
+    }
+    return true;
+}
+
+void SignalDatabase::compile()
+{
+    int total = 0;
+    for (const MessageInfo &info : std::as_const(m_messages)) {
+        total += info.signalList.size();
+    }
+    m_shift.reserve(total);
+    m_word.reserve(total);
+    m_signShift.reserve(total);
+    m_type.reserve(total);
+    m_mask.reserve(total);
+    m_scale.reserve(total);
+    m_offset.reserve(total);
+
+    for (const MessageInfo &info : std::as_const(m_messages)) {
+        m_planIndex.insert(frameId(info), {static_cast<int>(m_shift.size()), static_cast<int>(info.signalList.size())});
+
+        for (const SignalInfo &sig : info.signalList) {
+            // Little-endian signals count from the LSB of the LE word; big-endian
+            // ones are taken from the BE word, where the MSB position is known
+            const int shift = sig.bigEndian
+                ? PAYLOAD_BITS - (bigEndianMsbPosition(sig.startBit) + sig.length)
+                : sig.startBit;
+
+            uint8_t kind = UnsignedInt;
+            if (sig.valueType == Float32) {
+                kind = IeeeFloat32;
+            } else if (sig.valueType == Float64) {
+                kind = IeeeFloat64;
+            } else if (sig.isSigned) {
+                kind = SignedInt;
+            }
+
+            m_shift.push_back(static_cast<uint8_t>(shift));
+            m_word.push_back(sig.bigEndian ? 1 : 0);
+            m_signShift.push_back(static_cast<uint8_t>(PAYLOAD_BITS - sig.length));
+            m_type.push_back(kind);
+            m_mask.push_back(sig.length == PAYLOAD_BITS ? ~uint64_t(0) : (uint64_t(1) << sig.length) - 1);
+            m_scale.push_back(sig.scale);
+            m_offset.push_back(sig.offset);
+        }
+    }
+}
+
+void SignalDatabase::clear()
+{
+    m_messages.clear();
+    m_messageIndex.clear();
+    m_planIndex.clear();
+    m_shift.clear();
+    m_word.clear();
+    m_signShift.clear();
+    m_type.clear();
+    m_mask.clear();
+    m_scale.clear();
+    m_offset.clear();
+}
@@ -4,6 +4,9 @@
 #include <QObject>
 #include <QVariant>
 #include <QDebug>
+#include "../../telemetry/include/framededuplicator.h"
+#include "../../telemetry/include/signalfilter.h"
+#include "../../telemetry/include/telemetrystate.h"
 
 // Forward declarations
 class UdpClient;
@@ -15,7 +18,10 @@ class CommunicationManager : public QObject
 {
     Q_OBJECT
 
-    // Expose all properties that were previously in UdpClient and SerialManager
+    // Whole telemetry state, published once per flush
+    Q_PROPERTY(TelemetrySnapshot snapshot READ snapshot NOTIFY snapshotChanged)
+
+    // Per-field views of the snapshot, kept for existing QML bindings
     Q_PROPERTY(float speed READ speed NOTIFY speedChanged)
     Q_PROPERTY(int rpm READ rpm NOTIFY rpmChanged)
     Q_PROPERTY(int accPedal READ accPedal NOTIFY accPedalChanged)
@@ -37,40 +43,77 @@ class CommunicationManager : public QObject
     Q_PROPERTY(int tempBR READ tempBR NOTIFY tempBRChanged)
     Q_PROPERTY(bool isSerialSource READ isSerialSource WRITE setIsSerialSource NOTIFY isSerialSourceChanged)
 
+    // When true, starting a source keeps the others running and all of them
+    // feed one deduplicated state; the freshest copy of each frame wins
+    Q_PROPERTY(bool redundantMode READ redundantMode WRITE setRedundantMode NOTIFY redundantModeChanged)
+
 public:
     explicit CommunicationManager(QObject *parent = nullptr);
     ~CommunicationManager();
 
     // Property getters
-    float speed() const { return m_speed; }
-    int rpm() const { return m_rpm; }
-    int accPedal() const { return m_accPedal; }
-    int brakePedal() const { return m_brakePedal; }
-    double encoderAngle() const { return m_encoderAngle; }
-    float temperature() const { return m_temperature; }
-    int batteryLevel() const { return m_batteryLevel; }
-    double gpsLongitude() const { return m_gpsLongitude; }
-    double gpsLatitude() const { return m_gpsLatitude; }
-    int speedFL() const { return m_speedFL; }
-    int speedFR() const { return m_speedFR; }
-    int speedBL() const { return m_speedBL; }
-    int speedBR() const { return m_speedBR; }
-    double lateralG() const { return m_lateralG; }
-    double longitudinalG() const { return m_longitudinalG; }
-    int tempFL() const { return m_tempFL; }
-    int tempFR() const { return m_tempFR; }
-    int tempBL() const { return m_tempBL; }
-    int tempBR() const { return m_tempBR; }
+    TelemetrySnapshot snapshot() const { return m_snapshot; }
+    float speed() const { return m_snapshot.speed; }
+    int rpm() const { return m_snapshot.rpm; }
+    int accPedal() const { return m_snapshot.accPedal; }
+    int brakePedal() const { return m_snapshot.brakePedal; }
+    double encoderAngle() const { return m_snapshot.encoderAngle; }
+    float temperature() const { return m_snapshot.temperature; }
+    int batteryLevel() const { return m_snapshot.batteryLevel; }
+    double gpsLongitude() const { return m_snapshot.gpsLongitude; }
+    double gpsLatitude() const { return m_snapshot.gpsLatitude; }
+    int speedFL() const { return m_snapshot.speedFL; }
+    int speedFR() const { return m_snapshot.speedFR; }
+    int speedBL() const { return m_snapshot.speedBL; }
+    int speedBR() const { return m_snapshot.speedBR; }
+    double lateralG() const { return m_snapshot.lateralG; }
+    double longitudinalG() const { return m_snapshot.longitudinalG; }
+    int tempFL() const { return m_snapshot.tempFL; }
+    int tempFR() const { return m_snapshot.tempFR; }
+    int tempBL() const { return m_snapshot.tempBL; }
+    int tempBR() const { return m_snapshot.tempBR; }
 
     Q_INVOKABLE bool startSerial(const QString &portName, qint32 baudRate);
     Q_INVOKABLE bool startUdp(quint16 port);
     Q_INVOKABLE bool startMqtt(const QString &brokerAddress, quint16 port, bool useTls, const QString &clientId, const QString &username, const QString &password, const QString &topic);
     Q_INVOKABLE bool stop();
 
+    /**
+     * @brief Stop one source, leaving the others running
+     * @param source "serial", "udp" or "mqtt"
+     */
+    Q_INVOKABLE bool stopSource(const QString &source);
+
+    /**
+     * @brief Per-source ingest statistics since all sources were last stopped
+     *
+     * One map per source that delivered frames: source, received, accepted,
+     * duplicates, late, lossPercent (unique frames this source never delivered)
+     * and latencyMs (mean delay behind the fastest source).
+     */
+    Q_INVOKABLE QVariantList sourceStatistics() const;
+
+    /**
+     * @brief Configure publish filtering for one field
+     * @param field QML property name, e.g. "lateralG"
+     * @param deadband Minimum raw change before the field is republished
+     * @param resolution Display step the published value is rounded to (0 = none)
+     * @return False if @p field is unknown
+     */
+    Q_INVOKABLE bool setSignalFilter(const QString &field, double deadband, double resolution);
+
+    // Per-field notifications emitted and held back by the filter since startup
+    Q_INVOKABLE qulonglong notificationsEmitted() const { return m_filter.emittedCount(); }
+    Q_INVOKABLE qulonglong notificationsSuppressed() const { return m_filter.suppressedCount(); }
+
     bool isSerialSource() const { return m_isSerialSource; }
     void setIsSerialSource(bool isSerialSource);
 
+    bool redundantMode() const { return m_redundantMode; }
+    void setRedundantMode(bool redundantMode);
+
 signals:
+    void snapshotChanged(const TelemetrySnapshot &snapshot);
     void speedChanged(float newSpeed);
     void rpmChanged(int newRpm);
     void accPedalChanged(int newAccPedal);
@@ -91,105 +134,73 @@ signals:
     void tempBLChanged(int newTempBL);
     void tempBRChanged(int newTempBR);
     void isSerialSourceChanged(bool isSerialSource);
+    void redundantModeChanged(bool redundantMode);
     void errorOccurred(const QString &error);
 
+    // Emitted from a parser thread when m_state has unpublished changes
+    void updatePending(qint64 stateTimeNs);
+
 private slots:
-    void handleUdpSpeedChanged(float newSpeed);
-    void handleUdpRpmChanged(int newRpm);
-    void handleUdpAccPedalChanged(int newAccPedal);
-    void handleUdpBrakePedalChanged(int newBrakePedal);
-    void handleUdpEncoderAngleChanged(double newAngle);
-    void handleUdpTemperatureChanged(float newTemperature);
-    void handleUdpBatteryLevelChanged(int newBatteryLevel);
-    void handleUdpGpsLongitudeChanged(double newLongitude);
-    void handleUdpGpsLatitudeChanged(double newGpsLatitude);
-    void handleUdpSpeedFLChanged(int newSpeedFL);
-    void handleUdpSpeedFRChanged(int newSpeedFR);
-    void handleUdpSpeedBLChanged(int newSpeedBL);
-    void handleUdpSpeedBRChanged(int newSpeedBR);
-    void handleUdpLateralGChanged(double newLateralG);
-    void handleUdpLongitudinalGChanged(double newLongitudinalG);
-    void handleUdpTempFLChanged(int newTempFL);
-    void handleUdpTempFRChanged(int newTempFR);
-    void handleUdpTempBLChanged(int newTempBL);
-    void handleUdpTempBRChanged(int newTempBR);
     void handleUdpError(const QString &error);
-
-    void handleSerialSpeedChanged(float newSpeed);
-    void handleSerialRpmChanged(int newRpm);
-    void handleSerialAccPedalChanged(int newAccPedal);
-    void handleSerialBrakePedalChanged(int newBrakePedal);
-    void handleSerialEncoderAngleChanged(double newAngle);
-    void handleSerialTemperatureChanged(float newTemperature);
-    void handleSerialBatteryLevelChanged(int newBatteryLevel);
-    void handleSerialGpsLongitudeChanged(double newLongitude);
-    void handleSerialGpsLatitudeChanged(double newGpsLatitude);
-    void handleSerialSpeedFLChanged(int newSpeedFL);
-    void handleSerialSpeedFRChanged(int newSpeedFR);
-    void handleSerialSpeedBLChanged(int newSpeedBL);
-    void handleSerialSpeedBRChanged(int newSpeedBR);
-    void handleSerialLateralGChanged(double newLateralG);
-    void handleSerialLongitudinalGChanged(double newLongitudinalG);
-    void handleSerialTempFLChanged(int newTempFL);
-    void handleSerialTempFRChanged(int newTempFR);
-    void handleSerialTempBLChanged(int newTempBL);
-    void handleSerialTempBRChanged(int newTempBR);
     void handleSerialError(const QString &error);
-
-
-    void handleMqttSpeedChanged(float newSpeed);
-    void handleMqttRpmChanged(int newRpm);
-    void handleMqttAccPedalChanged(int newAccPedal);
-    void handleMqttBrakePedalChanged(int newBrakePedal);
-    void handleMqttEncoderAngleChanged(double newAngle);
-    void handleMqttTemperatureChanged(float newTemperature);
-    void handleMqttBatteryLevelChanged(int newBatteryLevel);
-    void handleMqttGpsLongitudeChanged(double newLongitude);
-    void handleMqttGpsLatitudeChanged(double newGpsLatitude);
-    void handleMqttSpeedFLChanged(int newSpeedFL);
-    void handleMqttSpeedFRChanged(int newSpeedFR);
-    void handleMqttSpeedBLChanged(int newSpeedBL);
-    void handleMqttSpeedBRChanged(int newSpeedBR);
-    void handleMqttLateralGChanged(double newLateralG);
-    void handleMqttLongitudinalGChanged(double newLongitudinalG);
-    void handleMqttTempFLChanged(int newTempFL);
-    void handleMqttTempFRChanged(int newTempFR);
-    void handleMqttTempBLChanged(int newTempBL);
-    void handleMqttTempBRChanged(int newTempBR);
     void handleMqttError(const QString &error);
 
+    /**
+     * @brief Publish the shared state; driven by FramePublisher::publish
+     */
+    void flushPendingUpdates();
+
 private:
+    // Index of each transport in m_deduplicator, and its bit in m_activeSources
+    enum class SourceType { Serial, Udp, Mqtt, Count };
 
+    // Store every transport writes into; declared before the transports are created
+    TelemetryState m_state;
+    FrameDeduplicator m_deduplicator;
 
     UdpClient *m_udpClient;
     SerialManager *m_serialManager;
     MqttClient *m_mqttClient;
 
+    quint32 m_activeSources;
+
+    static quint32 sourceBit(SourceType source) { return 1u << static_cast<int>(source); }
+    static QString sourceName(SourceType source);
+
+    /**
+     * @brief Prepare for starting @p source: stop it if running, and stop the
+     * other sources unless in redundant mode
+     */
+    void prepareStart(SourceType source);
+
+    /**
+     * @brief Mark @p source running (or not) and update isSerialSource
+     */
+    void setSourceActive(SourceType source, bool active);
+
+    /**
+     * @brief Arbitrate between links only when redundant mode runs several of
+     * @p sources; a single link must never have frames dropped or held back
+     */
+    void updateArbitration(quint32 sources);
+
+    bool stopTransport(SourceType source);
+
+    /**
+     * @brief Publish a merged snapshot of all running sources
+     *
+     * Values pass through m_filter first; per-field NOTIFY signals are emitted
+     * only for fields whose filtered value changed.
+     */
+    void applySnapshot(const TelemetrySnapshot &snapshot);
+
+    // Merged raw values, and last published (filtered) telemetry values
+    TelemetrySnapshot m_rawSnapshot;
+    TelemetrySnapshot m_snapshot;
+    SignalFilter m_filter;
 
-    enum class SourceType { None, Serial, Udp, Mqtt };
-    SourceType m_currentSource;
-
-    // Internal storage for properties
-    float m_speed;
-    int m_rpm;
-    int m_accPedal;
-    int m_brakePedal;
-    double m_encoderAngle;
-    float m_temperature;
-    int m_batteryLevel;
-    double m_gpsLongitude;
-    double m_gpsLatitude;
-    int m_speedFL;
-    int m_speedFR;
-    int m_speedBL;
-    int m_speedBR;
-    double m_lateralG;
-    double m_longitudinalG;
-    int m_tempFL;
-    int m_tempFR;
-    int m_tempBL;
-    int m_tempBR;
     bool m_isSerialSource;
+    bool m_redundantMode;
 
 };
 
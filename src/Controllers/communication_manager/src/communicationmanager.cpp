@@ -2,99 +2,39 @@
 #include "../../serial/include/serialmanager.h"
 #include "../../udp/include/udpclient.h"
 #include "../../mqtt/include/mqttclient.h"
+#include "../../telemetry/include/framepublisher.h"
 #include <QDebug>
+#include <QThread>
+#include <QtAlgorithms>
 
 CommunicationManager::CommunicationManager(QObject *parent)
     : QObject(parent),
+    // Room for every parser of every transport at the maximum thread count
+    m_state(static_cast<int>(SourceType::Count) * 2 * QThread::idealThreadCount()),
     m_udpClient(new UdpClient(this)),
     m_serialManager(new SerialManager(this)),
     m_mqttClient(new MqttClient(this)),
-    m_currentSource(SourceType::None),
-    m_speed(0.0f),
-    m_rpm(0),
-    m_accPedal(0),
-    m_brakePedal(0),
-    m_encoderAngle(0.0),
-    m_temperature(0.0f),
-    m_batteryLevel(0),
-    m_gpsLongitude(0.0),
-    m_gpsLatitude(0.0),
-    m_speedFL(0),
-    m_speedFR(0),
-    m_speedBL(0),
-    m_speedBR(0),
-    m_lateralG(0.0),
-    m_longitudinalG(0.0),
-    m_tempFL(0),
-    m_tempFR(0),
-    m_tempBL(0),
-    m_tempBR(0),
-    m_isSerialSource(false)
+    m_activeSources(0),
+    m_isSerialSource(false),
+    m_redundantMode(false)
 {
-    // Connect signals from UdpClient to CommunicationManager's slots
-    connect(m_udpClient, &UdpClient::speedChanged, this, &CommunicationManager::handleUdpSpeedChanged);
-    connect(m_udpClient, &UdpClient::rpmChanged, this, &CommunicationManager::handleUdpRpmChanged);
-    connect(m_udpClient, &UdpClient::accPedalChanged, this, &CommunicationManager::handleUdpAccPedalChanged);
-    connect(m_udpClient, &UdpClient::brakePedalChanged, this, &CommunicationManager::handleUdpBrakePedalChanged);
-    connect(m_udpClient, &UdpClient::encoderAngleChanged, this, &CommunicationManager::handleUdpEncoderAngleChanged);
-    connect(m_udpClient, &UdpClient::temperatureChanged, this, &CommunicationManager::handleUdpTemperatureChanged);
-    connect(m_udpClient, &UdpClient::batteryLevelChanged, this, &CommunicationManager::handleUdpBatteryLevelChanged);
-    connect(m_udpClient, &UdpClient::gpsLongitudeChanged, this, &CommunicationManager::handleUdpGpsLongitudeChanged);
-    connect(m_udpClient, &UdpClient::gpsLatitudeChanged, this, &CommunicationManager::handleUdpGpsLatitudeChanged);
-    connect(m_udpClient, &UdpClient::speedFLChanged, this, &CommunicationManager::handleUdpSpeedFLChanged);
-    connect(m_udpClient, &UdpClient::speedFRChanged, this, &CommunicationManager::handleUdpSpeedFRChanged);
-    connect(m_udpClient, &UdpClient::speedBLChanged, this, &CommunicationManager::handleUdpSpeedBLChanged);
-    connect(m_udpClient, &UdpClient::speedBRChanged, this, &CommunicationManager::handleUdpSpeedBRChanged);
-    connect(m_udpClient, &UdpClient::lateralGChanged, this, &CommunicationManager::handleUdpLateralGChanged);
-    connect(m_udpClient, &UdpClient::longitudinalGChanged, this, &CommunicationManager::handleUdpLongitudinalGChanged);
-    connect(m_udpClient, &UdpClient::tempFLChanged, this, &CommunicationManager::handleUdpTempFLChanged);
-    connect(m_udpClient, &UdpClient::tempFRChanged, this, &CommunicationManager::handleUdpTempFRChanged);
-    connect(m_udpClient, &UdpClient::tempBLChanged, this, &CommunicationManager::handleUdpTempBLChanged);
-    connect(m_udpClient, &UdpClient::tempBRChanged, this, &CommunicationManager::handleUdpTempBRChanged);
-    connect(m_udpClient, &UdpClient::errorOccurred, this, &CommunicationManager::handleUdpError);
+    // All transports write into one store; frames received over several links
+    // are arbitrated by m_deduplicator so each one is applied once. It stays
+    // disabled unless redundant mode runs more than one link
+    m_udpClient->setIngest(&m_state, &m_deduplicator, static_cast<int>(SourceType::Udp));
+    m_serialManager->setIngest(&m_state, &m_deduplicator, static_cast<int>(SourceType::Serial));
+    m_mqttClient->setIngest(&m_state, &m_deduplicator, static_cast<int>(SourceType::Mqtt));
 
-    // Connect signals from SerialManager to CommunicationManager's slots
-    connect(m_serialManager, &SerialManager::speedChanged, this, &CommunicationManager::handleSerialSpeedChanged);
-    connect(m_serialManager, &SerialManager::rpmChanged, this, &CommunicationManager::handleSerialRpmChanged);
-    connect(m_serialManager, &SerialManager::accPedalChanged, this, &CommunicationManager::handleSerialAccPedalChanged);
-    connect(m_serialManager, &SerialManager::brakePedalChanged, this, &CommunicationManager::handleSerialBrakePedalChanged);
-    connect(m_serialManager, &SerialManager::encoderAngleChanged, this, &CommunicationManager::handleSerialEncoderAngleChanged);
-    connect(m_serialManager, &SerialManager::temperatureChanged, this, &CommunicationManager::handleSerialTemperatureChanged);
-    connect(m_serialManager, &SerialManager::batteryLevelChanged, this, &CommunicationManager::handleSerialBatteryLevelChanged);
-    connect(m_serialManager, &SerialManager::gpsLongitudeChanged, this, &CommunicationManager::handleSerialGpsLongitudeChanged);
-    connect(m_serialManager, &SerialManager::gpsLatitudeChanged, this, &CommunicationManager::handleSerialGpsLatitudeChanged);
-    connect(m_serialManager, &SerialManager::speedFLChanged, this, &CommunicationManager::handleSerialSpeedFLChanged);
-    connect(m_serialManager, &SerialManager::speedFRChanged, this, &CommunicationManager::handleSerialSpeedFRChanged);
-    connect(m_serialManager, &SerialManager::speedBLChanged, this, &CommunicationManager::handleSerialSpeedBLChanged);
-    connect(m_serialManager, &SerialManager::speedBRChanged, this, &CommunicationManager::handleSerialSpeedBRChanged);
-    connect(m_serialManager, &SerialManager::lateralGChanged, this, &CommunicationManager::handleSerialLateralGChanged);
-    connect(m_serialManager, &SerialManager::longitudinalGChanged, this, &CommunicationManager::handleSerialLongitudinalGChanged);
-    connect(m_serialManager, &SerialManager::tempFLChanged, this, &CommunicationManager::handleSerialTempFLChanged);
-    connect(m_serialManager, &SerialManager::tempFRChanged, this, &CommunicationManager::handleSerialTempFRChanged);
-    connect(m_serialManager, &SerialManager::tempBLChanged, this, &CommunicationManager::handleSerialTempBLChanged);
-    connect(m_serialManager, &SerialManager::tempBRChanged, this, &CommunicationManager::handleSerialTempBRChanged);
+    connect(m_udpClient, &UdpClient::errorOccurred, this, &CommunicationManager::handleUdpError);
     connect(m_serialManager, &SerialManager::errorOccurred, this, &CommunicationManager::handleSerialError);
-
-    connect(m_mqttClient, &MqttClient::speedChanged, this, &CommunicationManager::handleMqttSpeedChanged);
-    connect(m_mqttClient, &MqttClient::rpmChanged, this, &CommunicationManager::handleMqttRpmChanged);
-    connect(m_mqttClient, &MqttClient::accPedalChanged, this, &CommunicationManager::handleMqttAccPedalChanged);
-    connect(m_mqttClient, &MqttClient::brakePedalChanged, this, &CommunicationManager::handleMqttBrakePedalChanged);
-    connect(m_mqttClient, &MqttClient::encoderAngleChanged, this, &CommunicationManager::handleMqttEncoderAngleChanged);
-    connect(m_mqttClient, &MqttClient::temperatureChanged, this, &CommunicationManager::handleMqttTemperatureChanged);
-    connect(m_mqttClient, &MqttClient::batteryLevelChanged, this, &CommunicationManager::handleMqttBatteryLevelChanged);
-    connect(m_mqttClient, &MqttClient::gpsLongitudeChanged, this, &CommunicationManager::handleMqttGpsLongitudeChanged);
-    connect(m_mqttClient, &MqttClient::gpsLatitudeChanged, this, &CommunicationManager::handleMqttGpsLatitudeChanged);
-    connect(m_mqttClient, &MqttClient::speedFLChanged, this, &CommunicationManager::handleMqttSpeedFLChanged);
-    connect(m_mqttClient, &MqttClient::speedFRChanged, this, &CommunicationManager::handleMqttSpeedFRChanged);
-    connect(m_mqttClient, &MqttClient::speedBLChanged, this, &CommunicationManager::handleMqttSpeedBLChanged);
-    connect(m_mqttClient, &MqttClient::speedBRChanged, this, &CommunicationManager::handleMqttSpeedBRChanged);
-    connect(m_mqttClient, &MqttClient::lateralGChanged, this, &CommunicationManager::handleMqttLateralGChanged);
-    connect(m_mqttClient, &MqttClient::longitudinalGChanged, this, &CommunicationManager::handleMqttLongitudinalGChanged);
-    connect(m_mqttClient, &MqttClient::tempFLChanged, this, &CommunicationManager::handleMqttTempFLChanged);
-    connect(m_mqttClient, &MqttClient::tempFRChanged, this, &CommunicationManager::handleMqttTempFRChanged);
-    connect(m_mqttClient, &MqttClient::tempBLChanged, this, &CommunicationManager::handleMqttTempBLChanged);
-    connect(m_mqttClient, &MqttClient::tempBRChanged, this, &CommunicationManager::handleMqttTempBRChanged);
     connect(m_mqttClient, &MqttClient::errorOccurred, this, &CommunicationManager::handleMqttError);
+
+    // Publish the merged state once per rendered frame
+    m_state.setUpdateNotifier([this](std::int64_t stateTimeNs) {
+        emit updatePending(stateTimeNs);
+    });
+    connect(this, &CommunicationManager::updatePending, &FramePublisher::instance(), &FramePublisher::requestFrame, Qt::QueuedConnection);
+    connect(&FramePublisher::instance(), &FramePublisher::publish, this, &CommunicationManager::flushPendingUpdates);
 }
 
 CommunicationManager::~CommunicationManager()
@@ -104,12 +44,11 @@ CommunicationManager::~CommunicationManager()
 
 bool CommunicationManager::startSerial(const QString &portName, qint32 baudRate)
 {
-    stop(); // Stop any active communication first
+    prepareStart(SourceType::Serial);
     bool success = m_serialManager->start(portName, baudRate);
     if (success)
     {
-        m_currentSource = SourceType::Serial;
-        setIsSerialSource(true);
+        setSourceActive(SourceType::Serial, true);
         qDebug() << "CommunicationManager: Serial started.";
     }
     else
@@ -121,12 +60,11 @@ bool CommunicationManager::startSerial(const QString &portName, qint32 baudRate)
 
 bool CommunicationManager::startUdp(quint16 port)
 {
-    stop(); // Stop any active communication first
+    prepareStart(SourceType::Udp);
     bool success = m_udpClient->start(port);
     if (success)
     {
-        m_currentSource = SourceType::Udp;
-        setIsSerialSource(false);
+        setSourceActive(SourceType::Udp, true);
         qDebug() << "CommunicationManager: UDP started.";
     }
     else
@@ -138,12 +76,11 @@ bool CommunicationManager::startUdp(quint16 port)
 
 bool CommunicationManager::startMqtt(const QString &brokerAddress, quint16 port, bool useTls, const QString &clientId, const QString &username, const QString &password, const QString &topic)
 {
-    stop(); // Stop any active communication first
+    prepareStart(SourceType::Mqtt);
     bool success = m_mqttClient->start(brokerAddress, port, useTls, clientId, username, password, topic);
     if (success)
     {
-        m_currentSource = SourceType::Mqtt;
-        setIsSerialSource(false);
+        setSourceActive(SourceType::Mqtt, true);
         qDebug() << "CommunicationManager: MQTT started.";
     }
     else
@@ -156,729 +93,269 @@ bool CommunicationManager::startMqtt(const QString &brokerAddress, quint16 port,
 bool CommunicationManager::stop()
 {
     bool success = false;
-    if (m_currentSource == SourceType::Serial)
-    {
-        success = m_serialManager->stop();
-        qDebug() << "CommunicationManager: Serial stopped.";
-    }
-    else if (m_currentSource == SourceType::Udp)
-    {
-        success = m_udpClient->stop();
-        qDebug() << "CommunicationManager: UDP stopped.";
-    }
-    else if (m_currentSource == SourceType::Mqtt)
-    {
-        success = m_mqttClient->stop();
-        qDebug() << "CommunicationManager: MQTT stopped.";
-    }
-    m_currentSource = SourceType::None;
-    return success;
-}
-
-void CommunicationManager::setIsSerialSource(bool isSerialSource)
-{
-    if (m_isSerialSource != isSerialSource)
-    {
-        m_isSerialSource = isSerialSource;
-        emit isSerialSourceChanged(m_isSerialSource);
-    }
-}
-
-void CommunicationManager::handleUdpError(const QString &error)
-{
-    emit errorOccurred(error);
-}
-
-void CommunicationManager::handleSerialError(const QString &error)
-{
-    emit errorOccurred(error);
-}
-
-void CommunicationManager::handleMqttError(const QString &error)
-{
-    emit errorOccurred(error);
-}
-
-void CommunicationManager::handleUdpSpeedChanged(float newSpeed)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_speed != newSpeed)
-        {
-            m_speed = newSpeed;
-            emit speedChanged(m_speed);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpRpmChanged(int newRpm)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_rpm != newRpm)
-        {
-            m_rpm = newRpm;
-            emit rpmChanged(m_rpm);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpAccPedalChanged(int newAccPedal)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_accPedal != newAccPedal)
-        {
-            m_accPedal = newAccPedal;
-            emit accPedalChanged(m_accPedal);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpBrakePedalChanged(int newBrakePedal)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_brakePedal != newBrakePedal)
-        {
-            m_brakePedal = newBrakePedal;
-            emit brakePedalChanged(m_brakePedal);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpEncoderAngleChanged(double newAngle)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_encoderAngle != newAngle)
-        {
-            m_encoderAngle = newAngle;
-            emit encoderAngleChanged(m_encoderAngle);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpTemperatureChanged(float newTemperature)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_temperature != newTemperature)
-        {
-            m_temperature = newTemperature;
-            emit temperatureChanged(m_temperature);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpBatteryLevelChanged(int newBatteryLevel)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_batteryLevel != newBatteryLevel)
-        {
-            m_batteryLevel = newBatteryLevel;
-            emit batteryLevelChanged(m_batteryLevel);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpGpsLongitudeChanged(double newLongitude)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_gpsLongitude != newLongitude)
-        {
-            m_gpsLongitude = newLongitude;
-            emit gpsLongitudeChanged(m_gpsLongitude);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpGpsLatitudeChanged(double newGpsLatitude)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_gpsLatitude != newGpsLatitude)
-        {
-            m_gpsLatitude = newGpsLatitude;
-            emit gpsLatitudeChanged(m_gpsLatitude);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpSpeedFLChanged(int newSpeedFL)
-{
-    if (m_currentSource == SourceType::Udp)
+    for (SourceType source : {SourceType::Serial, SourceType::Udp, SourceType::Mqtt})
     {
-        if (m_speedFL != newSpeedFL)
+        if (m_activeSources & sourceBit(source))
         {
-            m_speedFL = newSpeedFL;
-            emit speedFLChanged(m_speedFL);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpSpeedFRChanged(int newSpeedFR)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_speedFR != newSpeedFR)
-        {
-            m_speedFR = newSpeedFR;
-            emit speedFRChanged(m_speedFR);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpSpeedBLChanged(int newSpeedBL)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_speedBL != newSpeedBL)
-        {
-            m_speedBL = newSpeedBL;
-            emit speedBLChanged(m_speedBL);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpSpeedBRChanged(int newSpeedBR)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_speedBR != newSpeedBR)
-        {
-            m_speedBR = newSpeedBR;
-            emit speedBRChanged(m_speedBR);
+            success = stopTransport(source) || success;
         }
     }
+    return success;
 }
 
-void CommunicationManager::handleUdpLateralGChanged(double newLateralG)
+bool CommunicationManager::stopSource(const QString &source)
 {
-    if (m_currentSource == SourceType::Udp)
+    for (SourceType type : {SourceType::Serial, SourceType::Udp, SourceType::Mqtt})
     {
-        if (m_lateralG != newLateralG)
+        if (source.compare(sourceName(type), Qt::CaseInsensitive) == 0)
         {
-            m_lateralG = newLateralG;
-            emit lateralGChanged(m_lateralG);
+            return (m_activeSources & sourceBit(type)) ? stopTransport(type) : false;
         }
     }
+    qWarning() << "CommunicationManager: Unknown source:" << source;
+    return false;
 }
 
-void CommunicationManager::handleUdpLongitudinalGChanged(double newLongitudinalG)
+QVariantList CommunicationManager::sourceStatistics() const
 {
-    if (m_currentSource == SourceType::Udp)
+    QVariantList list;
+    for (SourceType source : {SourceType::Serial, SourceType::Udp, SourceType::Mqtt})
     {
-        if (m_longitudinalG != newLongitudinalG)
+        const FrameDeduplicator::SourceStats stats = m_deduplicator.stats(static_cast<int>(source));
+        if (stats.received == 0)
         {
-            m_longitudinalG = newLongitudinalG;
-            emit longitudinalGChanged(m_longitudinalG);
+            continue;
         }
-    }
-}
 
-void CommunicationManager::handleUdpTempFLChanged(int newTempFL)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_tempFL != newTempFL)
-        {
-            m_tempFL = newTempFL;
-            emit tempFLChanged(m_tempFL);
-        }
+        QVariantMap entry;
+        entry["source"] = sourceName(source);
+        entry["received"] = static_cast<qulonglong>(stats.received);
+        entry["accepted"] = static_cast<qulonglong>(stats.accepted);
+        entry["duplicates"] = static_cast<qulonglong>(stats.duplicates);
+        entry["late"] = static_cast<qulonglong>(stats.late);
+        entry["lossPercent"] = stats.lossRatio * 100.0;
+        entry["latencyMs"] = stats.latencyMs;
+        list.append(entry);
     }
+    return list;
 }
 
-void CommunicationManager::handleUdpTempFRChanged(int newTempFR)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_tempFR != newTempFR)
-        {
-            m_tempFR = newTempFR;
-            emit tempFRChanged(m_tempFR);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpTempBLChanged(int newTempBL)
-{
-    if (m_currentSource == SourceType::Udp)
-    {
-        if (m_tempBL != newTempBL)
-        {
-            m_tempBL = newTempBL;
-            emit tempBLChanged(m_tempBL);
-        }
-    }
-}
-
-void CommunicationManager::handleUdpTempBRChanged(int newTempBR)
+void CommunicationManager::setIsSerialSource(bool isSerialSource)
 {
-    if (m_currentSource == SourceType::Udp)
+    if (m_isSerialSource != isSerialSource)
     {
-        if (m_tempBR != newTempBR)
-        {
-            m_tempBR = newTempBR;
-            emit tempBRChanged(m_tempBR);
-        }
+        m_isSerialSource = isSerialSource;
+        emit isSerialSourceChanged(m_isSerialSource);
     }
 }
 
-void CommunicationManager::handleSerialSpeedChanged(float newSpeed)
+void CommunicationManager::setRedundantMode(bool redundantMode)
 {
-    if (m_currentSource == SourceType::Serial)
+    if (m_redundantMode != redundantMode)
     {
-        if (m_speed != newSpeed)
-        {
-            m_speed = newSpeed;
-            emit speedChanged(m_speed);
-        }
+        m_redundantMode = redundantMode;
+        updateArbitration(m_activeSources);
+        emit redundantModeChanged(m_redundantMode);
     }
 }
 
-void CommunicationManager::handleSerialRpmChanged(int newRpm)
+QString CommunicationManager::sourceName(SourceType source)
 {
-    if (m_currentSource == SourceType::Serial)
+    switch (source)
     {
-        if (m_rpm != newRpm)
-        {
-            m_rpm = newRpm;
-            emit rpmChanged(m_rpm);
-        }
+    case SourceType::Serial: return QStringLiteral("serial");
+    case SourceType::Udp: return QStringLiteral("udp");
+    case SourceType::Mqtt: return QStringLiteral("mqtt");
+    case SourceType::Count: break;
     }
+    return QString();
 }
 
-void CommunicationManager::handleSerialAccPedalChanged(int newAccPedal)
+void CommunicationManager::prepareStart(SourceType source)
 {
-    if (m_currentSource == SourceType::Serial)
+    if (!m_redundantMode)
     {
-        if (m_accPedal != newAccPedal)
-        {
-            m_accPedal = newAccPedal;
-            emit accPedalChanged(m_accPedal);
-        }
+        stop(); // Stop any active communication first
     }
-}
-
-void CommunicationManager::handleSerialBrakePedalChanged(int newBrakePedal)
-{
-    if (m_currentSource == SourceType::Serial)
+    else if (m_activeSources & sourceBit(source))
     {
-        if (m_brakePedal != newBrakePedal)
-        {
-            m_brakePedal = newBrakePedal;
-            emit brakePedalChanged(m_brakePedal);
-        }
+        stopTransport(source); // Restart just this one
     }
-}
 
-void CommunicationManager::handleSerialEncoderAngleChanged(double newAngle)
-{
-    if (m_currentSource == SourceType::Serial)
-    {
-        if (m_encoderAngle != newAngle)
-        {
-            m_encoderAngle = newAngle;
-            emit encoderAngleChanged(m_encoderAngle);
-        }
-    }
+    // Arbitrate from the new link's first frame; undone if it fails to start
+    updateArbitration(m_activeSources | sourceBit(source));
 }
 
-void CommunicationManager::handleSerialTemperatureChanged(float newTemperature)
+void CommunicationManager::setSourceActive(SourceType source, bool active)
 {
-    if (m_currentSource == SourceType::Serial)
+    if (active)
     {
-        if (m_temperature != newTemperature)
-        {
-            m_temperature = newTemperature;
-            emit temperatureChanged(m_temperature);
-        }
+        m_activeSources |= sourceBit(source);
     }
-}
-
-void CommunicationManager::handleSerialBatteryLevelChanged(int newBatteryLevel)
-{
-    if (m_currentSource == SourceType::Serial)
+    else
     {
-        if (m_batteryLevel != newBatteryLevel)
-        {
-            m_batteryLevel = newBatteryLevel;
-            emit batteryLevelChanged(m_batteryLevel);
-        }
+        m_activeSources &= ~sourceBit(source);
     }
+    updateArbitration(m_activeSources);
+    setIsSerialSource(m_activeSources & sourceBit(SourceType::Serial));
 }
 
-void CommunicationManager::handleSerialGpsLongitudeChanged(double newLongitude)
+void CommunicationManager::updateArbitration(quint32 sources)
 {
-    if (m_currentSource == SourceType::Serial)
-    {
-        if (m_gpsLongitude != newLongitude)
-        {
-            m_gpsLongitude = newLongitude;
-            emit gpsLongitudeChanged(m_gpsLongitude);
-        }
-    }
+    m_deduplicator.setEnabled(m_redundantMode && qPopulationCount(sources) > 1);
 }
 
-void CommunicationManager::handleSerialGpsLatitudeChanged(double newGpsLatitude)
+bool CommunicationManager::stopTransport(SourceType source)
 {
-    if (m_currentSource == SourceType::Serial)
+    bool success = false;
+    if (source == SourceType::Serial)
     {
-        if (m_gpsLatitude != newGpsLatitude)
-        {
-            m_gpsLatitude = newGpsLatitude;
-            emit gpsLatitudeChanged(m_gpsLatitude);
-        }
+        success = m_serialManager->stop();
+        qDebug() << "CommunicationManager: Serial stopped.";
     }
-}
-
-void CommunicationManager::handleSerialSpeedFLChanged(int newSpeedFL)
-{
-    if (m_currentSource == SourceType::Serial)
+    else if (source == SourceType::Udp)
     {
-        if (m_speedFL != newSpeedFL)
-        {
-            m_speedFL = newSpeedFL;
-            emit speedFLChanged(m_speedFL);
-        }
+        success = m_udpClient->stop();
+        qDebug() << "CommunicationManager: UDP stopped.";
     }
-}
-
-void CommunicationManager::handleSerialSpeedFRChanged(int newSpeedFR)
-{
-    if (m_currentSource == SourceType::Serial)
+    else if (source == SourceType::Mqtt)
     {
-        if (m_speedFR != newSpeedFR)
-        {
-            m_speedFR = newSpeedFR;
-            emit speedFRChanged(m_speedFR);
-        }
+        success = m_mqttClient->stop();
+        qDebug() << "CommunicationManager: MQTT stopped.";
     }
-}
+    setSourceActive(source, false);
 
-void CommunicationManager::handleSerialSpeedBLChanged(int newSpeedBL)
-{
-    if (m_currentSource == SourceType::Serial)
+    // With nothing running, start the next session from a clean store; device
+    // timestamps may restart, so the dedupe window is cleared too
+    if (m_activeSources == 0)
     {
-        if (m_speedBL != newSpeedBL)
-        {
-            m_speedBL = newSpeedBL;
-            emit speedBLChanged(m_speedBL);
-        }
+        m_state.reset();
+        m_deduplicator.reset();
     }
+    return success;
 }
 
-void CommunicationManager::handleSerialSpeedBRChanged(int newSpeedBR)
+bool CommunicationManager::setSignalFilter(const QString &field, double deadband, double resolution)
 {
-    if (m_currentSource == SourceType::Serial)
+    SignalFilter::Field id;
+    if (!SignalFilter::fieldFromName(field, id))
     {
-        if (m_speedBR != newSpeedBR)
-        {
-            m_speedBR = newSpeedBR;
-            emit speedBRChanged(m_speedBR);
-        }
+        qWarning() << "CommunicationManager: Unknown signal for filter:" << field;
+        return false;
     }
-}
 
-void CommunicationManager::handleSerialLateralGChanged(double newLateralG)
-{
-    if (m_currentSource == SourceType::Serial)
-    {
-        if (m_lateralG != newLateralG)
-        {
-            m_lateralG = newLateralG;
-            emit lateralGChanged(m_lateralG);
-        }
-    }
+    m_filter.setSettings(id, {deadband, resolution});
+    return true;
 }
 
-void CommunicationManager::handleSerialLongitudinalGChanged(double newLongitudinalG)
+void CommunicationManager::handleUdpError(const QString &error)
 {
-    if (m_currentSource == SourceType::Serial)
-    {
-        if (m_longitudinalG != newLongitudinalG)
-        {
-            m_longitudinalG = newLongitudinalG;
-            emit longitudinalGChanged(m_longitudinalG);
-        }
-    }
+    emit errorOccurred(error);
 }
 
-void CommunicationManager::handleSerialTempFLChanged(int newTempFL)
+void CommunicationManager::handleSerialError(const QString &error)
 {
-    if (m_currentSource == SourceType::Serial)
-    {
-        if (m_tempFL != newTempFL)
-        {
-            m_tempFL = newTempFL;
-            emit tempFLChanged(m_tempFL);
-        }
-    }
+    emit errorOccurred(error);
 }
 
-void CommunicationManager::handleSerialTempFRChanged(int newTempFR)
+void CommunicationManager::handleMqttError(const QString &error)
 {
-    if (m_currentSource == SourceType::Serial)
-    {
-        if (m_tempFR != newTempFR)
-        {
-            m_tempFR = newTempFR;
-            emit tempFRChanged(m_tempFR);
-        }
-    }
+    emit errorOccurred(error);
 }
 
-void CommunicationManager::handleSerialTempBLChanged(int newTempBL)
+void CommunicationManager::flushPendingUpdates()
 {
-    if (m_currentSource == SourceType::Serial)
+    if (!m_state.takeSnapshot(m_rawSnapshot))
     {
-        if (m_tempBL != newTempBL)
-        {
-            m_tempBL = newTempBL;
-            emit tempBLChanged(m_tempBL);
-        }
+        return; // No updates pending
     }
+    applySnapshot(m_rawSnapshot);
 }
 
-void CommunicationManager::handleSerialTempBRChanged(int newTempBR)
+void CommunicationManager::applySnapshot(const TelemetrySnapshot &snapshot)
 {
-    if (m_currentSource == SourceType::Serial)
+    const quint32 changed = m_filter.apply(snapshot, m_snapshot);
+    if (changed == 0)
     {
-        if (m_tempBR != newTempBR)
-        {
-            m_tempBR = newTempBR;
-            emit tempBRChanged(m_tempBR);
-        }
+        return; // Nothing visible changed
     }
-}
+    emit snapshotChanged(m_snapshot);
 
-void CommunicationManager::handleMqttSpeedChanged(float newSpeed)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    // Keep per-field notifications for existing bindings, but only for fields that changed
+    if (changed & SignalFilter::fieldBit(SignalFilter::Speed))
     {
-        if (m_speed != newSpeed)
-        {
-            m_speed = newSpeed;
-            emit speedChanged(m_speed);
-        }
+        emit speedChanged(m_snapshot.speed);
     }
-}
-
-void CommunicationManager::handleMqttRpmChanged(int newRpm)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::Rpm))
     {
-        if (m_rpm != newRpm)
-        {
-            m_rpm = newRpm;
-            emit rpmChanged(m_rpm);
-        }
+        emit rpmChanged(m_snapshot.rpm);
     }
-}
-
-void CommunicationManager::handleMqttAccPedalChanged(int newAccPedal)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::AccPedal))
     {
-        if (m_accPedal != newAccPedal)
-        {
-            m_accPedal = newAccPedal;
-            emit accPedalChanged(m_accPedal);
-        }
+        emit accPedalChanged(m_snapshot.accPedal);
     }
-}
-
-void CommunicationManager::handleMqttBrakePedalChanged(int newBrakePedal)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::BrakePedal))
     {
-        if (m_brakePedal != newBrakePedal)
-        {
-            m_brakePedal = newBrakePedal;
-            emit brakePedalChanged(m_brakePedal);
-        }
+        emit brakePedalChanged(m_snapshot.brakePedal);
     }
-}
-
-void CommunicationManager::handleMqttEncoderAngleChanged(double newAngle)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::EncoderAngle))
     {
-        if (m_encoderAngle != newAngle)
-        {
-            m_encoderAngle = newAngle;
-            emit encoderAngleChanged(m_encoderAngle);
-        }
+        emit encoderAngleChanged(m_snapshot.encoderAngle);
     }
-}
-
-void CommunicationManager::handleMqttTemperatureChanged(float newTemperature)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::Temperature))
     {
-        if (m_temperature != newTemperature)
-        {
-            m_temperature = newTemperature;
-            emit temperatureChanged(m_temperature);
-        }
+        emit temperatureChanged(m_snapshot.temperature);
     }
-}
-
-void CommunicationManager::handleMqttBatteryLevelChanged(int newBatteryLevel)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::BatteryLevel))
     {
-        if (m_batteryLevel != newBatteryLevel)
-        {
-            m_batteryLevel = newBatteryLevel;
-            emit batteryLevelChanged(m_batteryLevel);
-        }
+        emit batteryLevelChanged(m_snapshot.batteryLevel);
     }
-}
-
-void CommunicationManager::handleMqttGpsLongitudeChanged(double newLongitude)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::GpsLongitude))
     {
-        if (m_gpsLongitude != newLongitude)
-        {
-            m_gpsLongitude = newLongitude;
-            emit gpsLongitudeChanged(m_gpsLongitude);
-        }
+        emit gpsLongitudeChanged(m_snapshot.gpsLongitude);
     }
-}
-
-void CommunicationManager::handleMqttGpsLatitudeChanged(double newGpsLatitude)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::GpsLatitude))
     {
-        if (m_gpsLatitude != newGpsLatitude)
-        {
-            m_gpsLatitude = newGpsLatitude;
-            emit gpsLatitudeChanged(m_gpsLatitude);
-        }
+        emit gpsLatitudeChanged(m_snapshot.gpsLatitude);
     }
-}
-
-void CommunicationManager::handleMqttSpeedFLChanged(int newSpeedFL)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::SpeedFL))
     {
-        if (m_speedFL != newSpeedFL)
-        {
-            m_speedFL = newSpeedFL;
-            emit speedFLChanged(m_speedFL);
-        }
+        emit speedFLChanged(m_snapshot.speedFL);
     }
-}
-
-void CommunicationManager::handleMqttSpeedFRChanged(int newSpeedFR)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::SpeedFR))
     {
-        if (m_speedFR != newSpeedFR)
-        {
-            m_speedFR = newSpeedFR;
-            emit speedFRChanged(m_speedFR);
-        }
+        emit speedFRChanged(m_snapshot.speedFR);
     }
-}
-
-void CommunicationManager::handleMqttSpeedBLChanged(int newSpeedBL)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::SpeedBL))
     {
-        if (m_speedBL != newSpeedBL)
-        {
-            m_speedBL = newSpeedBL;
-            emit speedBLChanged(m_speedBL);
-        }
+        emit speedBLChanged(m_snapshot.speedBL);
     }
-}
-
-void CommunicationManager::handleMqttSpeedBRChanged(int newSpeedBR)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::SpeedBR))
     {
-        if (m_speedBR != newSpeedBR)
-        {
-            m_speedBR = newSpeedBR;
-            emit speedBRChanged(m_speedBR);
-        }
+        emit speedBRChanged(m_snapshot.speedBR);
     }
-}
-
-void CommunicationManager::handleMqttLateralGChanged(double newLateralG)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::LateralG))
     {
-        if (m_lateralG != newLateralG)
-        {
-            m_lateralG = newLateralG;
-            emit lateralGChanged(m_lateralG);
-        }
+        emit lateralGChanged(m_snapshot.lateralG);
     }
-}
-
-void CommunicationManager::handleMqttLongitudinalGChanged(double newLongitudinalG)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::LongitudinalG))
     {
-        if (m_longitudinalG != newLongitudinalG)
-        {
-            m_longitudinalG = newLongitudinalG;
-            emit longitudinalGChanged(m_longitudinalG);
-        }
+        emit longitudinalGChanged(m_snapshot.longitudinalG);
     }
-}
-
-void CommunicationManager::handleMqttTempFLChanged(int newTempFL)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::TempFL))
     {
-        if (m_tempFL != newTempFL)
-        {
-            m_tempFL = newTempFL;
-            emit tempFLChanged(m_tempFL);
-        }
+        emit tempFLChanged(m_snapshot.tempFL);
     }
-}
-
-void CommunicationManager::handleMqttTempFRChanged(int newTempFR)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::TempFR))
     {
-        if (m_tempFR != newTempFR)
-        {
-            m_tempFR = newTempFR;
-            emit tempFRChanged(m_tempFR);
-        }
+        emit tempFRChanged(m_snapshot.tempFR);
     }
-}
-
-void CommunicationManager::handleMqttTempBLChanged(int newTempBL)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::TempBL))
     {
-        if (m_tempBL != newTempBL)
-        {
-            m_tempBL = newTempBL;
-            emit tempBLChanged(m_tempBL);
-        }
+        emit tempBLChanged(m_snapshot.tempBL);
     }
-}
-
-void CommunicationManager::handleMqttTempBRChanged(int newTempBR)
-{
-    if (m_currentSource == SourceType::Mqtt)
+    if (changed & SignalFilter::fieldBit(SignalFilter::TempBR))
     {
-        if (m_tempBR != newTempBR)
-        {
-            m_tempBR = newTempBR;
-            emit tempBRChanged(m_tempBR);
-        }
+        emit tempBRChanged(m_snapshot.tempBR);
     }
 }
@@ -0,0 +1,68 @@
+#ifndef HEADLESSRECORDER_H
+#define HEADLESSRECORDER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTimer>
+#include "../../telemetry/include/framededuplicator.h"
+#include "../../telemetry/include/telemetrystate.h"
+
+// Forward declarations
+class UdpClient;
+class SerialManager;
+
+/**
+ * @brief Ingest and logging without any GUI, for the pit server
+ *
+ * Runs the UDP and/or serial transport with their CAN parsers and the
+ * AsyncLogger, and prints a stats line at a fixed interval. Parsed values go
+ * into a state store nobody publishes, so no frame pacing or QML work is done.
+ */
+class HeadlessRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        quint16 udpPort = 0;         // 0 = UDP disabled
+        QString serialPort;          // Empty = serial disabled
+        qint32 baudRate = 115200;
+        int statsIntervalMs = 1000;  // 0 = no stats line
+        bool debugMode = false;
+    };
+
+    explicit HeadlessRecorder(const Options &options, QObject *parent = nullptr);
+    ~HeadlessRecorder();
+
+    /**
+     * @brief Start every configured transport
+     * @return False if none is configured or one failed to start
+     */
+    bool start();
+
+    void stop();
+
+private slots:
+    void printStats();
+
+private:
+    enum SourceId { UdpSource, SerialSource };
+
+    // Declared before the transports so it outlives their parser pools
+    TelemetryState m_state;
+    FrameDeduplicator m_deduplicator;
+
+    Options m_options;
+    UdpClient *m_udpClient;
+    SerialManager *m_serialManager;
+
+    QTimer m_statsTimer;
+    QElapsedTimer m_uptime;
+    qint64 m_lastStatsMs;
+    qint64 m_lastUdpFrames;
+    qint64 m_lastSerialFrames;
+    quint64 m_lastLogged;
+};
+
+#endif // HEADLESSRECORDER_H
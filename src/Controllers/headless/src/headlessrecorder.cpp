@@ -0,0 +1,147 @@
+#include "../include/headlessrecorder.h"
+#include "../../udp/include/udpclient.h"
+#include "../../serial/include/serialmanager.h"
+#include "../../logging/include/asynclogger.h"
+#include <QDebug>
+#include <QThread>
+
+HeadlessRecorder::HeadlessRecorder(const Options &options, QObject *parent)
+    : QObject(parent),
+    // Room for the parsers of both transports at the maximum thread count
+    m_state(2 * QThread::idealThreadCount()),
+    m_options(options),
+    m_udpClient(nullptr),
+    m_serialManager(nullptr),
+    m_lastStatsMs(0),
+    m_lastUdpFrames(0),
+    m_lastSerialFrames(0),
+    m_lastLogged(0)
+{
+    // Only the transports actually used are created; each one initializes the logger
+    if (m_options.udpPort != 0)
+    {
+        m_udpClient = new UdpClient(this);
+        m_udpClient->setDebugMode(m_options.debugMode);
+        m_udpClient->setIngest(&m_state, &m_deduplicator, UdpSource);
+        connect(m_udpClient, &UdpClient::errorOccurred, this, [](const QString &error) {
+            qWarning().noquote() << "UDP:" << error;
+        });
+    }
+
+    if (!m_options.serialPort.isEmpty())
+    {
+        m_serialManager = new SerialManager(this);
+        m_serialManager->setDebugMode(m_options.debugMode);
+        m_serialManager->setIngest(&m_state, &m_deduplicator, SerialSource);
+        connect(m_serialManager, &SerialManager::errorOccurred, this, [](const QString &error) {
+            qWarning().noquote() << "Serial:" << error;
+        });
+    }
+
+    // Arbitrate only when both links receive the car; a lone link logs and
+    // displays every frame as it comes
+    m_deduplicator.setEnabled(m_udpClient && m_serialManager);
+
+    connect(&m_statsTimer, &QTimer::timeout, this, &HeadlessRecorder::printStats);
+}
+
+HeadlessRecorder::~HeadlessRecorder()
+{
+    stop();
+}
+
+bool HeadlessRecorder::start()
+{
+    if (!m_udpClient && !m_serialManager)
+    {
+        qWarning() << "HeadlessRecorder: No source configured";
+        return false;
+    }
+
+    // Recording is all headless mode does; the transports initialized the logger
+    if (!AsyncLogger::instance().waitUntilReady())
+    {
+        qWarning() << "HeadlessRecorder: Telemetry log could not be opened";
+        return false;
+    }
+
+    if (m_udpClient && !m_udpClient->start(m_options.udpPort))
+    {
+        qWarning() << "HeadlessRecorder: Failed to start UDP on port" << m_options.udpPort;
+        stop();
+        return false;
+    }
+
+    if (m_serialManager && !m_serialManager->start(m_options.serialPort, m_options.baudRate))
+    {
+        qWarning() << "HeadlessRecorder: Failed to open serial port" << m_options.serialPort;
+        stop();
+        return false;
+    }
+
+    m_uptime.start();
+    if (m_options.statsIntervalMs > 0)
+    {
+        m_statsTimer.start(m_options.statsIntervalMs);
+    }
+    return true;
+}
+
+void HeadlessRecorder::stop()
+{
+    m_statsTimer.stop();
+
+    if (m_udpClient)
+    {
+        m_udpClient->stop();
+    }
+    if (m_serialManager)
+    {
+        m_serialManager->stop();
+    }
+}
+
+void HeadlessRecorder::printStats()
+{
+    const qint64 nowMs = m_uptime.elapsed();
+    const double seconds = qMax<qint64>(1, nowMs - m_lastStatsMs) / 1000.0;
+    m_lastStatsMs = nowMs;
+
+    QString line = QStringLiteral("up %1 s").arg(nowMs / 1000);
+
+    if (m_udpClient)
+    {
+        const qint64 frames = m_udpClient->datagramsProcessed();
+        line += QStringLiteral(" | udp %1 frames (%2/s), %3 dropped")
+                    .arg(frames)
+                    .arg((frames - m_lastUdpFrames) / seconds, 0, 'f', 1)
+                    .arg(m_udpClient->datagramsDropped());
+        m_lastUdpFrames = frames;
+    }
+
+    if (m_serialManager)
+    {
+        const qint64 frames = m_serialManager->datagramsProcessed();
+        line += QStringLiteral(" | serial %1 chunks (%2/s), %3 dropped")
+                    .arg(frames)
+                    .arg((frames - m_lastSerialFrames) / seconds, 0, 'f', 1)
+                    .arg(m_serialManager->datagramsDropped());
+        m_lastSerialFrames = frames;
+    }
+
+    if (m_udpClient && m_serialManager)
+    {
+        const FrameDeduplicator::SourceStats udp = m_deduplicator.stats(UdpSource);
+        const FrameDeduplicator::SourceStats serial = m_deduplicator.stats(SerialSource);
+        line += QStringLiteral(" | duplicates %1").arg(udp.duplicates + serial.duplicates);
+    }
+
+    const quint64 logged = AsyncLogger::instance().entriesQueued();
+    line += QStringLiteral(" | logged %1 (%2/s), %3 dropped")
+                .arg(logged)
+                .arg((logged - m_lastLogged) / seconds, 0, 'f', 1)
+                .arg(AsyncLogger::instance().entriesDropped());
+    m_lastLogged = logged;
+
+    qInfo().noquote() << line;
+}
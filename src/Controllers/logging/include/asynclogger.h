@@ -2,70 +2,127 @@
 #define ASYNCLOGGER_H
 
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QMutex>
 #include <QObject>
 #include <QQueue>
 #include <QString>
-#include <QTextStream>
 #include <QThread>
+#include <QTimer>
 #include <QWaitCondition>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+#include "../../can/include/candecoder.h"
+#include "logblockcodec.h"
+#include "logfilewriter.h"
+#include "logrecordring.h"
+#include "logsegmentindex.h"
+#include "telemetrylog.h"
 // Forward declaration
 class LoggerWorker;
 
-/**
- * @brief Log entry structure for async logging
- *
- * This struct is passed across threads via signal/slot,
- * requiring Qt metatype registration.
- */
-struct LogEntry {
-  enum Type { IMU, SUSPENSION };
-
-  // Default constructor required for Qt metatype system
-  LogEntry() : type(IMU), timestamp(0) {}
-
-  Type type;
-  qint64 timestamp;
-  QString data;
-};
-
-// Required for cross-thread signal/slot communication with Qt::QueuedConnection
-Q_DECLARE_METATYPE(LogEntry)
+// Parser threads -> logger thread; 2 MiB, about 4 s of a saturated CAN bus
+using LogRing = LogRecordRing<TelemetryLog::Record, 1 << 15>;
 
 /**
  * @brief Worker class for async file logging
+ *
+ * Each run gets its own session directory under the log directory,
+ * session_<start time>/, holding segment_NNNN.bin logs and, for every
+ * closed segment, a segment_NNNN.idx LogSegmentIndex. Segments are written
+ * through a LogSink: LogFileWriter, or MappedLogWriter for MappedBackend.
+ * With a compression level set, records are gathered into LogBlockCodec
+ * blocks, written when full or when the flush policy says so.
  */
 class LoggerWorker : public QObject {
   Q_OBJECT
 public:
-  explicit LoggerWorker(const QString &logDir, bool debugMode = false);
+  enum Backend {
+    WriteBackend,  // Userspace buffer, writev()
+    MappedBackend  // Preallocated, memory-mapped segments; Unix only
+  };
+
+  /**
+   * @brief When to start a new segment
+   */
+  struct SegmentPolicy {
+    qint64 maxSegmentBytes = 64 * 1024 * 1024;
+    int maxSegmentSeconds = 600;
+    int seekIntervalMs = 500; // Index granularity
+  };
+
+  /**
+   * @param compressionLevel 0 for plain records, 1-9 for compressed blocks
+   */
+  LoggerWorker(const QString &logDir, LogRing *ring, Backend backend,
+               const LogSink::FlushPolicy &flushPolicy,
+               const SegmentPolicy &segmentPolicy, int compressionLevel,
+               bool debugMode = false);
   ~LoggerWorker();
 
+  static constexpr int DRAIN_INTERVAL_MS = 10;
+
+  /**
+   * @brief Set once initialize() has run: whether the log files are open
+   *
+   * Call before moving the worker to its thread; there is one future per worker.
+   */
+  std::future<bool> readyFuture() { return m_ready.get_future(); }
+
 public slots:
-  void processEntry(const LogEntry &entry);
   void initialize();
   void shutdown();
 
+private slots:
+  void drainRing();
+
 private:
   QString m_logDirectory;
-  QFile m_imuFile;
-  QFile m_suspensionFile;
-  QTextStream m_imuStream;
-  QTextStream m_suspensionStream;
+  QString m_sessionDirectory;
+  MonotonicClock::Anchor m_clockAnchor; // Of the session, in every segment
+  LogRing *m_ring;
+  std::unique_ptr<LogSink> m_logFile;
+  SegmentPolicy m_segmentPolicy;
+  LogSegmentIndex m_index; // Of the open segment
+  int m_segmentNumber;
+  QElapsedTimer m_segmentAge;
+  QTimer m_drainTimer;
+  QElapsedTimer m_bufferAge; // Since the oldest unflushed record was drained
+  std::unique_ptr<LogBlockCodec> m_codec; // Null = plain records
+  std::vector<TelemetryLog::Record> m_block; // Waiting for the next block
+  qint64 m_rawBytes;        // Compression stats of the open segment
+  qint64 m_compressedBytes;
+  qint64 m_encodeNs;
   bool m_filesOpen;
   bool m_debugMode;
+  std::promise<bool> m_ready;
 
   bool openFiles();
   void closeFiles();
-  void writeHeader(QTextStream &stream, const QString &header);
+  bool openSegment();
+  void closeSegment();
+  QString segmentPath(const char *suffix) const;
+  void appendRecords(const TelemetryLog::Record *records, qsizetype count);
+  void writeBlock();
+  qint64 pendingBytes() const;
+  void flushBuffered();
 };
 
 /**
  * @brief Async logger for high-frequency CAN data logging
  *
- * Provides thread-safe, non-blocking logging to CSV files with
- * dedicated worker thread and message queue.
+ * Provides thread-safe, non-blocking logging of raw CAN frames to a binary
+ * TelemetryLog file. Callers push fixed-size records into a lock-free ring;
+ * a worker thread drains it in bulk every few milliseconds, buffers the
+ * records and writes them out according to a LogSink::FlushPolicy.
+ * LogExporter converts the log to CSV offline.
+ *
+ * Neither end sleeps: initialize() returns while the worker opens the files,
+ * with early records held in the ring, and shutdown() returns as soon as the
+ * worker has written everything queued and closed the files.
  */
 class AsyncLogger : public QObject {
   Q_OBJECT
@@ -78,25 +135,98 @@ public:
 
   /**
    * @brief Initialize the async logger
+   *
+   * Returns without waiting for the log files; frames logged meanwhile are
+   * queued in the ring and written once they are open.
    * @param logDirectory Directory path for log files
    */
   void initialize(const QString &logDirectory = ".");
 
+  /**
+   * @brief Block until the worker has tried to open the log files
+   * @return False if the logger is not initialized or the files could not be
+   *         opened, in which case logged frames are dropped and counted
+   */
+  bool waitUntilReady() const;
+
+  /**
+   * @brief Set when buffered records are written out
+   *
+   * Takes effect at the next initialize(). The default buffers up to 256 KiB
+   * and never holds a record much longer than 200 ms (the age is checked
+   * every LoggerWorker::DRAIN_INTERVAL_MS).
+   */
+  void setFlushPolicy(const LogSink::FlushPolicy &policy) {
+    m_flushPolicy = policy;
+  }
+
+  /**
+   * @brief Choose how segments are written; takes effect at the next initialize()
+   *
+   * MappedBackend falls back to WriteBackend where it is not supported.
+   */
+  void setBackend(LoggerWorker::Backend backend) { m_backend = backend; }
+
+  /**
+   * @brief Compress segments in blocks at zlib @p level 1-9, or 0 for plain
+   *        records (the default); takes effect at the next initialize()
+   *
+   * A block is written when it holds LogBlockCodec::RECORDS_PER_BLOCK
+   * records or when the flush policy flushes, so a longer flush delay gives
+   * larger blocks and a better ratio at low frame rates.
+   */
+  void setCompressionLevel(int level) { m_compressionLevel = level; }
+
+  /**
+   * @brief Set when the log rotates to a new segment
+   *
+   * Takes effect at the next initialize(). The default rotates at 64 MiB or
+   * 10 minutes, whichever comes first.
+   */
+  void setSegmentPolicy(const LoggerWorker::SegmentPolicy &policy) {
+    m_segmentPolicy = policy;
+  }
+
   /**
    * @brief Shutdown the async logger
+   *
+   * Blocks until every frame logged before the call is written and the
+   * files are closed.
    */
   void shutdown();
 
   /**
-   * @brief Log IMU angle data
+   * @brief Log a received frame with its raw payload
+   *
+   * Records the host receive time (MonotonicClock ns) and the device
+   * timestamp, the ID and the raw payload; a
+   * CAN FD frame takes several records. Safe from any thread; records are
+   * dropped and counted if the ring is full, and frames are counted but not
+   * logged while the logger is not initialized.
+   * @param source Index of the receiving link, -1 if unknown
+   * @param flags TelemetryLog::Duplicate and/or TelemetryLog::Late
+   */
+  void logFrame(const CANDecoder::Frame &frame, int source = -1,
+                quint8 flags = 0);
+
+  /**
+   * @brief Number of entries handed to the worker since startup
    */
-  void logIMU(int16_t ang_x, int16_t ang_y, int16_t ang_z);
+  quint64 entriesQueued() const {
+    return m_entriesQueued.load(std::memory_order_relaxed);
+  }
 
   /**
-   * @brief Log suspension data
+   * @brief Entries lost because the worker fell behind
    */
-  void logSuspension(uint16_t sus_1, uint16_t sus_2, uint16_t sus_3,
-                     uint16_t sus_4);
+  quint64 entriesDropped() const { return m_ring.dropped(); }
+
+  /**
+   * @brief Frames passed to logFrame() while the logger was not initialized
+   */
+  quint64 entriesUnlogged() const {
+    return m_entriesUnlogged.load(std::memory_order_relaxed);
+  }
 
 private:
   explicit AsyncLogger(QObject *parent = nullptr);
@@ -106,15 +236,19 @@ private:
   AsyncLogger(const AsyncLogger &) = delete;
   AsyncLogger &operator=(const AsyncLogger &) = delete;
 
+  LogRing m_ring;
   QThread m_workerThread;
   LoggerWorker *m_worker;
   QString m_logDirectory;
-  bool m_initialized;
+  LoggerWorker::Backend m_backend;
+  LogSink::FlushPolicy m_flushPolicy;
+  LoggerWorker::SegmentPolicy m_segmentPolicy;
+  int m_compressionLevel;
+  std::shared_future<bool> m_ready; // Of the running worker
+  std::atomic<bool> m_initialized;  // Read from parser threads
   bool m_debugMode;
-
-signals:
-  void logEntryReady(const LogEntry &entry);
-  void shutdownWorker();
+  std::atomic<quint64> m_entriesQueued; // Written from parser threads
+  std::atomic<quint64> m_entriesUnlogged;
 };
 
 #endif // ASYNCLOGGER_H
@@ -0,0 +1,87 @@
+#ifndef LOGBLOCKCODEC_H
+#define LOGBLOCKCODEC_H
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <vector>
+#include "telemetrylog.h"
+
+/**
+ * @brief Compressed blocks of TelemetryLog records
+ *
+ * A compressed segment starts with TelemetryLog::header(anchor, true)
+ * and then holds blocks, each a BlockHeader followed by compressedSize
+ * bytes. A block holds up to RECORDS_PER_BLOCK records and decodes on its
+ * own, so reading can start at any block; LogSegmentIndex seek points name
+ * the block that holds the record.
+ *
+ * encode() works in three steps, which decode() undoes in reverse:
+ * - Delta: a record is stored against the previous record with the same CAN
+ *   ID and payload segment in the block, timestamps as differences and the
+ *   other fields XORed. ID and segment are kept, they are the key.
+ *   Consecutive frames of one ID are nearly identical, so this leaves
+ *   mostly zero bytes.
+ * - Shuffle: byte 0 of every record, then byte 1, and so on, which lines
+ *   the zeros up into long runs.
+ * - qCompress() (zlib) at the codec's level.
+ */
+class LogBlockCodec {
+public:
+  static constexpr char BLOCK_MAGIC[4] = {'B', 'L', 'K', '0'};
+  static constexpr int RECORDS_PER_BLOCK = 4096;
+
+  struct BlockHeader {
+    char magic[4];
+    quint32 recordCount;
+    quint32 compressedSize;
+    quint32 reserved;
+    qint64 minTimestamp; // Host time range of the block's records, ns
+    qint64 maxTimestamp;
+  };
+  static_assert(sizeof(BlockHeader) == 32, "BlockHeader layout is part of the file format");
+
+  /**
+   * @param level zlib level, 1 (fastest) to 9 (smallest)
+   */
+  explicit LogBlockCodec(int level = 1);
+
+  /**
+   * @brief Encode @p count records, 1 to RECORDS_PER_BLOCK, into one block
+   * @return The compressed data; @p header describes it
+   */
+  QByteArray encode(const TelemetryLog::Record *records, qsizetype count,
+                    BlockHeader &header);
+
+  /**
+   * @brief Decode a block's @p data into @p records, which has room for
+   *        header.recordCount records
+   * @return False if the block is corrupt
+   */
+  bool decode(const BlockHeader &header, const char *data,
+              TelemetryLog::Record *records);
+
+  int level() const { return m_level; }
+
+private:
+  // The previous record of one (CAN ID, segment) key in the current block
+  struct Slot {
+    quint32 generation; // Slot is in use if equal to m_generation
+    quint32 canId;
+    quint16 segment;
+    TelemetryLog::Record previous;
+  };
+
+  static constexpr int SLOT_COUNT = 1024;     // Power of two
+  static constexpr int MAX_KEYS = SLOT_COUNT * 3 / 4; // Further keys get no delta
+
+  void startBlock();
+  Slot *lookup(quint32 canId, quint16 segment, bool &isNew);
+
+  int m_level;
+  quint32 m_generation;
+  int m_keys;
+  std::vector<Slot> m_slots;
+  QByteArray m_shuffled; // Delta-encoded records, byte-transposed
+};
+
+#endif // LOGBLOCKCODEC_H
@@ -0,0 +1,84 @@
+#ifndef LOGEXPORTER_H
+#define LOGEXPORTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+/**
+ * @brief Offline conversion of binary telemetry logs
+ *
+ * Columnar files (exportColumnar()) are laid out as a ColumnarHeader, then
+ * the column data, then a UTF-8 JSON directory at directoryOffset:
+ *
+ * @code
+ * {"version": 1, "source": "...", "tables": [
+ *   {"name": "IMU_ANGLE", "canId": 113, "rows": 60000, "columns": [
+ *     {"name": "timestamp", "type": "<i8", "offset": 64, "unit": "ns"}, ...]}]}
+ * @endcode
+ *
+ * Each column is rows contiguous values of a NumPy-style little-endian type,
+ * starting at a 64-byte aligned offset, so tools can map columns straight
+ * from the file instead of parsing it.
+ */
+class LogExporter {
+public:
+  static constexpr char COLUMNAR_MAGIC[8] = {'A', 'S', 'U', 'R', 'T', 'C', 'O', 'L'};
+  static constexpr quint16 COLUMNAR_VERSION = 1;
+
+  struct ColumnarHeader {
+    char magic[8];
+    quint16 version;
+    quint16 reserved;
+    quint32 tableCount;
+    qint64 directoryOffset;
+    qint64 directorySize;
+  };
+  static_assert(sizeof(ColumnarHeader) == 32, "ColumnarHeader layout is part of the file format");
+
+  /**
+   * @brief Write the CSV files the logger used to produce from a binary log
+   *
+   * IMU_logger.csv gets the IMU angle frames and suspension_logger.csv the
+   * suspension channels of the ADC frames, with the same columns as before:
+   * host timestamp in ms, then the decoded values. @p logPath is a single
+   * log file or a session directory, whose segments are exported in order
+   * into the same files. Existing files in @p outputDir are overwritten.
+   * @return False with @p error set if the log cannot be read or a file cannot be written
+   */
+  static bool exportCsv(const QString &logPath, const QString &outputDir,
+                        QString *error = nullptr);
+
+  /**
+   * @brief Write every frame of a log to one typed columnar file
+   *
+   * One table per CAN ID: the host timestamp (wall-clock ns since epoch,
+   * converted through the log's clock anchor) and device timestamp
+   * columns, shared by all signals of the message, then one column per
+   * signal of the message in the built-in DBC (SignalDatabase), named and
+   * with the unit as there. Integer signals the DBC does not scale keep
+   * their width; scaled signals are doubles. IDs not in the DBC
+   * get their DLC and raw payload: the first 8 bytes as "<u8", or for IDs
+   * that send longer CAN FD frames a data length column and the whole
+   * payload reassembled into a zero-padded "|V64" column. Decoded messages
+   * are classic and exported from their first 8 bytes. @p logPath is a
+   * single log file or a session directory.
+   *
+   * Frames and payload lengths are counted per segment first (from the
+   * segment index where there is one), which fixes where every row goes. Segments are then read
+   * one after another, and each CAN ID of a segment is decoded by its own
+   * task on @p threads threads (0 = one per core) while the next segment is
+   * read. @p outputPath is overwritten.
+   * @return False with @p error set if the log or the DBC cannot be read or
+   *         the file cannot be written
+   */
+  static bool exportColumnar(const QString &logPath, const QString &outputPath,
+                             QString *error = nullptr, int threads = 0);
+
+  /**
+   * @brief The log files behind @p logPath: itself, or a session's segments
+   */
+  static QStringList logFiles(const QString &logPath);
+};
+
+#endif // LOGEXPORTER_H
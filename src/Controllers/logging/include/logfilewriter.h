@@ -0,0 +1,70 @@
+#ifndef LOGFILEWRITER_H
+#define LOGFILEWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <vector>
+#include "logsink.h"
+
+/**
+ * @brief Append-only log file with a large userspace buffer
+ *
+ * Appended bytes collect in fixed-size chunks. flush() hands every filled
+ * chunk to the kernel in one writev() call (plain writes where writev is not
+ * available) and keeps the chunks for reuse, so the steady state neither
+ * allocates nor makes a syscall per record. The owner decides when to flush
+ * according to a FlushPolicy; append() only flushes by itself when the byte
+ * threshold is reached. With syncToDisk, each flush ends with fdatasync().
+ */
+class LogFileWriter : public LogSink {
+public:
+  LogFileWriter();
+  explicit LogFileWriter(const FlushPolicy &policy);
+  ~LogFileWriter() override;
+
+  LogFileWriter(const LogFileWriter &) = delete;
+  LogFileWriter &operator=(const LogFileWriter &) = delete;
+
+  bool open(const QString &path, qint64 capacity) override;
+  void close() override;
+
+  bool isOpen() const override { return m_file.isOpen(); }
+  QString errorString() const override { return m_error.isEmpty() ? m_file.errorString() : m_error; }
+  const FlushPolicy &policy() const override { return m_policy; }
+
+  /**
+   * @brief Buffer @p size bytes, flushing once the threshold is reached
+   * @return False if that flush failed; what was buffered is then dropped
+   */
+  bool append(const void *data, qsizetype size) override;
+
+  /**
+   * @brief Write everything buffered to the file
+   */
+  bool flush() override;
+
+  qint64 bufferedBytes() const override { return m_bufferedBytes; }
+
+  /**
+   * @brief Bytes that reached the file, and the flushes that wrote them
+   */
+  qint64 bytesWritten() const override { return m_bytesWritten; }
+  qint64 flushCount() const override { return m_flushCount; }
+
+private:
+  static constexpr qsizetype CHUNK_SIZE = 64 * 1024;
+
+  bool writeChunks();
+
+  FlushPolicy m_policy;
+  QFile m_file;
+  QString m_error; // Set by failed writev()/fdatasync() calls
+  std::vector<QByteArray> m_chunks; // [0, m_activeChunk] hold data
+  std::size_t m_activeChunk;
+  qint64 m_bufferedBytes;
+  qint64 m_bytesWritten;
+  qint64 m_flushCount;
+};
+
+#endif // LOGFILEWRITER_H
@@ -0,0 +1,108 @@
+#ifndef LOGRECORDRING_H
+#define LOGRECORDRING_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Bounded lock-free queue from the parser threads to the log writer
+ *
+ * Any number of threads may push(); one thread drains. Every slot carries a
+ * sequence number that says whose turn it is (Vyukov's bounded queue), so a
+ * push is one CAS on the tail plus a copy of the record, and a drain touches
+ * no shared counter at all. Records are trivially copyable and the slots are
+ * allocated up front, so nothing on either side allocates.
+ *
+ * When full, push() drops the new record and counts it rather than waiting:
+ * parsers are never held up by the disk.
+ */
+template <typename T, int Capacity>
+class LogRecordRing {
+  static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0,
+                "LogRecordRing capacity must be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>,
+                "LogRecordRing holds plain records");
+
+public:
+  LogRecordRing() {
+    for (quint64 i = 0; i < quint64(Capacity); ++i) {
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  LogRecordRing(const LogRecordRing &) = delete;
+  LogRecordRing &operator=(const LogRecordRing &) = delete;
+
+  /**
+   * @brief Queue a copy of @p record; safe from any thread
+   * @return False if the ring was full and the record was dropped
+   */
+  bool push(const T &record) {
+    quint64 position = m_tail.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot &slot = m_slots[position & MASK];
+      const quint64 sequence = slot.sequence.load(std::memory_order_acquire);
+      const qint64 lag = qint64(sequence - position);
+      if (lag == 0) {
+        // The slot is free for this position; claim it
+        if (m_tail.compare_exchange_weak(position, position + 1,
+                                         std::memory_order_relaxed)) {
+          slot.record = record;
+          slot.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (lag < 0) {
+        // Still holds the record from one lap ago: full
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        position = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Move up to @p maxCount records into @p out, oldest first
+   *
+   * Only the consumer thread may call this. A record whose push is still in
+   * progress ends the drain; it is picked up next time.
+   */
+  qsizetype drain(T *out, qsizetype maxCount) {
+    qsizetype count = 0;
+    while (count < maxCount) {
+      Slot &slot = m_slots[m_head & MASK];
+      if (slot.sequence.load(std::memory_order_acquire) != m_head + 1) {
+        break;
+      }
+      out[count++] = slot.record;
+      slot.sequence.store(m_head + Capacity, std::memory_order_release);
+      ++m_head;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Records dropped because the ring was full
+   */
+  quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+  static constexpr int capacity() { return Capacity; }
+
+private:
+  static constexpr quint64 MASK = Capacity - 1;
+
+  // One cache line per slot, so producers on neighbouring slots don't collide
+  struct alignas(64) Slot {
+    std::atomic<quint64> sequence;
+    T record;
+  };
+
+  std::array<Slot, Capacity> m_slots;
+  alignas(64) std::atomic<quint64> m_tail{0}; // Producers
+  alignas(64) quint64 m_head = 0;             // Consumer only
+  alignas(64) std::atomic<quint64> m_dropped{0};
+};
+
+#endif // LOGRECORDRING_H
@@ -0,0 +1,110 @@
+#ifndef LOGSEGMENTINDEX_H
+#define LOGSEGMENTINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+#include "telemetrylog.h"
+
+/**
+ * @brief Summary of one log segment, saved next to it as segment_NNNN.idx
+ *
+ * Holds the segment's host time range, the number of frames and the longest
+ * payload per CAN ID, and a seek point every few hundred milliseconds: the byte offset of the first
+ * record at or after that time, or in a compressed segment of the block
+ * holding it. Tools read the small index instead of
+ * scanning the segment. Records are appended in the order the logger drains
+ * them, so a seek point can be off by one drain interval; start reading a
+ * little earlier when that matters.
+ *
+ * Timestamps are the records' own, MonotonicClock ns.
+ *
+ * File layout, little-endian: FileHeader, idCount IdCount entries sorted by
+ * ID, then seekCount SeekPoint entries in time order.
+ */
+class LogSegmentIndex {
+public:
+  static constexpr char MAGIC[8] = {'A', 'S', 'U', 'R', 'T', 'I', 'D', 'X'};
+  static constexpr quint16 VERSION = 1;
+
+  struct FileHeader {
+    char magic[8];
+    quint16 version;
+    quint16 seekIntervalMs;
+    quint32 idCount;
+    quint32 seekCount;
+    quint32 reserved;
+    qint64 firstTimestamp; // Host time of the oldest and newest record, ns
+    qint64 lastTimestamp;
+    quint64 recordCount;
+  };
+  static_assert(sizeof(FileHeader) == 48, "FileHeader layout is part of the file format");
+
+  struct IdCount {
+    quint32 canId;
+    quint32 payloadBytes; // Payload bytes in the records of the ID's longest frame: 8 to 64
+    quint64 frames; // Frames, not records: CAN FD continuations and duplicates are not counted
+  };
+  static_assert(sizeof(IdCount) == 16, "IdCount layout is part of the file format");
+
+  struct SeekPoint {
+    qint64 timestamp;
+    qint64 offset; // From the start of the segment file; a block if compressed
+  };
+  static_assert(sizeof(SeekPoint) == 16, "SeekPoint layout is part of the file format");
+
+  explicit LogSegmentIndex(int seekIntervalMs = 500);
+
+  /**
+   * @brief Start over for a new segment; keeps the seek point capacity
+   */
+  void clear();
+
+  /**
+   * @brief Preallocate seek points, so add() does not allocate in the steady state
+   */
+  void reserveSeekPoints(qsizetype count) { m_seekPoints.reserve(count); }
+
+  /**
+   * @brief Account for @p record, which starts at @p offset in the segment
+   */
+  void add(const TelemetryLog::Record &record, qint64 offset);
+
+  bool save(const QString &path, QString *error = nullptr) const;
+  bool load(const QString &path, QString *error = nullptr);
+
+  /**
+   * @brief Where to start reading for records from @p timestamp on
+   * @return Offset of the last seek point at or before @p timestamp, the
+   *         first one if there is none, -1 for an empty index
+   */
+  qint64 offsetFor(qint64 timestamp) const;
+
+  bool isEmpty() const { return m_recordCount == 0; }
+  qint64 firstTimestamp() const { return m_firstTimestamp; }
+  qint64 lastTimestamp() const { return m_lastTimestamp; }
+  quint64 recordCount() const { return m_recordCount; }
+  int seekIntervalMs() const { return m_seekIntervalMs; }
+  const QHash<quint32, quint64> &frameCounts() const { return m_frameCounts; }
+
+  /**
+   * @brief Payload bytes in the records of each CAN ID's longest frame, a
+   * multiple of 8; only IDs with CAN FD frames over 8 bytes are listed, the
+   * others have 8
+   */
+  const QHash<quint32, quint32> &payloadBytes() const { return m_payloadBytes; }
+  const QList<SeekPoint> &seekPoints() const { return m_seekPoints; }
+
+private:
+  int m_seekIntervalMs;
+  qint64 m_firstTimestamp;
+  qint64 m_lastTimestamp;
+  qint64 m_nextSeekTime;
+  quint64 m_recordCount;
+  QHash<quint32, quint64> m_frameCounts;
+  QHash<quint32, quint32> m_payloadBytes;
+  QList<SeekPoint> m_seekPoints;
+};
+
+#endif // LOGSEGMENTINDEX_H
@@ -0,0 +1,83 @@
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * @brief Append-only destination of LoggerWorker's records
+ *
+ * LogFileWriter buffers and writes with writev(); MappedLogWriter stores
+ * straight into a memory-mapped, preallocated file. Appended bytes are
+ * "pending" until a flush hands them to the OS (writev) or schedules their
+ * writeback (mmap).
+ */
+class LogSink {
+public:
+  /**
+   * @brief When pending data must be flushed
+   *
+   * Data is flushed once maxBufferedBytes are pending, once the oldest
+   * pending byte is maxDelayMs old (the owner's timer), and on close. So at
+   * most maxDelayMs of data is lost if the process dies; with syncToDisk the
+   * same bound also holds for power loss, at the cost of a synchronous disk
+   * write per flush.
+   */
+  struct FlushPolicy {
+    qint64 maxBufferedBytes = 256 * 1024;
+    int maxDelayMs = 200;
+    bool syncToDisk = false;
+  };
+
+  virtual ~LogSink() = default;
+
+  /**
+   * @brief Create @p path; fails if it already exists
+   * @param capacity Most bytes that will be appended; a mapped sink
+   *        preallocates this much, others ignore it
+   */
+  virtual bool open(const QString &path, qint64 capacity) = 0;
+
+  /**
+   * @brief Flush and close
+   */
+  virtual void close() = 0;
+
+  virtual bool isOpen() const = 0;
+  virtual QString errorString() const = 0;
+  virtual const FlushPolicy &policy() const = 0;
+
+  /**
+   * @brief Append @p size bytes, flushing once the threshold is reached
+   * @return False if the data could not be stored or that flush failed
+   */
+  virtual bool append(const void *data, qsizetype size) = 0;
+
+  /**
+   * @brief Flush everything pending
+   */
+  virtual bool flush() = 0;
+
+  /**
+   * @brief Keep the little-endian qint64 at @p offset equal to the bytes
+   *        appended so far, header included
+   *
+   * Lets a reader tell data from preallocated space. Sinks whose file only
+   * ever holds appended data ignore it.
+   */
+  virtual void trackCommittedLength(qint64 offset) { Q_UNUSED(offset); }
+
+  /**
+   * @brief Bytes appended since the last flush, and up to it
+   */
+  virtual qint64 bufferedBytes() const = 0;
+  virtual qint64 bytesWritten() const = 0;
+  virtual qint64 flushCount() const = 0;
+
+  /**
+   * @brief Everything appended to the open file
+   */
+  qint64 size() const { return bytesWritten() + bufferedBytes(); }
+};
+
+#endif // LOGSINK_H
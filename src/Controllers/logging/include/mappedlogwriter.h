@@ -0,0 +1,75 @@
+#ifndef MAPPEDLOGWRITER_H
+#define MAPPEDLOGWRITER_H
+
+#include <QString>
+#include <QtGlobal>
+#include "logsink.h"
+
+/**
+ * @brief Log sink that appends with plain stores into a mapped file
+ *
+ * open() preallocates the whole segment with posix_fallocate() (ftruncate()
+ * where that is missing) and maps it shared, so append() is a memcpy() with
+ * no syscall and no copy through a userspace buffer. The stores are in the
+ * page cache at once and survive a crash of the process; a flush only
+ * schedules their writeback with msync(MS_ASYNC), or waits for it with
+ * MS_SYNC when syncToDisk is set.
+ *
+ * Until close() trims it, the file is as long as the preallocation. The
+ * committed length (see trackCommittedLength()) is updated after every
+ * append, so a reader knows where the data ends even after a crash.
+ *
+ * Unix only; isSupported() is false elsewhere and open() fails.
+ */
+class MappedLogWriter : public LogSink {
+public:
+  MappedLogWriter();
+  explicit MappedLogWriter(const FlushPolicy &policy);
+  ~MappedLogWriter() override;
+
+  MappedLogWriter(const MappedLogWriter &) = delete;
+  MappedLogWriter &operator=(const MappedLogWriter &) = delete;
+
+  static bool isSupported();
+
+  bool open(const QString &path, qint64 capacity) override;
+  void close() override;
+
+  bool isOpen() const override { return m_data != nullptr; }
+  QString errorString() const override { return m_error; }
+  const FlushPolicy &policy() const override { return m_policy; }
+
+  /**
+   * @brief Store @p size bytes, scheduling writeback once the threshold is reached
+   * @return False if the preallocated space is used up; nothing is stored then
+   */
+  bool append(const void *data, qsizetype size) override;
+
+  bool flush() override;
+  void trackCommittedLength(qint64 offset) override;
+
+  qint64 bufferedBytes() const override { return m_size - m_flushedSize; }
+  qint64 bytesWritten() const override { return m_flushedSize; }
+  qint64 flushCount() const override { return m_flushCount; }
+
+  /**
+   * @brief Bytes reserved on disk for the open file
+   */
+  qint64 capacity() const { return m_capacity; }
+
+private:
+  bool sync(qint64 from, qint64 to);
+  void publishLength();
+
+  FlushPolicy m_policy;
+  QString m_error;
+  int m_fd;
+  char *m_data;
+  qint64 m_capacity;
+  qint64 m_size;
+  qint64 m_flushedSize;
+  qint64 m_flushCount;
+  qint64 m_lengthOffset; // -1 = not tracked
+};
+
+#endif // MAPPEDLOGWRITER_H
@@ -0,0 +1,206 @@
+#ifndef TELEMETRYLOG_H
+#define TELEMETRYLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../../telemetry/include/monotonicclock.h"
+
+class LogBlockCodec;
+
+/**
+ * @brief Binary telemetry log: a self-describing header, then fixed-size records
+ *
+ * The header starts with the magic "ASURTLOG" and a format version, and
+ * lists every record field with its name, offset, size and type, followed by
+ * the committed length: the bytes of header and records that hold data, or 0
+ * if that is the whole file (a preallocated file is longer), then the
+ * session's clock anchor. Readers
+ * locate fields through that table rather than a compiled-in layout, so
+ * fields can be added later without breaking old files or old tools.
+ * Records carry the raw CAN payload and are appended as-is, with no
+ * per-record formatting. All values are little-endian, like the CAN packets
+ * (the writer assumes a little-endian host, as CANDecoder does).
+ *
+ * Record timestamps are MonotonicClock nanoseconds, so they never step and
+ * frames received microseconds apart stay distinct and ordered. The anchor,
+ * a wall-clock reading and the monotonic time it was taken at, is the same
+ * in every segment of a session; TelemetryLogReader::toWallClockNs() uses it
+ * to convert.
+ *
+ * A compressed log starts with COMPRESSED_MAGIC instead and holds
+ * LogBlockCodec blocks of records rather than bare records; the rest of the
+ * header is the same.
+ *
+ * LogExporter turns a log back into CSV offline.
+ */
+class TelemetryLog {
+public:
+  static constexpr char MAGIC[8] = {'A', 'S', 'U', 'R', 'T', 'L', 'O', 'G'};
+  static constexpr char COMPRESSED_MAGIC[8] = {'A', 'S', 'U', 'R', 'T', 'L', 'Z', 'B'};
+  static constexpr quint16 VERSION = 1;
+  static constexpr int FIELD_NAME_SIZE = 16;
+
+  enum FieldType : quint8 { UInt = 0, Int = 1, Bytes = 2 };
+
+  enum RecordFlag : quint8 {
+    FdFrame = 0x01,
+    Duplicate = 0x02, // Copy of a frame already received over another link
+    Late = 0x04       // Older than one already displayed for its CAN ID
+  };
+
+  // Flags bits 4-7: index of the receiving link + 1, 0 = unknown
+  static constexpr int SOURCE_SHIFT = 4;
+  static constexpr int sourceOf(quint8 flags) { return (flags >> SOURCE_SHIFT) - 1; }
+
+  /**
+   * @brief One logged CAN frame, as laid out in the file
+   *
+   * A CAN FD frame takes one record per 8 payload bytes, numbered by
+   * segment; all of them carry the frame's timestamps, ID, DLC and flags.
+   * Records of other frames may sit between the segments. Every copy
+   * received over redundant links is logged; all but the first are marked
+   * Duplicate, so readers that want each frame once skip those.
+   */
+  struct Record {
+    qint64 timestamp;         // Host receive time, MonotonicClock ns
+    quint32 canId;            // CANDecoder::Frame::id, CAN_EFF_FLAG included
+    quint8 dlc;
+    quint8 flags;             // RecordFlag bits and the receiving link
+    quint16 segment;          // Payload bytes [8 * segment, 8 * segment + 8)
+    quint8 payload[8];        // Zero-padded
+    quint32 deviceTimestamp;  // CANDecoder::Frame::timestamp, from the car
+    quint32 reserved;
+  };
+  static_assert(sizeof(Record) == 32, "Record layout is part of the file format");
+
+  /**
+   * @brief Fixed part of the file header, followed by fieldCount FieldInfo entries
+   */
+  struct FileHeader {
+    char magic[8];
+    quint16 version;
+    quint16 headerSize;  // Whole header, field table included
+    quint16 recordSize;
+    quint16 fieldCount;
+    qint64 createdMs;    // Wall-clock session start, ms since epoch
+  };
+  static_assert(sizeof(FileHeader) == 24, "FileHeader layout is part of the file format");
+
+  struct FieldInfo {
+    char name[FIELD_NAME_SIZE];  // NUL-padded
+    quint16 offset;
+    quint16 size;
+    FieldType type;
+    quint8 reserved[3];
+  };
+  static_assert(sizeof(FieldInfo) == 24, "FieldInfo layout is part of the file format");
+
+  /**
+   * @brief Header for a new log of this version's records
+   * @param anchor Clock anchor taken once at the start of the session
+   * @param compressed Whether LogBlockCodec blocks follow instead of records
+   */
+  static QByteArray header(const MonotonicClock::Anchor &anchor, bool compressed = false);
+
+  /**
+   * @brief Where header() puts the committed length, a qint64
+   */
+  static qint64 committedLengthOffset();
+
+  /**
+   * @brief Where header() puts the clock anchor: wallNs, then monotonicNs
+   */
+  static qint64 clockAnchorOffset();
+};
+
+/**
+ * @brief Reads a TelemetryLog file through its schema
+ *
+ * Fields this version knows are looked up by name; fields missing from an
+ * older file read as zero, unknown fields of a newer file are skipped. A
+ * partially written last record or block, e.g. after a crash, is ignored.
+ */
+class TelemetryLogReader {
+public:
+  TelemetryLogReader();
+  ~TelemetryLogReader();
+
+  /**
+   * @return False with @p error set if the file cannot be read or is not a log
+   */
+  bool open(const QString &path, QString *error = nullptr);
+  void close();
+
+  /**
+   * @brief Read the next record
+   * @return False at the end of the file
+   */
+  bool next(TelemetryLog::Record &record);
+
+  /**
+   * @brief Continue reading at byte @p offset, e.g. from a LogSegmentIndex
+   * @return False unless @p offset is the start of a record, or of a block
+   *         in a compressed log
+   */
+  bool seek(qint64 offset);
+
+  qint64 createdMs() const { return m_createdMs; }
+  const MonotonicClock::Anchor &clockAnchor() const { return m_anchor; }
+
+  /**
+   * @brief Wall-clock time of record timestamp @p timestamp, ns since epoch
+   */
+  qint64 toWallClockNs(qint64 timestamp) const {
+    return MonotonicClock::toWallNs(m_anchor, timestamp);
+  }
+  quint16 version() const { return m_version; }
+  bool isCompressed() const { return m_codec != nullptr; }
+
+  /**
+   * @brief Whole records in the file, up to the committed length
+   */
+  qint64 recordCount() const { return m_recordCount; }
+
+private:
+  // Where a known field sits inside a file record; size 0 = not in the file
+  struct FieldMap {
+    quint16 offset = 0;
+    quint16 size = 0;
+  };
+
+  enum KnownField {
+    Timestamp,
+    CanId,
+    Dlc,
+    Flags,
+    Payload,
+    Segment,
+    DeviceTimestamp,
+    KnownFieldCount
+  };
+
+  bool readBlock();
+
+  QFile m_file;
+  QByteArray m_buffer;  // One file record
+  FieldMap m_fields[KnownFieldCount];
+  MonotonicClock::Anchor m_anchor = {};
+  qint64 m_createdMs = 0;
+  qint64 m_recordCount = 0;
+  qint64 m_nextRecord = 0;
+  qint64 m_dataEnd = 0;
+  std::unique_ptr<LogBlockCodec> m_codec; // Compressed logs only
+  QByteArray m_blockData;                 // One compressed block
+  std::vector<TelemetryLog::Record> m_block;
+  qsizetype m_blockPosition = 0;
+  quint16 m_version = 0;
+  quint16 m_headerSize = 0;
+  quint16 m_recordSize = 0;
+};
+
+#endif // TELEMETRYLOG_H
@@ -1,6 +1,9 @@
 #include "../include/asynclogger.h"
+#include "../include/mappedlogwriter.h"
 #include <QDebug>
 #include <QDir>
+#include <cstring>
+#include <iterator>
 
 AsyncLogger &AsyncLogger::instance() {
   static AsyncLogger instance;
@@ -9,7 +12,9 @@ AsyncLogger &AsyncLogger::instance() {
 
 AsyncLogger::AsyncLogger(QObject *parent)
     : QObject(parent), m_worker(nullptr), m_logDirectory(QString()),
-      m_initialized(false), m_debugMode(false) {}
+      m_backend(LoggerWorker::WriteBackend), m_compressionLevel(0),
+      m_initialized(false),
+      m_debugMode(false), m_entriesQueued(0), m_entriesUnlogged(0) {}
 
 AsyncLogger::~AsyncLogger() { shutdown(); }
 
@@ -18,14 +23,6 @@ void AsyncLogger::initialize(const QString &logDirectory) {
     return;
   }
 
-  // Register LogEntry metatype for cross-thread signal/slot communication
-  // This must be called before any queued connections using LogEntry
-  static bool metatypeRegistered = false;
-  if (!metatypeRegistered) {
-    qRegisterMetaType<LogEntry>("LogEntry");
-    metatypeRegistered = true;
-  }
-
   m_logDirectory = logDirectory;
 
   // Create log directory if it doesn't exist
@@ -39,14 +36,13 @@ void AsyncLogger::initialize(const QString &logDirectory) {
   }
 
   // Create worker and move to thread (debug logging disabled by default)
-  m_worker = new LoggerWorker(m_logDirectory, m_debugMode);
+  m_worker = new LoggerWorker(m_logDirectory, &m_ring, m_backend,
+                              m_flushPolicy, m_segmentPolicy,
+                              m_compressionLevel, m_debugMode);
+  m_ready = m_worker->readyFuture().share();
   m_worker->moveToThread(&m_workerThread);
 
-  // Connect signals for log entries and shutdown
-  connect(this, &AsyncLogger::logEntryReady, m_worker,
-          &LoggerWorker::processEntry, Qt::QueuedConnection);
-  connect(this, &AsyncLogger::shutdownWorker, m_worker, &LoggerWorker::shutdown,
-          Qt::QueuedConnection);
+  // Entries arrive through m_ring; shutdown is a blocking call
   connect(&m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
 
   // Connect thread started signal to worker initialization
@@ -58,10 +54,7 @@ void AsyncLogger::initialize(const QString &logDirectory) {
   m_workerThread.start();
   m_workerThread.setPriority(QThread::LowPriority); // Low priority for logging
 
-  // Wait briefly for thread to fully start and initialize the worker
-  // This ensures files are open before we try to log anything
-  QThread::msleep(100);
-
+  // Files open in the background; records logged until then wait in the ring
   m_initialized = true;
   if (m_debugMode) {
     qDebug() << "AsyncLogger initialized with log directory:" << m_logDirectory;
@@ -73,22 +66,15 @@ void AsyncLogger::shutdown() {
     return;
   }
 
-  // Signal worker to close files
-  emit shutdownWorker();
-
-  // Give worker time to process signal
-  QThread::msleep(50);
+  // Returns once the worker has drained the ring and closed the files; it
+  // runs after the worker's initialize(), so this also waits out a slow open
+  QMetaObject::invokeMethod(m_worker, &LoggerWorker::shutdown,
+                            Qt::BlockingQueuedConnection);
 
-  // Stop the thread
-  if (m_workerThread.isRunning()) {
-    m_workerThread.quit();
-    if (!m_workerThread.wait(3000)) { // Wait up to 3 seconds
-      qWarning() << "AsyncLogger worker thread did not terminate gracefully, "
-                    "forcing termination";
-      m_workerThread.terminate();
-      m_workerThread.wait(1000);
-    }
-  }
+  // Nothing is left for the thread to do, so it finishes without a timeout
+  m_workerThread.quit();
+  m_workerThread.wait();
+  m_worker = nullptr; // Deleted as the thread finished
 
   m_initialized = false;
   if (m_debugMode) {
@@ -96,43 +82,79 @@ void AsyncLogger::shutdown() {
   }
 }
 
-void AsyncLogger::logIMU(int16_t ang_x, int16_t ang_y, int16_t ang_z) {
-  if (!m_initialized) {
-    qWarning()
-        << "AsyncLogger: Attempted to log IMU data but logger not initialized";
-    return;
-  }
-
-  LogEntry entry;
-  entry.type = LogEntry::IMU;
-  entry.timestamp = QDateTime::currentMSecsSinceEpoch();
-  entry.data = QString("%1,%2,%3").arg(ang_x).arg(ang_y).arg(ang_z);
-
-  emit logEntryReady(entry);
+bool AsyncLogger::waitUntilReady() const {
+  return m_initialized && m_ready.valid() && m_ready.get();
 }
 
-void AsyncLogger::logSuspension(uint16_t sus_1, uint16_t sus_2, uint16_t sus_3,
-                                uint16_t sus_4) {
+void AsyncLogger::logFrame(const CANDecoder::Frame &frame, int source,
+                           quint8 flags) {
   if (!m_initialized) {
-    qWarning() << "AsyncLogger: Attempted to log Suspension data but logger "
-                  "not initialized";
+    // Once: a transport running without the logger would warn per frame
+    if (m_entriesUnlogged.fetch_add(1, std::memory_order_relaxed) == 0) {
+      qWarning() << "AsyncLogger: Frames arrive but the logger is not "
+                    "initialized; they are counted, not logged";
+    }
     return;
   }
 
-  LogEntry entry;
-  entry.type = LogEntry::SUSPENSION;
-  entry.timestamp = QDateTime::currentMSecsSinceEpoch();
-  entry.data =
-      QString("%1,%2,%3,%4").arg(sus_1).arg(sus_2).arg(sus_3).arg(sus_4);
-
-  emit logEntryReady(entry);
+  // Raw payload only; decoding happens offline
+  TelemetryLog::Record record = {};
+  record.timestamp = MonotonicClock::nowNs();
+  record.deviceTimestamp = frame.timestamp;
+  record.canId = frame.id;
+  record.dlc = frame.dlc;
+  record.flags = (frame.fd ? TelemetryLog::FdFrame : 0) | flags |
+                 quint8(((source + 1) & 0x0F) << TelemetryLog::SOURCE_SHIFT);
+
+  // One record per 8 payload bytes; classic frames always fit in one
+  qsizetype offset = 0;
+  do {
+    const qsizetype size = qMin<qsizetype>(frame.payload.size() - offset,
+                                           sizeof(record.payload));
+    std::memset(record.payload, 0, sizeof(record.payload));
+    if (size > 0) {
+      std::memcpy(record.payload, frame.payload.data() + offset, size);
+    }
+    if (m_ring.push(record)) {
+      m_entriesQueued.fetch_add(1, std::memory_order_relaxed);
+    }
+    offset += sizeof(record.payload);
+    ++record.segment;
+  } while (offset < frame.payload.size());
 }
 
 // LoggerWorker implementation
 
-LoggerWorker::LoggerWorker(const QString &logDir, bool debugMode)
-    : m_logDirectory(logDir), m_imuFile(), m_suspensionFile(), m_imuStream(),
-      m_suspensionStream(), m_filesOpen(false), m_debugMode(debugMode) {}
+LoggerWorker::LoggerWorker(const QString &logDir, LogRing *ring,
+                           Backend backend,
+                           const LogSink::FlushPolicy &flushPolicy,
+                           const SegmentPolicy &segmentPolicy,
+                           int compressionLevel, bool debugMode)
+    : m_logDirectory(logDir), m_clockAnchor(), m_ring(ring),
+      m_logFile(backend == MappedBackend && MappedLogWriter::isSupported()
+                    ? std::unique_ptr<LogSink>(
+                          std::make_unique<MappedLogWriter>(flushPolicy))
+                    : std::make_unique<LogFileWriter>(flushPolicy)),
+      m_segmentPolicy(segmentPolicy), m_index(segmentPolicy.seekIntervalMs),
+      m_segmentNumber(0), m_drainTimer(this),
+      m_codec(compressionLevel > 0
+                  ? std::make_unique<LogBlockCodec>(compressionLevel)
+                  : nullptr),
+      m_rawBytes(0), m_compressedBytes(0), m_encodeNs(0), m_filesOpen(false),
+      m_debugMode(debugMode) {
+  if (m_codec) {
+    m_block.reserve(LogBlockCodec::RECORDS_PER_BLOCK);
+  }
+
+  // Seek points for a full-length segment, plus slack
+  m_index.reserveSeekPoints(
+      qint64(m_segmentPolicy.maxSegmentSeconds) * 1000 /
+          qMax(1, m_segmentPolicy.seekIntervalMs) + 64);
+
+  // Also enforces the flush delay, so no timer is registered per flush
+  m_drainTimer.setInterval(DRAIN_INTERVAL_MS);
+  connect(&m_drainTimer, &QTimer::timeout, this, &LoggerWorker::drainRing);
+}
 
 LoggerWorker::~LoggerWorker() { closeFiles(); }
 
@@ -153,6 +175,7 @@ void LoggerWorker::initialize() {
       qWarning() << "LoggerWorker: Failed to create directory:"
                  << m_logDirectory;
       m_filesOpen = false;
+      m_ready.set_value(false);
       return;
     }
   }
@@ -165,6 +188,7 @@ void LoggerWorker::initialize() {
 
   if (openFiles()) {
     m_filesOpen = true;
+    m_drainTimer.start();
     if (m_debugMode) {
       qDebug() << "LoggerWorker: Log files opened successfully in:" << absPath;
     }
@@ -172,97 +196,205 @@ void LoggerWorker::initialize() {
     qWarning() << "LoggerWorker: Failed to open log files in:" << absPath;
     m_filesOpen = false;
   }
+  m_ready.set_value(m_filesOpen);
 }
 
-void LoggerWorker::shutdown() { closeFiles(); }
+void LoggerWorker::shutdown() {
+  drainRing(); // Whatever was queued before shutdown
+  closeFiles();
+}
 
 bool LoggerWorker::openFiles() {
-  // Open IMU log file
-  m_imuFile.setFileName(m_logDirectory + "/IMU_logger.csv");
-  if (!m_imuFile.open(QIODevice::WriteOnly | QIODevice::Append |
-                      QIODevice::Text)) {
-    qWarning() << "Failed to open IMU log file:" << m_imuFile.errorString();
+  // One directory per run, named after its start time
+  m_sessionDirectory =
+      m_logDirectory + "/session_" +
+      QDateTime::currentDateTime().toString("yyyyMMdd_HHmmsszzz");
+  if (!QDir().mkpath(m_sessionDirectory)) {
+    qWarning() << "Failed to create session directory:" << m_sessionDirectory;
     return false;
   }
-  m_imuStream.setDevice(&m_imuFile);
 
-  // Write header if file is empty
-  if (m_imuFile.size() == 0) {
-    writeHeader(m_imuStream, "timestamp,IMU_Ang_X,IMU_Ang_Y,IMU_Ang_Z");
-  }
+  // Record timestamps are monotonic; this is their only tie to the wall clock
+  m_clockAnchor = MonotonicClock::anchor();
+  m_segmentNumber = 0;
+  return openSegment();
+}
 
-  // Open Suspension log file
-  m_suspensionFile.setFileName(m_logDirectory + "/suspension_logger.csv");
-  if (!m_suspensionFile.open(QIODevice::WriteOnly | QIODevice::Append |
-                             QIODevice::Text)) {
-    qWarning() << "Failed to open suspension log file:"
-               << m_suspensionFile.errorString();
+void LoggerWorker::closeFiles() {
+  m_drainTimer.stop();
+  m_bufferAge.invalidate();
+  closeSegment();
+  m_filesOpen = false;
+}
+
+QString LoggerWorker::segmentPath(const char *suffix) const {
+  return QString("%1/segment_%2%3")
+      .arg(m_sessionDirectory)
+      .arg(m_segmentNumber, 4, 10, QChar('0'))
+      .arg(suffix);
+}
+
+bool LoggerWorker::openSegment() {
+  // Rotation overshoots the segment size by less than one drained batch
+  const QString path = segmentPath(".bin");
+  if (!m_logFile->open(path, m_segmentPolicy.maxSegmentBytes + 1024 * 1024)) {
+    qWarning() << "Failed to open telemetry log file:" << path
+               << m_logFile->errorString();
     return false;
   }
-  m_suspensionStream.setDevice(&m_suspensionFile);
 
-  // Write header if file is empty
-  if (m_suspensionFile.size() == 0) {
-    writeHeader(m_suspensionStream, "timestamp,SUS_1,SUS_2,SUS_3,SUS_4");
+  const QByteArray header =
+      TelemetryLog::header(m_clockAnchor, m_codec != nullptr);
+  m_logFile->trackCommittedLength(TelemetryLog::committedLengthOffset());
+  if (!m_logFile->append(header.constData(), header.size()) ||
+      !m_logFile->flush()) {
+    qWarning() << "Failed to write telemetry log header:"
+               << m_logFile->errorString();
+    m_logFile->close();
+    return false;
   }
 
+  m_index.clear();
+  m_segmentAge.start();
   return true;
 }
 
-void LoggerWorker::closeFiles() {
-  if (m_imuFile.isOpen()) {
-    m_imuStream.flush();
-    m_imuFile.close();
+void LoggerWorker::closeSegment() {
+  if (!m_logFile->isOpen()) {
+    return;
+  }
+  writeBlock();
+  m_logFile->close(); // Flushes what is still buffered
+  if (m_debugMode) {
+    qDebug() << "LoggerWorker: Closed segment" << m_segmentNumber << "after"
+             << m_logFile->flushCount() << "flushes,"
+             << m_logFile->bytesWritten() << "bytes";
+  }
+  if (m_codec && m_rawBytes > 0) {
+    const qint64 records = m_rawBytes / qint64(sizeof(TelemetryLog::Record));
+    qInfo().nospace() << "LoggerWorker: Segment " << m_segmentNumber
+                      << " compressed " << m_rawBytes << " -> "
+                      << m_compressedBytes << " bytes (ratio "
+                      << double(m_rawBytes) / m_compressedBytes << "), "
+                      << double(m_encodeNs) / records << " ns per record";
   }
+  m_rawBytes = 0;
+  m_compressedBytes = 0;
+  m_encodeNs = 0;
+
+  // Written last, so an index always describes a complete segment
+  QString error;
+  if (!m_index.save(segmentPath(".idx"), &error)) {
+    qWarning() << "LoggerWorker: Failed to write segment index:" << error;
+  }
+}
 
-  if (m_suspensionFile.isOpen()) {
-    m_suspensionStream.flush();
-    m_suspensionFile.close();
+void LoggerWorker::drainRing() {
+  if (!m_filesOpen) {
+    return; // Producers count drops once the ring fills
   }
 
-  m_filesOpen = false;
-}
+  // Bulk copy out of the ring, straight into the write buffer
+  qint64 flushesBefore = m_logFile->flushCount();
+  TelemetryLog::Record batch[512];
+  qsizetype count;
+  do {
+    count = m_ring->drain(batch, std::size(batch));
+    appendRecords(batch, count);
+
+    // Rotate between batches; a segment overshoots by less than one batch
+    if (m_logFile->size() >= m_segmentPolicy.maxSegmentBytes ||
+        m_segmentAge.hasExpired(qint64(m_segmentPolicy.maxSegmentSeconds) *
+                                1000)) {
+      closeSegment();
+      ++m_segmentNumber;
+      if (!openSegment()) {
+        closeFiles();
+        return;
+      }
+      flushesBefore = m_logFile->flushCount();
+      m_bufferAge.invalidate();
+    }
+  } while (count == qsizetype(std::size(batch)));
 
-void LoggerWorker::writeHeader(QTextStream &stream, const QString &header) {
-  stream << header << "\n";
-  stream.flush();
+  // Age the buffer from the first record after the last flush
+  if (m_logFile->flushCount() != flushesBefore) {
+    m_bufferAge.invalidate();
+  }
+  if (pendingBytes() == 0) {
+    return;
+  }
+  if (!m_bufferAge.isValid()) {
+    m_bufferAge.start();
+  } else if (m_bufferAge.hasExpired(m_logFile->policy().maxDelayMs)) {
+    flushBuffered();
+    m_bufferAge.invalidate();
+  }
 }
 
-void LoggerWorker::processEntry(const LogEntry &entry) {
-  if (m_debugMode) {
-    qDebug() << "LoggerWorker::processEntry() received entry type:" << entry.type
-             << "data:" << entry.data;
+void LoggerWorker::appendRecords(const TelemetryLog::Record *records,
+                                 qsizetype count) {
+  if (!m_codec) {
+    const qint64 offset = m_logFile->size();
+    for (qsizetype i = 0; i < count; ++i) {
+      m_index.add(records[i], offset + i * qint64(sizeof(records[0])));
+    }
+    if (count > 0 && !m_logFile->append(records, count * sizeof(records[0]))) {
+      qWarning() << "LoggerWorker: Failed to write records:"
+                 << m_logFile->errorString();
+    }
+    return;
   }
 
-  // Ensure files are open before processing
-  if (!m_filesOpen) {
-    qWarning() << "LoggerWorker: Attempted to log entry but files not open, "
-                  "trying to initialize...";
-    initialize();
-    if (!m_filesOpen) {
-      qWarning() << "LoggerWorker: Failed to open files, entry will be lost";
-      return;
+  while (count > 0) {
+    // The pending block will start where the segment ends now
+    const qint64 offset = m_logFile->size();
+    const qsizetype taken = qMin<qsizetype>(
+        count, LogBlockCodec::RECORDS_PER_BLOCK - qsizetype(m_block.size()));
+    for (qsizetype i = 0; i < taken; ++i) {
+      m_index.add(records[i], offset);
+    }
+    m_block.insert(m_block.end(), records, records + taken);
+    records += taken;
+    count -= taken;
+    if (qsizetype(m_block.size()) == LogBlockCodec::RECORDS_PER_BLOCK) {
+      writeBlock();
     }
   }
+}
 
-  QTextStream *stream = nullptr;
+void LoggerWorker::writeBlock() {
+  if (m_block.empty()) {
+    return;
+  }
 
-  switch (entry.type) {
-  case LogEntry::IMU:
-    stream = &m_imuStream;
-    break;
-  case LogEntry::SUSPENSION:
-    stream = &m_suspensionStream;
-    break;
+  QElapsedTimer timer;
+  timer.start();
+  LogBlockCodec::BlockHeader header;
+  const QByteArray data = m_codec->encode(m_block.data(), m_block.size(), header);
+  m_encodeNs += timer.nsecsElapsed();
+  m_rawBytes += qint64(m_block.size() * sizeof(TelemetryLog::Record));
+  m_compressedBytes += qint64(sizeof(header)) + data.size();
+  m_block.clear();
+
+  if (!m_logFile->append(&header, sizeof(header)) ||
+      !m_logFile->append(data.constData(), data.size())) {
+    qWarning() << "LoggerWorker: Failed to write records:"
+               << m_logFile->errorString();
   }
+}
 
-  if (stream) {
-    *stream << entry.timestamp << "," << entry.data << "\n";
-    stream->flush(); // Ensure data is written immediately
-    if (m_debugMode) {
-      qDebug() << "LoggerWorker: Written entry to file";
-    }
-  } else {
-    qWarning() << "LoggerWorker: Unknown log entry type:" << entry.type;
+qint64 LoggerWorker::pendingBytes() const {
+  return m_logFile->bufferedBytes() +
+         qint64(m_block.size() * sizeof(TelemetryLog::Record));
+}
+
+void LoggerWorker::flushBuffered() {
+  writeBlock();
+  if (!m_logFile->flush()) {
+    qWarning() << "LoggerWorker: Failed to write records:"
+               << m_logFile->errorString();
+  } else if (m_debugMode) {
+    qDebug() << "LoggerWorker: Flushed buffered records";
   }
 }
@@ -0,0 +1,148 @@
+#include "../include/logblockcodec.h"
+#include <cstring>
+#include <limits>
+
+namespace {
+
+using Record = TelemetryLog::Record;
+
+constexpr int RECORD_SIZE = sizeof(Record);
+
+// Differences wrap; unsigned arithmetic keeps that defined
+void applyDelta(Record &record, const Record &previous) {
+  record.timestamp = qint64(quint64(record.timestamp) - quint64(previous.timestamp));
+  record.dlc ^= previous.dlc;
+  record.flags ^= previous.flags;
+  for (int i = 0; i < 8; ++i) {
+    record.payload[i] ^= previous.payload[i];
+  }
+  record.deviceTimestamp -= previous.deviceTimestamp;
+  record.reserved ^= previous.reserved;
+}
+
+void undoDelta(Record &record, const Record &previous) {
+  record.timestamp = qint64(quint64(record.timestamp) + quint64(previous.timestamp));
+  record.dlc ^= previous.dlc;
+  record.flags ^= previous.flags;
+  for (int i = 0; i < 8; ++i) {
+    record.payload[i] ^= previous.payload[i];
+  }
+  record.deviceTimestamp += previous.deviceTimestamp;
+  record.reserved ^= previous.reserved;
+}
+
+} // namespace
+
+LogBlockCodec::LogBlockCodec(int level)
+    : m_level(qBound(1, level, 9)), m_generation(0), m_keys(0),
+      m_slots(SLOT_COUNT, Slot()) {
+  m_shuffled.reserve(RECORDS_PER_BLOCK * RECORD_SIZE);
+}
+
+void LogBlockCodec::startBlock() {
+  // Bumping the generation empties every slot at once
+  if (++m_generation == 0) {
+    for (Slot &slot : m_slots) {
+      slot.generation = 0;
+    }
+    m_generation = 1;
+  }
+  m_keys = 0;
+}
+
+LogBlockCodec::Slot *LogBlockCodec::lookup(quint32 canId, quint16 segment,
+                                           bool &isNew) {
+  quint32 hash = (canId ^ (quint32(segment) << 16)) * 0x9E3779B1u;
+  for (quint32 i = (hash >> 16) & (SLOT_COUNT - 1);; i = (i + 1) & (SLOT_COUNT - 1)) {
+    Slot &slot = m_slots[i];
+    if (slot.generation != m_generation) {
+      // Encoder and decoder see the same keys in the same order, so both
+      // give up on the same ones
+      if (m_keys == MAX_KEYS) {
+        return nullptr;
+      }
+      ++m_keys;
+      slot.generation = m_generation;
+      slot.canId = canId;
+      slot.segment = segment;
+      isNew = true;
+      return &slot;
+    }
+    if (slot.canId == canId && slot.segment == segment) {
+      isNew = false;
+      return &slot;
+    }
+  }
+}
+
+QByteArray LogBlockCodec::encode(const Record *records, qsizetype count,
+                                 BlockHeader &header) {
+  Q_ASSERT(count > 0 && count <= RECORDS_PER_BLOCK);
+  startBlock();
+  m_shuffled.resize(count * RECORD_SIZE);
+  uchar *shuffled = reinterpret_cast<uchar *>(m_shuffled.data());
+
+  qint64 minTimestamp = std::numeric_limits<qint64>::max();
+  qint64 maxTimestamp = std::numeric_limits<qint64>::min();
+  for (qsizetype i = 0; i < count; ++i) {
+    const Record &record = records[i];
+    minTimestamp = qMin(minTimestamp, record.timestamp);
+    maxTimestamp = qMax(maxTimestamp, record.timestamp);
+
+    Record delta = record;
+    bool isNew = false;
+    if (Slot *slot = lookup(record.canId, record.segment, isNew)) {
+      if (!isNew) {
+        applyDelta(delta, slot->previous);
+      }
+      slot->previous = record;
+    }
+
+    const uchar *bytes = reinterpret_cast<const uchar *>(&delta);
+    for (int b = 0; b < RECORD_SIZE; ++b) {
+      shuffled[b * count + i] = bytes[b];
+    }
+  }
+
+  QByteArray data = qCompress(shuffled, m_shuffled.size(), m_level);
+
+  std::memcpy(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+  header.recordCount = quint32(count);
+  header.compressedSize = quint32(data.size());
+  header.reserved = 0;
+  header.minTimestamp = minTimestamp;
+  header.maxTimestamp = maxTimestamp;
+  return data;
+}
+
+bool LogBlockCodec::decode(const BlockHeader &header, const char *data,
+                           Record *records) {
+  const qsizetype count = header.recordCount;
+  if (count <= 0 || count > RECORDS_PER_BLOCK) {
+    return false;
+  }
+  const QByteArray shuffledBytes = qUncompress(
+      reinterpret_cast<const uchar *>(data), qsizetype(header.compressedSize));
+  if (shuffledBytes.size() != count * RECORD_SIZE) {
+    return false;
+  }
+  const uchar *shuffled = reinterpret_cast<const uchar *>(shuffledBytes.constData());
+
+  startBlock();
+  for (qsizetype i = 0; i < count; ++i) {
+    Record &record = records[i];
+    uchar *bytes = reinterpret_cast<uchar *>(&record);
+    for (int b = 0; b < RECORD_SIZE; ++b) {
+      bytes[b] = shuffled[b * count + i];
+    }
+
+    bool isNew = false;
+    if (Slot *slot = lookup(record.canId, record.segment, isNew)) {
+      if (!isNew) {
+        undoDelta(record, slot->previous);
+      }
+      slot->previous = record;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,581 @@
+#include "../include/logexporter.h"
+#include "../../can/include/candecoder.h"
+#include "../../can/include/signaldatabase.h"
+#include "../include/logsegmentindex.h"
+#include "../include/telemetrylog.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QThreadPool>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+using Record = TelemetryLog::Record;
+
+bool openCsv(QFile &file, QTextStream &stream, const QString &path,
+             const char *header, QString *error) {
+  file.setFileName(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+    if (error) {
+      *error = QString("%1: %2").arg(path, file.errorString());
+    }
+    return false;
+  }
+  stream.setDevice(&file);
+  stream << header << "\n";
+  return true;
+}
+
+// Appends the IMU and suspension rows of one log file
+void exportRecords(TelemetryLogReader &reader, QTextStream &imu,
+                   QTextStream &suspension) {
+  TelemetryLog::Record record;
+  while (reader.next(record)) {
+    if (record.segment != 0 || (record.flags & TelemetryLog::Duplicate)) {
+      continue; // Rest of a CAN FD payload (the exported messages are
+                // classic), or a copy from a redundant link
+    }
+    const QByteArrayView payload(reinterpret_cast<const char *>(record.payload),
+                                 sizeof(record.payload));
+    // Wall-clock ms since epoch, as the CSV files have always had
+    const qint64 timestampMs = reader.toWallClockNs(record.timestamp) / 1000000;
+    switch (record.canId) {
+    case CANDecoder::CAN_ID_IMU_ANGLE: {
+      const CANDecoder::IMUAngle angle = CANDecoder::decodeIMUAngle(payload);
+      imu << timestampMs << ',' << angle.ang_x << ',' << angle.ang_y << ','
+          << angle.ang_z << '\n';
+      break;
+    }
+    case CANDecoder::CAN_ID_ADC: {
+      const CANDecoder::ADCData adc = CANDecoder::decodeADC(payload);
+      suspension << timestampMs << ',' << adc.sus_1 << ',' << adc.sus_2
+                 << ',' << adc.sus_3 << ',' << adc.sus_4 << '\n';
+      break;
+    }
+    default:
+      break;
+    }
+  }
+}
+
+void setError(QString *error, const QString &message) {
+  if (error) {
+    *error = message;
+  }
+}
+
+// Columnar export
+
+constexpr qint64 COLUMN_ALIGNMENT = 64;
+
+// Messages with a decoder; built into the binary as a Qt resource
+const QString SIGNAL_DATABASE_PATH = QStringLiteral(":/dbc/asurt_telemetry.dbc");
+
+// A 64-bit payload holds at most 64 signals
+constexpr int MAX_SIGNALS = 64;
+
+struct ColumnSpec {
+  QString name;
+  const char *type; // NumPy type string
+  int size;
+  QString unit;
+};
+
+template <typename T> void put(char *column, qint64 row, T value) {
+  std::memcpy(column + row * qint64(sizeof(T)), &value, sizeof(T));
+}
+
+// Stores a decoded value as its column's type
+void putValue(char *column, qint64 row, const ColumnSpec &spec, double value) {
+  switch (spec.type[1]) {
+  case 'f':
+    if (spec.size == 4) {
+      put(column, row, float(value));
+    } else {
+      put(column, row, value);
+    }
+    break;
+  case 'i':
+    switch (spec.size) {
+    case 1: put(column, row, qint8(value)); break;
+    case 2: put(column, row, qint16(value)); break;
+    case 4: put(column, row, qint32(value)); break;
+    default: put(column, row, qint64(value)); break;
+    }
+    break;
+  default:
+    switch (spec.size) {
+    case 1: put(column, row, quint8(value)); break;
+    case 2: put(column, row, quint16(value)); break;
+    case 4: put(column, row, quint32(value)); break;
+    default: put(column, row, quint64(value)); break;
+    }
+    break;
+  }
+}
+
+// Every table starts with these, written by the export itself
+const ColumnSpec TIME_COLUMNS[] = {
+    {"timestamp", "<i8", 8, "ns"}, // Wall clock since epoch, via the anchor
+    {"deviceTime", "<u4", 4, "ms"},
+};
+constexpr int TIME_COLUMN_COUNT = std::size(TIME_COLUMNS);
+
+// Column of a DBC signal: integers the DBC does not scale keep their width,
+// IEEE floats their type, and scaled signals become doubles
+ColumnSpec signalColumn(const SignalDatabase::SignalInfo &signal) {
+  const bool scaled = signal.scale != 1.0 || signal.offset != 0.0;
+  if (signal.valueType == SignalDatabase::Float32 && !scaled) {
+    return {signal.name, "<f4", 4, signal.unit};
+  }
+  if (signal.valueType != SignalDatabase::Integer || scaled) {
+    return {signal.name, "<f8", 8, signal.unit};
+  }
+  static constexpr const char *SIGNED_TYPES[] = {"|i1", "<i2", "<i4", "<i8"};
+  static constexpr const char *UNSIGNED_TYPES[] = {"|u1", "<u2", "<u4", "<u8"};
+  const int width = signal.length <= 8 ? 0 : signal.length <= 16 ? 1 : signal.length <= 32 ? 2 : 3;
+  return {signal.name,
+          signal.isSigned ? SIGNED_TYPES[width] : UNSIGNED_TYPES[width],
+          1 << width, signal.unit};
+}
+
+// IDs without a decoder keep their bytes
+const ColumnSpec RAW_COLUMNS[] = {{"dlc", "|u1", 1, ""},
+                                  {"payload", "<u8", 8, ""}};
+
+void decodeRaw(const Record &record, char *const *columns, qint64 row) {
+  quint64 payload;
+  std::memcpy(&payload, record.payload, sizeof(payload));
+  put(columns[0], row, record.dlc);
+  put(columns[1], row, payload);
+}
+
+// IDs without a decoder that send CAN FD frames over 8 bytes: the whole
+// payload, reassembled from the frame's records and zero-padded
+constexpr int FD_PAYLOAD_BYTES = CANDecoder::MAX_FD_PAYLOAD;
+const ColumnSpec FD_RAW_COLUMNS[] = {{"dlc", "|u1", 1, ""},
+                                     {"length", "|u1", 1, "B"},
+                                     {"payload", "|V64", FD_PAYLOAD_BYTES, ""}};
+static_assert(FD_PAYLOAD_BYTES == 64, "The payload column type names its size");
+
+void decodeFdRaw(const Record &record, const quint8 *payload,
+                 char *const *columns, qint64 row) {
+  const int length = CANDecoder::dataLength(
+      record.dlc, record.flags & TelemetryLog::FdFrame);
+  put(columns[0], row, record.dlc);
+  put(columns[1], row, quint8(qMax(length, 0)));
+  std::memcpy(columns[2] + row * FD_PAYLOAD_BYTES, payload, FD_PAYLOAD_BYTES);
+}
+
+// One table of the output, i.e. one CAN ID
+struct Table {
+  enum Kind {
+    Decoded, // One column per DBC signal, via SignalDatabase::decode()
+    Raw,     // RAW_COLUMNS
+    FdRaw    // FD_RAW_COLUMNS, for frames over 8 bytes
+  };
+
+  quint32 canId = 0;
+  Kind kind = Raw;
+  QString name;
+  qint64 rows = 0;
+  std::vector<ColumnSpec> specs; // Time columns first
+  std::vector<qint64> offsets;   // Per column
+  std::vector<char *> columns;   // Into the mapped output
+};
+
+struct SegmentCounts {
+  QHash<quint32, qint64> frames;        // Exported frames per CAN ID
+  QHash<quint32, quint32> payloadBytes; // As LogSegmentIndex::payloadBytes()
+  QString error;
+};
+
+// Frames and payload lengths per CAN ID of one segment; the index has them
+// unless the segment was cut short
+SegmentCounts countFrames(const QString &path) {
+  SegmentCounts counts;
+  TelemetryLogReader reader;
+  if (!reader.open(path, &counts.error)) {
+    return counts;
+  }
+
+  LogSegmentIndex index;
+  if (path.endsWith(".bin") && index.load(path.chopped(4) + ".idx") &&
+      qint64(index.recordCount()) == reader.recordCount()) {
+    for (auto it = index.frameCounts().cbegin(); it != index.frameCounts().cend(); ++it) {
+      counts.frames.insert(it.key(), qint64(it.value()));
+    }
+    counts.payloadBytes = index.payloadBytes();
+    return counts;
+  }
+
+  Record record;
+  while (reader.next(record)) {
+    if (record.flags & TelemetryLog::Duplicate) {
+      continue;
+    }
+    if (record.segment == 0) {
+      ++counts.frames[record.canId];
+    } else {
+      quint32 &bytes = counts.payloadBytes[record.canId];
+      bytes = qMax<quint32>(bytes, (record.segment + 1u) * sizeof(record.payload));
+    }
+  }
+  return counts;
+}
+
+// One table's frames from one segment
+struct Bucket {
+  std::vector<Record> frames;    // First record of each frame
+  std::vector<quint8> payloads;  // FD tables: FD_PAYLOAD_BYTES per frame
+};
+
+// Frames of one segment, bucketed by table, timestamps made wall-clock ns.
+// The records after the first of a CAN FD frame are copied into its payload
+// in FD tables; decoded tables only use the first 8 bytes. Frames the count
+// pass did not see, e.g. when the segment grew since or its index is stale,
+// set @p mismatch and are left out.
+bool readSegment(const QString &path, const QHash<quint32, int> &tableOf,
+                 const std::vector<Table> &tables, std::vector<Bucket> &buckets,
+                 bool &mismatch, QString *error) {
+  for (Bucket &bucket : buckets) {
+    bucket.frames.clear();
+    bucket.payloads.clear();
+  }
+  TelemetryLogReader reader;
+  if (!reader.open(path, error)) {
+    return false;
+  }
+  Record record;
+  while (reader.next(record)) {
+    if (record.flags & TelemetryLog::Duplicate) {
+      continue;
+    }
+    const auto found = tableOf.constFind(record.canId);
+    if (found == tableOf.constEnd()) {
+      mismatch = true;
+      continue;
+    }
+    const int t = *found;
+    Bucket &bucket = buckets[t];
+    record.timestamp = reader.toWallClockNs(record.timestamp);
+    if (record.segment == 0) {
+      bucket.frames.push_back(record);
+      if (tables[t].kind == Table::FdRaw) {
+        bucket.payloads.resize(bucket.payloads.size() + FD_PAYLOAD_BYTES, 0);
+        std::memcpy(bucket.payloads.data() + bucket.payloads.size() - FD_PAYLOAD_BYTES,
+                    record.payload, sizeof(record.payload));
+      }
+      continue;
+    }
+    if (tables[t].kind == Table::Raw) {
+      mismatch = true; // Longer than the count pass said; the column is 8 bytes
+      continue;
+    }
+    if (tables[t].kind != Table::FdRaw ||
+        record.segment >= FD_PAYLOAD_BYTES / qsizetype(sizeof(record.payload))) {
+      continue;
+    }
+    // Records of other frames may sit in between, so look for the frame's
+    // first record from the newest back; it is almost always the last one.
+    // A frame whose first record closed the previous segment file keeps
+    // only those bytes.
+    for (size_t i = bucket.frames.size(); i-- > 0;) {
+      const Record &first = bucket.frames[i];
+      if (first.canId == record.canId && first.timestamp == record.timestamp &&
+          first.deviceTimestamp == record.deviceTimestamp &&
+          first.flags == record.flags) {
+        std::memcpy(bucket.payloads.data() + i * FD_PAYLOAD_BYTES +
+                        record.segment * sizeof(record.payload),
+                    record.payload, sizeof(record.payload));
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+qint64 align(qint64 offset) {
+  return (offset + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT;
+}
+
+} // namespace
+
+QStringList LogExporter::logFiles(const QString &logPath) {
+  const QFileInfo info(logPath);
+  if (!info.isDir()) {
+    return {logPath};
+  }
+
+  // Zero-padded segment numbers sort in recording order
+  const QDir session(logPath);
+  QStringList files;
+  for (const QString &name :
+       session.entryList({"segment_*.bin"}, QDir::Files, QDir::Name)) {
+    files.append(session.filePath(name));
+  }
+  return files;
+}
+
+bool LogExporter::exportCsv(const QString &logPath, const QString &outputDir,
+                            QString *error) {
+  const QStringList files = logFiles(logPath);
+  if (files.isEmpty()) {
+    if (error) {
+      *error = QString("No log segments in %1").arg(logPath);
+    }
+    return false;
+  }
+
+  QDir dir(outputDir);
+  if (!dir.exists() && !dir.mkpath(".")) {
+    if (error) {
+      *error = QString("Cannot create %1").arg(outputDir);
+    }
+    return false;
+  }
+
+  QFile imuFile;
+  QFile suspensionFile;
+  QTextStream imu;
+  QTextStream suspension;
+  if (!openCsv(imuFile, imu, dir.filePath("IMU_logger.csv"),
+               "timestamp,IMU_Ang_X,IMU_Ang_Y,IMU_Ang_Z", error) ||
+      !openCsv(suspensionFile, suspension, dir.filePath("suspension_logger.csv"),
+               "timestamp,SUS_1,SUS_2,SUS_3,SUS_4", error)) {
+    return false;
+  }
+
+  // One segment open at a time; a long session has many
+  TelemetryLogReader reader;
+  for (const QString &file : files) {
+    if (!reader.open(file, error)) {
+      return false;
+    }
+    exportRecords(reader, imu, suspension);
+  }
+
+  imu.flush();
+  suspension.flush();
+  if (imuFile.error() != QFileDevice::NoError ||
+      suspensionFile.error() != QFileDevice::NoError) {
+    if (error) {
+      *error = QString("Write failed in %1").arg(outputDir);
+    }
+    return false;
+  }
+  return true;
+}
+
+bool LogExporter::exportColumnar(const QString &logPath,
+                                 const QString &outputPath, QString *error,
+                                 int threads) {
+  const QStringList files = logFiles(logPath);
+  if (files.isEmpty()) {
+    setError(error, QString("No log segments in %1").arg(logPath));
+    return false;
+  }
+
+  SignalDatabase database;
+  QString databaseError;
+  if (!database.loadFile(SIGNAL_DATABASE_PATH, &databaseError)) {
+    setError(error, QString("%1: %2").arg(SIGNAL_DATABASE_PATH, databaseError));
+    return false;
+  }
+
+  QThreadPool pool;
+  if (threads > 0) {
+    pool.setMaxThreadCount(threads);
+  }
+
+  // Pass 1: frames per segment and CAN ID, which place every row
+  std::vector<SegmentCounts> counts(files.size());
+  for (qsizetype i = 0; i < files.size(); ++i) {
+    pool.start([&counts, &files, i] { counts[i] = countFrames(files[i]); });
+  }
+  pool.waitForDone();
+
+  QHash<quint32, qint64> totals;
+  QHash<quint32, quint32> payloadBytes;
+  for (const SegmentCounts &segment : counts) {
+    if (!segment.error.isEmpty()) {
+      setError(error, segment.error);
+      return false;
+    }
+    for (auto it = segment.frames.cbegin(); it != segment.frames.cend(); ++it) {
+      totals[it.key()] += it.value();
+    }
+    for (auto it = segment.payloadBytes.cbegin(); it != segment.payloadBytes.cend(); ++it) {
+      payloadBytes[it.key()] = qMax(payloadBytes.value(it.key()), it.value());
+    }
+  }
+
+  QList<quint32> ids = totals.keys();
+  std::sort(ids.begin(), ids.end());
+  std::vector<Table> tables(ids.size());
+  QHash<quint32, int> tableOf;
+  qint64 offset = align(sizeof(ColumnarHeader));
+  for (qsizetype t = 0; t < ids.size(); ++t) {
+    Table &table = tables[t];
+    table.canId = ids[t];
+    table.specs.assign(std::begin(TIME_COLUMNS), std::end(TIME_COLUMNS));
+    if (const SignalDatabase::MessageInfo *message = database.message(ids[t])) {
+      // Decoded messages are classic; their signals sit in the first 8 bytes
+      table.kind = Table::Decoded;
+      table.name = message->name;
+      for (const SignalDatabase::SignalInfo &signal : message->signalList) {
+        table.specs.push_back(signalColumn(signal));
+      }
+    } else {
+      // Raw IDs with longer frames keep them whole
+      table.kind = payloadBytes.value(ids[t]) > sizeof(Record::payload)
+                       ? Table::FdRaw
+                       : Table::Raw;
+      table.name = QString("id_%1").arg(ids[t], 8, 16, QChar('0'));
+      if (table.kind == Table::FdRaw) {
+        table.specs.insert(table.specs.end(), std::begin(FD_RAW_COLUMNS),
+                           std::end(FD_RAW_COLUMNS));
+      } else {
+        table.specs.insert(table.specs.end(), std::begin(RAW_COLUMNS),
+                           std::end(RAW_COLUMNS));
+      }
+    }
+    table.rows = totals.value(ids[t]);
+    for (const ColumnSpec &column : table.specs) {
+      table.offsets.push_back(offset);
+      offset = align(offset + table.rows * column.size);
+    }
+    tableOf.insert(ids[t], int(t));
+  }
+
+  // Directory, written after the columns
+  QJsonArray tableList;
+  for (const Table &table : tables) {
+    QJsonArray columnList;
+    for (size_t c = 0; c < table.specs.size(); ++c) {
+      const ColumnSpec &column = table.specs[c];
+      columnList.append(QJsonObject{{"name", column.name},
+                                    {"type", column.type},
+                                    {"offset", table.offsets[c]},
+                                    {"unit", column.unit}});
+    }
+    tableList.append(QJsonObject{{"name", table.name},
+                                 {"canId", qint64(table.canId)},
+                                 {"rows", table.rows},
+                                 {"columns", columnList}});
+  }
+  const QByteArray directory =
+      QJsonDocument(QJsonObject{{"version", int(COLUMNAR_VERSION)},
+                                {"source", QFileInfo(logPath).fileName()},
+                                {"tables", tableList}})
+          .toJson(QJsonDocument::Compact);
+
+  ColumnarHeader header = {};
+  std::memcpy(header.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+  header.version = COLUMNAR_VERSION;
+  header.tableCount = quint32(tables.size());
+  header.directoryOffset = offset;
+  header.directorySize = directory.size();
+
+  // Tasks write their rows straight into the mapped file
+  QFile output(outputPath);
+  uchar *mapped = nullptr;
+  const qint64 fileSize = offset + directory.size();
+  if (!output.open(QIODevice::ReadWrite | QIODevice::Truncate) ||
+      !output.resize(fileSize) ||
+      !(mapped = output.map(0, fileSize))) {
+    setError(error, QString("%1: %2").arg(outputPath, output.errorString()));
+    output.remove();
+    return false;
+  }
+  std::memcpy(mapped, &header, sizeof(header));
+  std::memcpy(mapped + offset, directory.constData(), directory.size());
+  for (Table &table : tables) {
+    for (qint64 columnOffset : table.offsets) {
+      table.columns.push_back(reinterpret_cast<char *>(mapped + columnOffset));
+    }
+  }
+
+  // Pass 2: decode each segment's CAN IDs in parallel while reading the next
+  std::vector<Bucket> buckets[2];
+  buckets[0].resize(tables.size());
+  buckets[1].resize(tables.size());
+  std::vector<qint64> nextRow(tables.size(), 0);
+  bool mismatch = false;
+  bool ok = readSegment(files[0], tableOf, tables, buckets[0], mismatch, error);
+  for (qsizetype s = 0; ok && s < files.size(); ++s) {
+    const std::vector<Bucket> &segment = buckets[s % 2];
+    for (size_t t = 0; t < tables.size(); ++t) {
+      if (segment[t].frames.empty()) {
+        continue;
+      }
+      const qint64 firstRow = nextRow[t];
+      nextRow[t] += qint64(segment[t].frames.size());
+      if (nextRow[t] > tables[t].rows) {
+        mismatch = true; // More frames than counted; never write past a column
+        continue;
+      }
+      pool.start([&table = tables[t], &bucket = segment[t], &database, firstRow] {
+        const std::vector<Record> &records = bucket.frames;
+        char *const *columns = table.columns.data();
+        char *const *signalColumns = columns + TIME_COLUMN_COUNT;
+        const ColumnSpec *signalSpecs = table.specs.data() + TIME_COLUMN_COUNT;
+        double values[MAX_SIGNALS];
+        for (qsizetype i = 0; i < qsizetype(records.size()); ++i) {
+          const qint64 row = firstRow + i;
+          put(columns[0], row, records[i].timestamp);
+          put(columns[1], row, records[i].deviceTimestamp);
+          switch (table.kind) {
+          case Table::Decoded: {
+            const int count = database.decode(table.canId, records[i].payload,
+                                              values, MAX_SIGNALS);
+            for (int c = 0; c < count; ++c) {
+              putValue(signalColumns[c], row, signalSpecs[c], values[c]);
+            }
+            break;
+          }
+          case Table::Raw:
+            decodeRaw(records[i], signalColumns, row);
+            break;
+          case Table::FdRaw:
+            decodeFdRaw(records[i], bucket.payloads.data() + i * FD_PAYLOAD_BYTES,
+                        signalColumns, row);
+            break;
+          }
+        }
+      });
+    }
+    if (s + 1 < files.size()) {
+      ok = readSegment(files[s + 1], tableOf, tables, buckets[(s + 1) % 2],
+                       mismatch, error);
+    }
+    pool.waitForDone();
+  }
+  for (size_t t = 0; ok && t < tables.size(); ++t) {
+    mismatch = mismatch || nextRow[t] != tables[t].rows;
+  }
+  if (ok && mismatch) {
+    setError(error, QString("%1 changed during the export, or its segment indexes are out of date").arg(logPath));
+    ok = false;
+  }
+
+  output.unmap(mapped);
+  output.close();
+  if (ok && output.error() != QFileDevice::NoError) {
+    setError(error, QString("%1: %2").arg(outputPath, output.errorString()));
+    ok = false;
+  }
+  if (!ok) {
+    output.remove();
+  }
+  return ok;
+}
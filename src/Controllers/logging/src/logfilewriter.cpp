@@ -0,0 +1,159 @@
+#include "../include/logfilewriter.h"
+#include <QtGlobal>
+#include <cerrno>
+
+#ifdef Q_OS_UNIX
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+LogFileWriter::LogFileWriter() : LogFileWriter(FlushPolicy()) {}
+
+LogFileWriter::LogFileWriter(const FlushPolicy &policy)
+    : m_policy(policy), m_activeChunk(0), m_bufferedBytes(0),
+      m_bytesWritten(0), m_flushCount(0) {}
+
+LogFileWriter::~LogFileWriter() { close(); }
+
+bool LogFileWriter::open(const QString &path, qint64 capacity) {
+  Q_UNUSED(capacity); // The file grows as it is written
+  close();
+
+  // Unbuffered: the chunks are the buffer, and writev() goes to the descriptor
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::NewOnly |
+                   QIODevice::Unbuffered)) {
+    return false;
+  }
+
+  // Enough chunks for one threshold's worth of data, allocated once
+  const qint64 chunkCount =
+      qMax<qint64>(1, (m_policy.maxBufferedBytes + CHUNK_SIZE - 1) / CHUNK_SIZE);
+  m_chunks.resize(chunkCount);
+  for (QByteArray &chunk : m_chunks) {
+    chunk.reserve(CHUNK_SIZE);
+  }
+  m_activeChunk = 0;
+  m_bufferedBytes = 0;
+  m_bytesWritten = 0;
+  m_flushCount = 0;
+  m_error.clear();
+  return true;
+}
+
+void LogFileWriter::close() {
+  if (!m_file.isOpen()) {
+    return;
+  }
+  flush();
+  m_file.close();
+  m_chunks.clear();
+}
+
+bool LogFileWriter::append(const void *data, qsizetype size) {
+  const char *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    if (m_chunks[m_activeChunk].size() == CHUNK_SIZE) {
+      if (++m_activeChunk == m_chunks.size()) {
+        m_chunks.emplace_back(); // Only when one append overshoots the threshold
+        m_chunks.back().reserve(CHUNK_SIZE);
+      }
+      continue;
+    }
+    QByteArray &chunk = m_chunks[m_activeChunk];
+    const qsizetype part = qMin(size, CHUNK_SIZE - chunk.size());
+    chunk.append(bytes, part);
+    bytes += part;
+    size -= part;
+    m_bufferedBytes += part;
+  }
+  return m_bufferedBytes < m_policy.maxBufferedBytes || flush();
+}
+
+bool LogFileWriter::flush() {
+  if (m_bufferedBytes == 0) {
+    return true;
+  }
+
+  bool ok = m_file.isOpen() && writeChunks();
+#ifdef Q_OS_UNIX
+  if (ok && m_policy.syncToDisk) {
+#ifdef Q_OS_LINUX
+    ok = ::fdatasync(m_file.handle()) == 0;
+#else
+    ok = ::fsync(m_file.handle()) == 0;
+#endif
+    if (!ok) {
+      m_error = qt_error_string(errno);
+    }
+  }
+#endif
+
+  // Reuse the chunks; on failure the buffered data is dropped rather than
+  // letting the buffer grow without bound
+  for (std::size_t i = 0; i <= m_activeChunk; ++i) {
+    m_chunks[i].resize(0); // Keeps the capacity
+  }
+  m_activeChunk = 0;
+  m_bufferedBytes = 0;
+  ++m_flushCount;
+  return ok;
+}
+
+bool LogFileWriter::writeChunks() {
+#ifdef Q_OS_UNIX
+  static constexpr int MAX_IOV = 64;
+  const int fd = m_file.handle();
+
+  // Resume point: chunk index and offset into it, for partial writes
+  std::size_t chunk = 0;
+  qsizetype offset = 0;
+  while (chunk <= m_activeChunk) {
+    iovec iov[MAX_IOV];
+    int count = 0;
+    for (std::size_t c = chunk; c <= m_activeChunk && count < MAX_IOV; ++c) {
+      const qsizetype start = c == chunk ? offset : 0;
+      if (m_chunks[c].size() > start) {
+        iov[count].iov_base = const_cast<char *>(m_chunks[c].constData()) + start;
+        iov[count].iov_len = static_cast<size_t>(m_chunks[c].size() - start);
+        ++count;
+      }
+    }
+    if (count == 0) {
+      break;
+    }
+
+    const ssize_t written = ::writev(fd, iov, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      m_error = qt_error_string(errno);
+      return false;
+    }
+    m_bytesWritten += written;
+
+    for (qsizetype remaining = written; remaining > 0;) {
+      const qsizetype left = m_chunks[chunk].size() - offset;
+      if (remaining < left) {
+        offset += remaining;
+        break;
+      }
+      remaining -= left;
+      ++chunk;
+      offset = 0;
+    }
+  }
+  return true;
+#else
+  for (std::size_t i = 0; i <= m_activeChunk; ++i) {
+    const QByteArray &chunk = m_chunks[i];
+    if (m_file.write(chunk) != chunk.size()) {
+      m_error = m_file.errorString();
+      return false;
+    }
+    m_bytesWritten += chunk.size();
+  }
+  return true;
+#endif
+}
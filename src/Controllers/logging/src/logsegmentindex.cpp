@@ -0,0 +1,147 @@
+#include "../include/logsegmentindex.h"
+#include <QFile>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace {
+
+void setError(QString *error, const QString &message) {
+  if (error) {
+    *error = message;
+  }
+}
+
+} // namespace
+
+LogSegmentIndex::LogSegmentIndex(int seekIntervalMs)
+    : m_seekIntervalMs(qBound(1, seekIntervalMs, 0xFFFF)) {
+  clear();
+}
+
+void LogSegmentIndex::clear() {
+  m_firstTimestamp = 0;
+  m_lastTimestamp = 0;
+  m_nextSeekTime = std::numeric_limits<qint64>::min();
+  m_recordCount = 0;
+  m_frameCounts.clear();
+  m_payloadBytes.clear();
+  m_seekPoints.clear();
+}
+
+void LogSegmentIndex::add(const TelemetryLog::Record &record, qint64 offset) {
+  if (m_recordCount == 0) {
+    m_firstTimestamp = record.timestamp;
+    m_lastTimestamp = record.timestamp;
+  } else {
+    m_firstTimestamp = qMin(m_firstTimestamp, record.timestamp);
+    m_lastTimestamp = qMax(m_lastTimestamp, record.timestamp);
+  }
+  ++m_recordCount;
+
+  if (!(record.flags & TelemetryLog::Duplicate)) {
+    if (record.segment == 0) {
+      ++m_frameCounts[record.canId];
+    } else {
+      quint32 &bytes = m_payloadBytes[record.canId];
+      bytes = qMax<quint32>(bytes, (record.segment + 1u) * sizeof(record.payload));
+    }
+  }
+
+  // First record of each interval; continuation records are not a place to start
+  if (record.segment == 0 && record.timestamp >= m_nextSeekTime) {
+    const qint64 intervalNs = qint64(m_seekIntervalMs) * 1000000;
+    m_seekPoints.append({record.timestamp, offset});
+    m_nextSeekTime = record.timestamp - record.timestamp % intervalNs + intervalNs;
+  }
+}
+
+bool LogSegmentIndex::save(const QString &path, QString *error) const {
+  FileHeader header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.seekIntervalMs = static_cast<quint16>(m_seekIntervalMs);
+  header.idCount = static_cast<quint32>(m_frameCounts.size());
+  header.seekCount = static_cast<quint32>(m_seekPoints.size());
+  header.firstTimestamp = m_firstTimestamp;
+  header.lastTimestamp = m_lastTimestamp;
+  header.recordCount = m_recordCount;
+
+  std::vector<IdCount> ids;
+  ids.reserve(m_frameCounts.size());
+  for (auto it = m_frameCounts.cbegin(); it != m_frameCounts.cend(); ++it) {
+    ids.push_back({it.key(),
+                   m_payloadBytes.value(it.key(), quint32(sizeof(TelemetryLog::Record::payload))),
+                   it.value()});
+  }
+  std::sort(ids.begin(), ids.end(),
+            [](const IdCount &a, const IdCount &b) { return a.canId < b.canId; });
+
+  QFile file(path);
+  const qint64 idBytes = qint64(ids.size() * sizeof(IdCount));
+  const qint64 seekBytes = qint64(m_seekPoints.size() * sizeof(SeekPoint));
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+      file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header) ||
+      file.write(reinterpret_cast<const char *>(ids.data()), idBytes) != idBytes ||
+      file.write(reinterpret_cast<const char *>(m_seekPoints.constData()), seekBytes) != seekBytes) {
+    setError(error, QString("%1: %2").arg(path, file.errorString()));
+    return false;
+  }
+  return true;
+}
+
+bool LogSegmentIndex::load(const QString &path, QString *error) {
+  clear();
+
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    setError(error, QString("%1: %2").arg(path, file.errorString()));
+    return false;
+  }
+
+  FileHeader header;
+  if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header) ||
+      std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    setError(error, QString("%1 is not a segment index").arg(path));
+    return false;
+  }
+  if (header.version != VERSION) {
+    setError(error, QString("%1 has unsupported version %2").arg(path).arg(header.version));
+    return false;
+  }
+  if (file.size() != qint64(sizeof(header)) + qint64(header.idCount) * qint64(sizeof(IdCount)) +
+                         qint64(header.seekCount) * qint64(sizeof(SeekPoint))) {
+    setError(error, QString("%1 is truncated").arg(path));
+    return false;
+  }
+
+  m_frameCounts.reserve(header.idCount);
+  for (quint32 i = 0; i < header.idCount; ++i) {
+    IdCount id;
+    file.read(reinterpret_cast<char *>(&id), sizeof(id));
+    m_frameCounts.insert(id.canId, id.frames);
+    if (id.payloadBytes > sizeof(TelemetryLog::Record::payload)) {
+      m_payloadBytes.insert(id.canId, id.payloadBytes);
+    }
+  }
+  m_seekPoints.resize(header.seekCount);
+  file.read(reinterpret_cast<char *>(m_seekPoints.data()), qint64(header.seekCount) * qint64(sizeof(SeekPoint)));
+
+  m_seekIntervalMs = qMax<int>(1, header.seekIntervalMs);
+  m_firstTimestamp = header.firstTimestamp;
+  m_lastTimestamp = header.lastTimestamp;
+  m_recordCount = header.recordCount;
+  return true;
+}
+
+qint64 LogSegmentIndex::offsetFor(qint64 timestamp) const {
+  if (m_seekPoints.isEmpty()) {
+    return -1;
+  }
+  // Seek points are in time order: the last one not after timestamp
+  auto it = std::upper_bound(m_seekPoints.cbegin(), m_seekPoints.cend(), timestamp,
+                             [](qint64 time, const SeekPoint &point) { return time < point.timestamp; });
+  return it == m_seekPoints.cbegin() ? it->offset : std::prev(it)->offset;
+}
@@ -0,0 +1,159 @@
+#include "../include/mappedlogwriter.h"
+#include <QFile>
+#include <cerrno>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+MappedLogWriter::MappedLogWriter() : MappedLogWriter(FlushPolicy()) {}
+
+MappedLogWriter::MappedLogWriter(const FlushPolicy &policy)
+    : m_policy(policy), m_fd(-1), m_data(nullptr), m_capacity(0), m_size(0),
+      m_flushedSize(0), m_flushCount(0), m_lengthOffset(-1) {}
+
+MappedLogWriter::~MappedLogWriter() { close(); }
+
+bool MappedLogWriter::isSupported() {
+#ifdef Q_OS_UNIX
+  return true;
+#else
+  return false;
+#endif
+}
+
+#ifdef Q_OS_UNIX
+
+bool MappedLogWriter::open(const QString &path, qint64 capacity) {
+  close();
+  m_error.clear();
+
+  // Whole pages, so the mapping covers the file exactly
+  const qint64 pageSize = ::sysconf(_SC_PAGESIZE);
+  capacity = qMax<qint64>(pageSize, (capacity + pageSize - 1) / pageSize * pageSize);
+
+  m_fd = ::open(QFile::encodeName(path).constData(),
+                O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (m_fd < 0) {
+    m_error = qt_error_string(errno);
+    return false;
+  }
+
+  // Reserve the blocks now: no allocation on the write path, and a full disk
+  // shows up here instead of as SIGBUS on a store
+#ifdef Q_OS_LINUX
+  const int reserved = ::posix_fallocate(m_fd, 0, capacity);
+#else
+  const int reserved = ::ftruncate(m_fd, capacity) == 0 ? 0 : errno;
+#endif
+  void *data = MAP_FAILED;
+  if (reserved == 0) {
+    data = ::mmap(nullptr, size_t(capacity), PROT_READ | PROT_WRITE, MAP_SHARED,
+                  m_fd, 0);
+  }
+  if (data == MAP_FAILED) {
+    m_error = qt_error_string(reserved != 0 ? reserved : errno);
+    ::close(m_fd);
+    m_fd = -1;
+    return false;
+  }
+
+  m_data = static_cast<char *>(data);
+  m_capacity = capacity;
+  m_size = 0;
+  m_flushedSize = 0;
+  m_flushCount = 0;
+  m_lengthOffset = -1;
+  return true;
+}
+
+void MappedLogWriter::close() {
+  if (!m_data) {
+    return;
+  }
+  flush();
+  ::munmap(m_data, size_t(m_capacity));
+  m_data = nullptr;
+
+  // Trim the unused preallocation; the committed length already says the same
+  if (::ftruncate(m_fd, m_size) != 0 ||
+      (m_policy.syncToDisk && ::fsync(m_fd) != 0)) {
+    m_error = qt_error_string(errno);
+  }
+  ::close(m_fd);
+  m_fd = -1;
+}
+
+bool MappedLogWriter::sync(qint64 from, qint64 to) {
+  // msync() wants a page-aligned start
+  const qint64 pageSize = ::sysconf(_SC_PAGESIZE);
+  const qint64 start = from / pageSize * pageSize;
+  if (::msync(m_data + start, size_t(to - start),
+              m_policy.syncToDisk ? MS_SYNC : MS_ASYNC) != 0) {
+    m_error = qt_error_string(errno);
+    return false;
+  }
+  return true;
+}
+
+#else
+
+bool MappedLogWriter::open(const QString &path, qint64 capacity) {
+  Q_UNUSED(path);
+  Q_UNUSED(capacity);
+  m_error = QStringLiteral("Memory-mapped logging is not supported on this platform");
+  return false;
+}
+
+void MappedLogWriter::close() {}
+
+bool MappedLogWriter::sync(qint64 from, qint64 to) {
+  Q_UNUSED(from);
+  Q_UNUSED(to);
+  return false;
+}
+
+#endif
+
+bool MappedLogWriter::append(const void *data, qsizetype size) {
+  if (!m_data || size > m_capacity - m_size) {
+    if (m_data) {
+      m_error = QStringLiteral("Preallocated log space is used up");
+    }
+    return false;
+  }
+
+  std::memcpy(m_data + m_size, data, size_t(size));
+  m_size += size;
+  publishLength();
+  return bufferedBytes() < m_policy.maxBufferedBytes || flush();
+}
+
+bool MappedLogWriter::flush() {
+  if (!m_data || bufferedBytes() == 0) {
+    return true;
+  }
+
+  bool ok = sync(m_flushedSize, m_size);
+  if (ok && m_lengthOffset >= 0 && m_lengthOffset < m_flushedSize) {
+    ok = sync(m_lengthOffset, m_lengthOffset + qint64(sizeof(qint64)));
+  }
+  m_flushedSize = m_size;
+  ++m_flushCount;
+  return ok;
+}
+
+void MappedLogWriter::trackCommittedLength(qint64 offset) {
+  m_lengthOffset = offset;
+  publishLength();
+}
+
+void MappedLogWriter::publishLength() {
+  // A plain store after the data it covers
+  if (m_lengthOffset >= 0 && m_lengthOffset + qint64(sizeof(qint64)) <= m_size) {
+    std::memcpy(m_data + m_lengthOffset, &m_size, sizeof(m_size));
+  }
+}
@@ -0,0 +1,271 @@
+#include "../include/telemetrylog.h"
+#include "../include/logblockcodec.h"
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+using Record = TelemetryLog::Record;
+
+struct RecordField {
+  const char *name;
+  quint16 offset;
+  quint16 size;
+  TelemetryLog::FieldType type;
+};
+
+// Schema of this version's records, in TelemetryLogReader::KnownField order
+constexpr RecordField RECORD_FIELDS[] = {
+    {"timestampNs", offsetof(Record, timestamp), sizeof(Record::timestamp), TelemetryLog::Int},
+    {"canId", offsetof(Record, canId), sizeof(Record::canId), TelemetryLog::UInt},
+    {"dlc", offsetof(Record, dlc), sizeof(Record::dlc), TelemetryLog::UInt},
+    {"flags", offsetof(Record, flags), sizeof(Record::flags), TelemetryLog::UInt},
+    {"payload", offsetof(Record, payload), sizeof(Record::payload), TelemetryLog::Bytes},
+    {"segment", offsetof(Record, segment), sizeof(Record::segment), TelemetryLog::UInt},
+    {"deviceTime", offsetof(Record, deviceTimestamp), sizeof(Record::deviceTimestamp), TelemetryLog::UInt},
+};
+constexpr int FIELD_COUNT = sizeof(RECORD_FIELDS) / sizeof(RECORD_FIELDS[0]);
+
+static_assert(sizeof(MonotonicClock::Anchor) == 16, "Anchor layout is part of the file format");
+
+void setError(QString *error, const QString &message) {
+  if (error) {
+    *error = message;
+  }
+}
+
+} // namespace
+
+qint64 TelemetryLog::committedLengthOffset() {
+  return sizeof(FileHeader) + FIELD_COUNT * sizeof(FieldInfo);
+}
+
+qint64 TelemetryLog::clockAnchorOffset() {
+  return committedLengthOffset() + sizeof(qint64);
+}
+
+QByteArray TelemetryLog::header(const MonotonicClock::Anchor &anchor, bool compressed) {
+  // The committed length after the field table starts as 0 = whole file
+  QByteArray bytes(clockAnchorOffset() + sizeof(anchor), '\0');
+
+  FileHeader fileHeader = {};
+  std::memcpy(fileHeader.magic, compressed ? COMPRESSED_MAGIC : MAGIC, sizeof(MAGIC));
+  fileHeader.version = VERSION;
+  fileHeader.headerSize = static_cast<quint16>(bytes.size());
+  fileHeader.recordSize = sizeof(Record);
+  fileHeader.fieldCount = FIELD_COUNT;
+  fileHeader.createdMs = anchor.wallNs / 1000000;
+  std::memcpy(bytes.data(), &fileHeader, sizeof(fileHeader));
+  std::memcpy(bytes.data() + clockAnchorOffset(), &anchor, sizeof(anchor));
+
+  for (int i = 0; i < FIELD_COUNT; ++i) {
+    FieldInfo field = {};
+    std::strncpy(field.name, RECORD_FIELDS[i].name, FIELD_NAME_SIZE);
+    field.offset = RECORD_FIELDS[i].offset;
+    field.size = RECORD_FIELDS[i].size;
+    field.type = RECORD_FIELDS[i].type;
+    std::memcpy(bytes.data() + sizeof(FileHeader) + i * sizeof(FieldInfo), &field, sizeof(field));
+  }
+  return bytes;
+}
+
+TelemetryLogReader::TelemetryLogReader() = default;
+
+TelemetryLogReader::~TelemetryLogReader() = default;
+
+bool TelemetryLogReader::open(const QString &path, QString *error) {
+  static_assert(FIELD_COUNT == KnownFieldCount, "RECORD_FIELDS and KnownField are out of step");
+  close();
+
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadOnly)) {
+    setError(error, m_file.errorString());
+    return false;
+  }
+
+  TelemetryLog::FileHeader fileHeader;
+  if (m_file.read(reinterpret_cast<char *>(&fileHeader), sizeof(fileHeader)) != sizeof(fileHeader) ||
+      (std::memcmp(fileHeader.magic, TelemetryLog::MAGIC, sizeof(TelemetryLog::MAGIC)) != 0 &&
+       std::memcmp(fileHeader.magic, TelemetryLog::COMPRESSED_MAGIC, sizeof(TelemetryLog::MAGIC)) != 0)) {
+    setError(error, QString("%1 is not a telemetry log").arg(path));
+    close();
+    return false;
+  }
+  const bool compressed =
+      std::memcmp(fileHeader.magic, TelemetryLog::COMPRESSED_MAGIC, sizeof(TelemetryLog::MAGIC)) == 0;
+
+  const qint64 tableEnd =
+      qint64(sizeof(fileHeader)) + qint64(fileHeader.fieldCount) * qint64(sizeof(TelemetryLog::FieldInfo));
+  if (fileHeader.recordSize == 0 || fileHeader.headerSize < tableEnd) {
+    setError(error, QString("%1 has a corrupt header").arg(path));
+    close();
+    return false;
+  }
+  // LogBlockCodec's delta coding knows this version's layout only
+  if (compressed && fileHeader.recordSize != sizeof(TelemetryLog::Record)) {
+    setError(error, QString("%1 is compressed with an unsupported record layout").arg(path));
+    close();
+    return false;
+  }
+
+  // Map the fields this version knows onto the file's layout
+  for (int i = 0; i < fileHeader.fieldCount; ++i) {
+    TelemetryLog::FieldInfo field;
+    if (m_file.read(reinterpret_cast<char *>(&field), sizeof(field)) != sizeof(field)) {
+      setError(error, QString("%1 has a truncated header").arg(path));
+      close();
+      return false;
+    }
+    if (quint32(field.offset) + field.size > fileHeader.recordSize) {
+      continue; // Would read past the record
+    }
+    for (int known = 0; known < FIELD_COUNT; ++known) {
+      if (std::strncmp(field.name, RECORD_FIELDS[known].name, TelemetryLog::FIELD_NAME_SIZE) == 0) {
+        m_fields[known].offset = field.offset;
+        m_fields[known].size = qMin(field.size, RECORD_FIELDS[known].size);
+        break;
+      }
+    }
+  }
+  if (m_fields[CanId].size == 0) {
+    setError(error, QString("%1 has no CAN ID field").arg(path));
+    close();
+    return false;
+  }
+
+  // The committed length and the clock anchor follow the field table
+  qint64 committed = 0;
+  MonotonicClock::Anchor anchor = {};
+  if (fileHeader.headerSize < tableEnd + qint64(sizeof(committed) + sizeof(anchor)) ||
+      m_file.read(reinterpret_cast<char *>(&committed), sizeof(committed)) != sizeof(committed) ||
+      m_file.read(reinterpret_cast<char *>(&anchor), sizeof(anchor)) != sizeof(anchor)) {
+    setError(error, QString("%1 has a truncated header").arg(path));
+    close();
+    return false;
+  }
+  qint64 dataEnd = m_file.size();
+  if (committed > 0) {
+    dataEnd = qMin(dataEnd, committed);
+  }
+
+  m_version = fileHeader.version;
+  m_createdMs = fileHeader.createdMs;
+  m_anchor = anchor;
+  m_headerSize = fileHeader.headerSize;
+  m_recordSize = fileHeader.recordSize;
+  m_recordCount = qMax<qint64>(0, (dataEnd - fileHeader.headerSize) / m_recordSize);
+  m_nextRecord = 0;
+  m_dataEnd = dataEnd;
+  m_buffer.resize(m_recordSize);
+
+  if (compressed) {
+    // Count the records by walking the block headers, up to the last whole block
+    m_codec = std::make_unique<LogBlockCodec>();
+    m_recordCount = 0;
+    qint64 position = fileHeader.headerSize;
+    LogBlockCodec::BlockHeader block;
+    while (position + qint64(sizeof(block)) <= dataEnd && m_file.seek(position) &&
+           m_file.read(reinterpret_cast<char *>(&block), sizeof(block)) == sizeof(block) &&
+           std::memcmp(block.magic, LogBlockCodec::BLOCK_MAGIC, sizeof(block.magic)) == 0 &&
+           position + qint64(sizeof(block)) + block.compressedSize <= dataEnd) {
+      m_recordCount += block.recordCount;
+      position += qint64(sizeof(block)) + block.compressedSize;
+    }
+    m_dataEnd = position;
+  }
+  return m_file.seek(fileHeader.headerSize);
+}
+
+void TelemetryLogReader::close() {
+  m_file.close();
+  for (FieldMap &field : m_fields) {
+    field = FieldMap();
+  }
+  m_anchor = {};
+  m_createdMs = 0;
+  m_recordCount = 0;
+  m_nextRecord = 0;
+  m_dataEnd = 0;
+  m_codec.reset();
+  m_block.clear();
+  m_blockPosition = 0;
+  m_version = 0;
+  m_headerSize = 0;
+  m_recordSize = 0;
+}
+
+bool TelemetryLogReader::next(TelemetryLog::Record &record) {
+  const char *in;
+  if (m_codec) {
+    if (m_blockPosition == qsizetype(m_block.size()) && !readBlock()) {
+      return false;
+    }
+    in = reinterpret_cast<const char *>(&m_block[m_blockPosition++]);
+  } else {
+    if (!m_file.isOpen() || m_nextRecord >= m_recordCount ||
+        m_file.read(m_buffer.data(), m_recordSize) != m_recordSize) {
+      return false;
+    }
+    ++m_nextRecord;
+    in = m_buffer.constData();
+  }
+
+  record = TelemetryLog::Record();
+  char *out = reinterpret_cast<char *>(&record);
+  for (int i = 0; i < KnownFieldCount; ++i) {
+    if (m_fields[i].size != 0) {
+      std::memcpy(out + RECORD_FIELDS[i].offset, in + m_fields[i].offset, m_fields[i].size);
+    }
+  }
+  return true;
+}
+
+bool TelemetryLogReader::readBlock() {
+  m_block.clear();
+  m_blockPosition = 0;
+
+  LogBlockCodec::BlockHeader header;
+  const qint64 position = m_file.pos();
+  if (!m_file.isOpen() || position + qint64(sizeof(header)) > m_dataEnd ||
+      m_file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header) ||
+      std::memcmp(header.magic, LogBlockCodec::BLOCK_MAGIC, sizeof(header.magic)) != 0 ||
+      position + qint64(sizeof(header)) + header.compressedSize > m_dataEnd ||
+      header.recordCount > quint32(LogBlockCodec::RECORDS_PER_BLOCK)) {
+    return false;
+  }
+
+  m_blockData.resize(header.compressedSize);
+  m_block.resize(header.recordCount);
+  if (m_file.read(m_blockData.data(), m_blockData.size()) != m_blockData.size() ||
+      !m_codec->decode(header, m_blockData.constData(), m_block.data())) {
+    m_block.clear();
+    return false;
+  }
+  return !m_block.empty();
+}
+
+bool TelemetryLogReader::seek(qint64 offset) {
+  if (m_codec) {
+    if (!m_file.isOpen() || offset < m_headerSize || offset >= m_dataEnd) {
+      return false;
+    }
+    // Must land on a block header; otherwise keep reading where we were
+    const qint64 position = m_file.pos();
+    char magic[sizeof(LogBlockCodec::BLOCK_MAGIC)];
+    const bool atBlock = m_file.seek(offset) && m_file.read(magic, sizeof(magic)) == sizeof(magic) &&
+                         std::memcmp(magic, LogBlockCodec::BLOCK_MAGIC, sizeof(magic)) == 0;
+    if (!m_file.seek(atBlock ? offset : position) || !atBlock) {
+      return false;
+    }
+    m_block.clear();
+    m_blockPosition = 0;
+    return true;
+  }
+
+  if (!m_file.isOpen() || offset < m_headerSize ||
+      (offset - m_headerSize) % m_recordSize != 0 || !m_file.seek(offset)) {
+    return false;
+  }
+  m_nextRecord = (offset - m_headerSize) / m_recordSize;
+  return true;
+}
@@ -2,12 +2,17 @@
 #define MQTTPARSERWORKER_H
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QMutex>
 #include <QObject>
-#include <QQueue>
 #include <QRunnable>
 #include <QWaitCondition>
 #include <atomic>
+#include "../../telemetry/include/framededuplicator.h"
+#include "../../telemetry/include/frameerrorcounters.h"
+#include "../../telemetry/include/packetring.h"
+#include "../../telemetry/include/telemetrydispatch.h"
+#include "../../telemetry/include/telemetrystate.h"
 
 /**
  * @brief The MqttParserWorker class parses MQTT messages in a thread pool
@@ -19,14 +24,17 @@ class MqttParserWorker : public QObject, public QRunnable {
   Q_OBJECT
 
 public:
-  explicit MqttParserWorker(bool debugMode = false, QObject *parent = nullptr);
-  ~MqttParserWorker();
-
   /**
-   * @brief Reset all shared static state values to defaults
-   * Call this when stopping the MQTT client to prevent stale data on reconnect
+   * @param state Shared state that parsed values are written into
+   * @param deduplicator Cross-link frame arbitration, or nullptr for none
+   * @param errors Where rejected frames are counted, or nullptr for none
+   * @param sourceId This transport's index in @p deduplicator
    */
-  static void resetSharedState();
+  explicit MqttParserWorker(TelemetryState *state,
+                            FrameDeduplicator *deduplicator,
+                            FrameErrorCounters *errors, int sourceId,
+                            bool debugMode = false, QObject *parent = nullptr);
+  ~MqttParserWorker();
 
   /**
    * @brief Implement QRunnable interface
@@ -34,73 +42,47 @@ public:
    */
   void run() override;
 
-public slots:
   /**
-   * @brief Queue a message for parsing
-   * @param data The message data to parse
+   * @brief Number of messages that updated the shared state
    */
-  void queueMessage(const QByteArray &data);
+  quint64 messagesParsed() const {
+    return m_messagesParsed.load(std::memory_order_relaxed);
+  }
 
   /**
-   * @brief Stop the parser worker
+   * @brief Parse a single message on the calling thread
+   *
+   * run() calls this for every queued message; the benchmarks call it
+   * directly to time the parse path without the queue.
+   * @param data The message data to parse
    */
-  void stop();
+  void parseMessage(QByteArrayView data);
 
-signals:
+public slots:
   /**
-   * @brief Signal emitted when a message is successfully parsed
+   * @brief Queue a message for parsing
+   * @param data The message data to parse
    */
-  void messageParsed(float speed, int rpm, int accPedal, int brakePedal,
-                     double encoderAngle, float temperature, int batteryLevel,
-                     double gpsLongitude, double gpsLatitude, int speedFL,
-                     int speedFR, int speedBL, int speedBR, double lateralG,
-                     double longitudinalG, int tempFL, int tempFR, int tempBL,
-                     int tempBR);
+  void queueMessage(const QByteArray &data);
 
   /**
-   * @brief Signal emitted when an error occurs during parsing
-   * @param error The error message
+   * @brief Stop the parser worker
    */
-  void errorOccurred(const QString &error);
+  void stop();
 
 private:
-  /**
-   * @brief Parse a single message
-   * @param data The message data to parse
-   */
-  void parseMessage(const QByteArray &data);
-
+  TelemetryState *m_state;
+  TelemetryDispatch::Source m_source; // State slot, arbitration, error counters and link index
   bool m_debugMode;
   std::atomic<bool> m_running;
   std::atomic<quint64> m_messagesParsed;
 
-  // Thread-safe queue for messages
-  QQueue<QByteArray> m_queue;
+  // Messages waiting to be parsed; guarded by m_queueMutex
+  static constexpr int MAX_QUEUE_DEPTH = 50;
+  PacketRing<MAX_QUEUE_DEPTH> m_queue;
   QMutex m_queueMutex;
   QWaitCondition m_queueCondition;
 
-  // Shared state across all parser instances
-  // All values are static so all parser workers share the same state
-  static QMutex s_stateMutex;
-  static float s_speed;
-  static int s_rpm;
-  static int s_accPedal;
-  static int s_brakePedal;
-  static double s_encoderAngle;
-  static float s_temperature;
-  static int s_batteryLevel;
-  static double s_gpsLongitude;
-  static double s_gpsLatitude;
-  static int s_speedFL;
-  static int s_speedFR;
-  static int s_speedBL;
-  static int s_speedBR;
-  static double s_lateralG;
-  static double s_longitudinalG;
-  static int s_tempFL;
-  static int s_tempFR;
-  static int s_tempBL;
-  static int s_tempBR;
 };
 
 #endif // MQTTPARSERWORKER_H
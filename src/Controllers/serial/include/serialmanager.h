@@ -8,6 +8,9 @@
 #include <QAtomicInt>
 #include <QTimer>
 #include <atomic>
+#include "../../telemetry/include/framededuplicator.h"
+#include "../../telemetry/include/frameerrorcounters.h"
+#include "../../telemetry/include/telemetrystate.h"
 
 // Forward declarations
 class SerialReceiverWorker;
@@ -19,25 +22,26 @@ class SerialParserWorker;
 class SerialManager : public QObject
 {
     Q_OBJECT
-    Q_PROPERTY(float speed READ speed NOTIFY speedChanged)
-    Q_PROPERTY(int rpm READ rpm NOTIFY rpmChanged)
-    Q_PROPERTY(int accPedal READ accPedal NOTIFY accPedalChanged)
-    Q_PROPERTY(int brakePedal READ brakePedal NOTIFY brakePedalChanged)
-    Q_PROPERTY(double encoderAngle READ encoderAngle NOTIFY encoderAngleChanged)
-    Q_PROPERTY(float temperature READ temperature NOTIFY temperatureChanged)
-    Q_PROPERTY(int batteryLevel READ batteryLevel NOTIFY batteryLevelChanged)
-    Q_PROPERTY(double gpsLongitude READ gpsLongitude NOTIFY gpsLongitudeChanged)
-    Q_PROPERTY(double gpsLatitude READ gpsLatitude NOTIFY gpsLatitudeChanged)
-    Q_PROPERTY(int speedFL READ speedFL NOTIFY speedFLChanged)
-    Q_PROPERTY(int speedFR READ speedFR NOTIFY speedFRChanged)
-    Q_PROPERTY(int speedBL READ speedBL NOTIFY speedBLChanged)
-    Q_PROPERTY(int speedBR READ speedBR NOTIFY speedBRChanged)
-    Q_PROPERTY(double lateralG READ lateralG NOTIFY lateralGChanged)
-    Q_PROPERTY(double longitudinalG READ longitudinalG NOTIFY longitudinalGChanged)
-    Q_PROPERTY(int tempFL READ tempFL NOTIFY tempFLChanged)
-    Q_PROPERTY(int tempFR READ tempFR NOTIFY tempFRChanged)
-    Q_PROPERTY(int tempBL READ tempBL NOTIFY tempBLChanged)
-    Q_PROPERTY(int tempBR READ tempBR NOTIFY tempBRChanged)
+    Q_PROPERTY(TelemetrySnapshot snapshot READ snapshot NOTIFY snapshotChanged)
+    Q_PROPERTY(float speed READ speed NOTIFY snapshotChanged)
+    Q_PROPERTY(int rpm READ rpm NOTIFY snapshotChanged)
+    Q_PROPERTY(int accPedal READ accPedal NOTIFY snapshotChanged)
+    Q_PROPERTY(int brakePedal READ brakePedal NOTIFY snapshotChanged)
+    Q_PROPERTY(double encoderAngle READ encoderAngle NOTIFY snapshotChanged)
+    Q_PROPERTY(float temperature READ temperature NOTIFY snapshotChanged)
+    Q_PROPERTY(int batteryLevel READ batteryLevel NOTIFY snapshotChanged)
+    Q_PROPERTY(double gpsLongitude READ gpsLongitude NOTIFY snapshotChanged)
+    Q_PROPERTY(double gpsLatitude READ gpsLatitude NOTIFY snapshotChanged)
+    Q_PROPERTY(int speedFL READ speedFL NOTIFY snapshotChanged)
+    Q_PROPERTY(int speedFR READ speedFR NOTIFY snapshotChanged)
+    Q_PROPERTY(int speedBL READ speedBL NOTIFY snapshotChanged)
+    Q_PROPERTY(int speedBR READ speedBR NOTIFY snapshotChanged)
+    Q_PROPERTY(double lateralG READ lateralG NOTIFY snapshotChanged)
+    Q_PROPERTY(double longitudinalG READ longitudinalG NOTIFY snapshotChanged)
+    Q_PROPERTY(int tempFL READ tempFL NOTIFY snapshotChanged)
+    Q_PROPERTY(int tempFR READ tempFR NOTIFY snapshotChanged)
+    Q_PROPERTY(int tempBL READ tempBL NOTIFY snapshotChanged)
+    Q_PROPERTY(int tempBR READ tempBR NOTIFY snapshotChanged)
 
 public:
     explicit SerialManager(QObject *parent = nullptr);
@@ -48,73 +52,87 @@ public:
     Q_INVOKABLE void setParserThreadCount(int count);
     Q_INVOKABLE void setDebugMode(bool enabled);
 
+    /**
+     * @brief Write parsed frames into an external state instead of this transport's own
+     *
+     * Used to run several transports into one store. The owner of @p state then
+     * publishes it; this transport's snapshot and per-field properties stay idle.
+     * Call only while stopped.
+     * @param state Shared state, or nullptr to go back to this transport's own
+     * @param deduplicator Cross-link frame arbitration for @p state, may be nullptr
+     * @param sourceId This transport's index in @p deduplicator
+     */
+    void setIngest(TelemetryState *state, FrameDeduplicator *deduplicator, int sourceId);
+
+    // Chunks handed to a parser, and received while no parser was running
+    qint64 datagramsProcessed() const { return m_datagramsProcessed.load(std::memory_order_relaxed); }
+    qint64 datagramsDropped() const { return m_datagramsDropped.load(std::memory_order_relaxed); }
+
+    // Packets the parsers rejected; reported through errorOccurred once per second
+    const FrameErrorCounters &frameErrors() const { return m_frameErrors; }
+
     // Property getters
-    float speed() const { return m_speed.load(); }
-    int rpm() const { return m_rpm.load(); }
-    int accPedal() const { return m_accPedal.load(); }
-    int brakePedal() const { return m_brakePedal.load(); }
-    double encoderAngle() const { return m_encoderAngle.load(); }
-    float temperature() const { return m_temperature.load(); }
-    int batteryLevel() const { return m_batteryLevel.load(); }
-    double gpsLongitude() const { return m_gpsLongitude.load(); }
-    double gpsLatitude() const { return m_gpsLatitude.load(); }
-    int speedFL() const { return m_speedFL.load(); }
-    int speedFR() const { return m_speedFR.load(); }
-    int speedBL() const { return m_speedBL.load(); }
-    int speedBR() const { return m_speedBR.load(); }
-    double lateralG() const { return m_lateralG.load(); }
-    double longitudinalG() const { return m_longitudinalG.load(); }
-    int tempFL() const { return m_tempFL.load(); }
-    int tempFR() const { return m_tempFR.load(); }
-    int tempBL() const { return m_tempBL.load(); }
-    int tempBR() const { return m_tempBR.load(); }
+    TelemetrySnapshot snapshot() const { return m_snapshot; }
+    float speed() const { return m_snapshot.speed; }
+    int rpm() const { return m_snapshot.rpm; }
+    int accPedal() const { return m_snapshot.accPedal; }
+    int brakePedal() const { return m_snapshot.brakePedal; }
+    double encoderAngle() const { return m_snapshot.encoderAngle; }
+    float temperature() const { return m_snapshot.temperature; }
+    int batteryLevel() const { return m_snapshot.batteryLevel; }
+    double gpsLongitude() const { return m_snapshot.gpsLongitude; }
+    double gpsLatitude() const { return m_snapshot.gpsLatitude; }
+    int speedFL() const { return m_snapshot.speedFL; }
+    int speedFR() const { return m_snapshot.speedFR; }
+    int speedBL() const { return m_snapshot.speedBL; }
+    int speedBR() const { return m_snapshot.speedBR; }
+    double lateralG() const { return m_snapshot.lateralG; }
+    double longitudinalG() const { return m_snapshot.longitudinalG; }
+    int tempFL() const { return m_snapshot.tempFL; }
+    int tempFR() const { return m_snapshot.tempFR; }
+    int tempBL() const { return m_snapshot.tempBL; }
+    int tempBR() const { return m_snapshot.tempBR; }
 
 signals:
-    // Property change signals
-    void speedChanged(float newSpeed);
-    void rpmChanged(int newRpm);
-    void accPedalChanged(int newAccPedal);
-    void brakePedalChanged(int newBrakePedal);
-    void encoderAngleChanged(double newAngle);
-    void temperatureChanged(float newTemperature);
-    void batteryLevelChanged(int newBatteryLevel);
-    void gpsLongitudeChanged(double newLongitude);
-    void gpsLatitudeChanged(double newLatitude);
-    void speedFLChanged(int newSpeedFL);
-    void speedFRChanged(int newSpeedFR);
-    void speedBLChanged(int newSpeedBL);
-    void speedBRChanged(int newSpeedBR);
-    void lateralGChanged(double newLateralG);
-    void longitudinalGChanged(double newLongitudinalG);
-    void tempFLChanged(int newTempFL);
-    void tempFRChanged(int newTempFR);
-    void tempBLChanged(int newTempBL);
-    void tempBRChanged(int newTempBR);
+    // Published once per flush with every field
+    void snapshotChanged(const TelemetrySnapshot &snapshot);
 
     // Error signal
     void errorOccurred(const QString &error);
 
+    // Emitted from a parser thread when the state has unpublished changes
+    void updatePending(qint64 stateTimeNs);
+
     // Internal signals for worker communication
     void startReceiving(const QString &portName, qint32 baudRate);
     void stopReceiving();
 
 private slots:
-    void handleParsedData(float speed, int rpm, int accPedal, int brakePedal,
-                          double encoderAngle, float temperature, int batteryLevel,
-                          double gpsLongitude, double gpsLatitude,
-                          int speedFL, int speedFR, int speedBL, int speedBR,
-                          double lateralG, double longitudinalG,
-                          int tempFL, int tempFR, int tempBL, int tempBR);
-
     void handleError(const QString &error);
     void handleSerialDataReceived(const QByteArray &data);
 
     /**
-     * @brief Flush pending updates to QML at 60Hz rate
+     * @brief Flush pending updates to QML; driven by FramePublisher::publish
      */
     void flushPendingUpdates();
 
+    /**
+     * @brief Emit the parsers' rejected packets since the last report as one error
+     */
+    void reportFrameErrors();
+
 private:
+    // State the parsers write into; declared first so it outlives the parser pool
+    TelemetryState m_ownState;
+    TelemetryState *m_state;             // m_ownState, or a shared store set by setIngest()
+    FrameDeduplicator *m_deduplicator;
+    int m_sourceId;
+
+    // Parser errors, coalesced instead of one signal per bad packet; also
+    // declared before the parser pool
+    FrameErrorCounters m_frameErrors;
+    QTimer m_errorReportTimer;
+
     QThread m_receiverThread;
     SerialReceiverWorker *m_receiverWorker;
 
@@ -125,33 +143,11 @@ private:
     int m_parserThreadCount;
     bool m_debugMode;
 
-    // Update throttling (60Hz)
-    QTimer *m_updateTimer;
-    std::atomic<bool> m_pendingUpdate;
-
     std::atomic<qint64> m_datagramsProcessed;
     std::atomic<qint64> m_datagramsDropped;
 
-    // Data storage with atomic access
-    std::atomic<float> m_speed;
-    std::atomic<int> m_rpm;
-    std::atomic<int> m_accPedal;
-    std::atomic<int> m_brakePedal;
-    std::atomic<double> m_encoderAngle;
-    std::atomic<float> m_temperature;
-    std::atomic<int> m_batteryLevel;
-    std::atomic<double> m_gpsLongitude;
-    std::atomic<double> m_gpsLatitude;
-    std::atomic<int> m_speedFL;
-    std::atomic<int> m_speedFR;
-    std::atomic<int> m_speedBL;
-    std::atomic<int> m_speedBR;
-    std::atomic<double> m_lateralG;
-    std::atomic<double> m_longitudinalG;
-    std::atomic<int> m_tempFL;
-    std::atomic<int> m_tempFR;
-    std::atomic<int> m_tempBL;
-    std::atomic<int> m_tempBR;
+    // GUI-thread copy of the last published values
+    TelemetrySnapshot m_snapshot;
 
     void initializeParsers();
     void cleanupParsers();
@@ -3,76 +3,70 @@
 
 #include <QObject>
 #include <QByteArray>
-#include <QQueue>
+#include <QByteArrayView>
 #include <QMutex>
 #include <QWaitCondition>
 #include <QRunnable>
 #include <atomic>
+#include "../../telemetry/include/framededuplicator.h"
+#include "../../telemetry/include/frameerrorcounters.h"
+#include "../../telemetry/include/packetring.h"
+#include "../../telemetry/include/telemetrydispatch.h"
+#include "../../telemetry/include/telemetrystate.h"
 
 /**
  * @brief The SerialParserWorker class parses raw serial data in a separate thread.
  *
- * This class uses shared static state so all parser workers share the same
- * accumulated values, matching the MQTT parser pattern.
+ * Each worker writes decoded values into its own slot of the manager's
+ * TelemetryState, so parsers never lock against each other.
  */
 class SerialParserWorker : public QObject, public QRunnable
 {
     Q_OBJECT
 public:
-    explicit SerialParserWorker(bool debugMode = false, QObject *parent = nullptr);
-    ~SerialParserWorker();
-
     /**
-     * @brief Reset all shared static state values to defaults
-     * Call this when stopping the Serial manager to prevent stale data on reconnect
+     * @param state Shared state that parsed values are written into
+     * @param deduplicator Cross-link frame arbitration, or nullptr for none
+     * @param errors Where rejected frames are counted, or nullptr for none
+     * @param sourceId This transport's index in @p deduplicator
      */
-    static void resetSharedState();
+    explicit SerialParserWorker(TelemetryState *state,
+                                FrameDeduplicator *deduplicator,
+                                FrameErrorCounters *errors, int sourceId,
+                                bool debugMode = false,
+                                QObject *parent = nullptr);
+    ~SerialParserWorker();
 
     void queueData(const QByteArray &data);
     void stop();
 
+    /**
+     * @brief Number of packets that updated the shared state
+     */
+    quint64 packetsParsed() const { return m_packetsParsed.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Parse a single packet on the calling thread
+     *
+     * run() calls this for every queued packet; the benchmarks call it
+     * directly to time the parse path without the queue.
+     */
+    void parseData(QByteArrayView data);
+
 protected:
     void run() override;
 
-signals:
-    void dataParsed(float speed, int rpm, int accPedal, int brakePedal,
-                    double encoderAngle, float temperature, int batteryLevel,
-                    double gpsLongitude, double gpsLatitude,
-                    int speedFL, int speedFR, int speedBL, int speedBR,
-                    double lateralG, double longitudinalG,
-                    int tempFL, int tempFR, int tempBL, int tempBR);
-    void errorOccurred(const QString &error);
-
 private:
-    QQueue<QByteArray> m_dataQueue;
+    static constexpr int MAX_QUEUE_DEPTH = 50;
+    PacketRing<MAX_QUEUE_DEPTH> m_dataQueue; // Guarded by m_mutex
     QMutex m_mutex;
     QWaitCondition m_waitCondition;
     std::atomic<bool> m_running;
     bool m_debugMode;
 
-    void parseData(const QByteArray &data);
-
-    // Shared state across all parser instances
-    static QMutex s_stateMutex;
-    static float s_speed;
-    static int s_rpm;
-    static int s_accPedal;
-    static int s_brakePedal;
-    static double s_encoderAngle;
-    static float s_temperature;
-    static int s_batteryLevel;
-    static double s_gpsLongitude;
-    static double s_gpsLatitude;
-    static int s_speedFL;
-    static int s_speedFR;
-    static int s_speedBL;
-    static int s_speedBR;
-    static double s_lateralG;
-    static double s_longitudinalG;
-    static int s_tempFL;
-    static int s_tempFR;
-    static int s_tempBL;
-    static int s_tempBR;
+    TelemetryState *m_state;
+    TelemetryDispatch::Source m_source; // State slot, arbitration, error counters and link index
+    std::atomic<quint64> m_packetsParsed;
 };
 
 #endif // SERIALPARSERWORKER_H
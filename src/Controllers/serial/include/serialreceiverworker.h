@@ -7,6 +7,10 @@
 
 /**
  * @brief The SerialReceiverWorker class handles receiving data from the serial port in a separate thread.
+ *
+ * The port delivers a byte stream, so the worker buffers it and emits one
+ * serialDataReceived() per complete classic or CAN FD record, sized with
+ * CANDecoder::recordSize().
  */
 class SerialReceiverWorker : public QObject
 {
@@ -24,6 +28,9 @@ private slots:
     void readSerialData();
     void handleError(QSerialPort::SerialPortError serialPortError);
 
+private:
+    void emitRecords();
+
 signals:
     void serialDataReceived(const QByteArray &data);
     void errorOccurred(const QString &error);
@@ -31,6 +38,7 @@ signals:
 private:
     QSerialPort *m_serialPort;
     bool m_receiving;
+    QByteArray m_pending; // Received bytes not yet emitted as a record
 };
 
 #endif // SERIALRECEIVERWORKER_H
@@ -1,28 +1,29 @@
 
 #include "../include/serialmanager.h"
 #include "../../logging/include/asynclogger.h"
+#include "../../telemetry/include/framepublisher.h"
 #include "../include/serialparserworker.h"
 #include "../include/serialreceiverworker.h"
 #include <QDebug>
 #include <QThread>
 
 SerialManager::SerialManager(QObject *parent)
-    : QObject(parent), m_nextParserIndex(0),
+    : QObject(parent), m_state(&m_ownState), m_deduplicator(nullptr),
+      m_sourceId(0), m_nextParserIndex(0),
       m_parserThreadCount(QThread::idealThreadCount()), m_debugMode(false),
-      m_pendingUpdate(false),
-      m_datagramsProcessed(0), m_datagramsDropped(0), m_speed(0.0f), m_rpm(0),
-      m_accPedal(0), m_brakePedal(0), m_encoderAngle(0.0), m_temperature(0.0f),
-      m_batteryLevel(0), m_gpsLongitude(0.0), m_gpsLatitude(0.0), m_speedFL(0),
-      m_speedFR(0), m_speedBL(0), m_speedBR(0), m_lateralG(0.0),
-      m_longitudinalG(0.0), m_tempFL(0), m_tempFR(0), m_tempBL(0), m_tempBR(0) {
+      m_datagramsProcessed(0), m_datagramsDropped(0) {
   // Initialize async logger
   AsyncLogger::instance().initialize("./logs");
 
-  // Initialize update throttling timer (60Hz = 16ms interval)
-  m_updateTimer = new QTimer(this);
-  m_updateTimer->setInterval(16);
-  connect(m_updateTimer, &QTimer::timeout, this, &SerialManager::flushPendingUpdates);
-  m_updateTimer->start();
+  // Publish once per rendered frame instead of on a free-running timer. The
+  // first unpublished parser write asks the frame publisher for a frame
+  m_ownState.setUpdateNotifier([this](std::int64_t stateTimeNs) {
+    emit updatePending(stateTimeNs);
+  });
+  connect(this, &SerialManager::updatePending, &FramePublisher::instance(),
+          &FramePublisher::requestFrame, Qt::QueuedConnection);
+  connect(&FramePublisher::instance(), &FramePublisher::publish, this,
+          &SerialManager::flushPendingUpdates);
 
   // Create and configure the receiver worker
   m_receiverWorker = new SerialReceiverWorker();
@@ -46,14 +47,14 @@ SerialManager::SerialManager(QObject *parent)
 
   // Configure the parser thread pool
   m_parserPool.setMaxThreadCount(m_parserThreadCount);
+
+  // Parser errors are counted on the parser threads and reported in batches
+  m_errorReportTimer.setInterval(FrameErrorCounters::REPORT_INTERVAL_MS);
+  connect(&m_errorReportTimer, &QTimer::timeout, this,
+          &SerialManager::reportFrameErrors);
 }
 
 SerialManager::~SerialManager() {
-  // Stop the update timer first
-  if (m_updateTimer) {
-    m_updateTimer->stop();
-  }
-
   stop();
 
   // Wait for receiver thread to finish
@@ -130,6 +131,13 @@ void SerialManager::setDebugMode(bool enabled) {
   }
 }
 
+void SerialManager::setIngest(TelemetryState *state,
+                             FrameDeduplicator *deduplicator, int sourceId) {
+  m_state = state ? state : &m_ownState;
+  m_deduplicator = deduplicator;
+  m_sourceId = sourceId;
+}
+
 void SerialManager::handleSerialDataReceived(const QByteArray &data) {
   // Distribute data among parsers in a round-robin fashion
   if (!m_parsers.isEmpty()) {
@@ -141,73 +149,23 @@ void SerialManager::handleSerialDataReceived(const QByteArray &data) {
 
     // Update the next parser index
     m_nextParserIndex = (m_nextParserIndex + 1) % m_parsers.size();
+    m_datagramsProcessed.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    m_datagramsDropped.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
-void SerialManager::handleParsedData(float speed, int rpm, int accPedal,
-                                     int brakePedal, double encoderAngle,
-                                     float temperature, int batteryLevel,
-                                     double gpsLongitude, double gpsLatitude,
-                                     int speedFL, int speedFR, int speedBL,
-                                     int speedBR, double lateralG,
-                                     double longitudinalG, int tempFL,
-                                     int tempFR, int tempBL, int tempBR) {
-  // Increment processed count
-  m_datagramsProcessed.fetch_add(1);
-
-  // Store all values atomically without emitting signals
-  // Signals will be emitted by flushPendingUpdates() at 60Hz
-  m_speed.store(speed, std::memory_order_relaxed);
-  m_rpm.store(rpm, std::memory_order_relaxed);
-  m_accPedal.store(accPedal, std::memory_order_relaxed);
-  m_brakePedal.store(brakePedal, std::memory_order_relaxed);
-  m_encoderAngle.store(encoderAngle, std::memory_order_relaxed);
-  m_temperature.store(temperature, std::memory_order_relaxed);
-  m_batteryLevel.store(batteryLevel, std::memory_order_relaxed);
-  m_gpsLongitude.store(gpsLongitude, std::memory_order_relaxed);
-  m_gpsLatitude.store(gpsLatitude, std::memory_order_relaxed);
-  m_speedFL.store(speedFL, std::memory_order_relaxed);
-  m_speedFR.store(speedFR, std::memory_order_relaxed);
-  m_speedBL.store(speedBL, std::memory_order_relaxed);
-  m_speedBR.store(speedBR, std::memory_order_relaxed);
-  m_lateralG.store(lateralG, std::memory_order_relaxed);
-  m_longitudinalG.store(longitudinalG, std::memory_order_relaxed);
-  m_tempFL.store(tempFL, std::memory_order_relaxed);
-  m_tempFR.store(tempFR, std::memory_order_relaxed);
-  m_tempBL.store(tempBL, std::memory_order_relaxed);
-  m_tempBR.store(tempBR, std::memory_order_relaxed);
-
-  // Mark that we have pending updates
-  m_pendingUpdate.store(true, std::memory_order_release);
-}
-
 void SerialManager::flushPendingUpdates() {
-  // Check if we have any pending updates
-  if (!m_pendingUpdate.exchange(false, std::memory_order_acquire)) {
+  // Merge the parsers' state slots into one snapshot and publish it with a
+  // single signal. Called once per rendered frame
+  if (m_state != &m_ownState) {
+    return; // A shared store is published by its owner
+  }
+  if (!m_ownState.takeSnapshot(m_snapshot)) {
     return; // No updates pending
   }
 
-  // Read all current values and emit signals
-  // This batches all updates to a maximum of 60Hz
-  emit speedChanged(m_speed.load(std::memory_order_relaxed));
-  emit rpmChanged(m_rpm.load(std::memory_order_relaxed));
-  emit accPedalChanged(m_accPedal.load(std::memory_order_relaxed));
-  emit brakePedalChanged(m_brakePedal.load(std::memory_order_relaxed));
-  emit encoderAngleChanged(m_encoderAngle.load(std::memory_order_relaxed));
-  emit temperatureChanged(m_temperature.load(std::memory_order_relaxed));
-  emit batteryLevelChanged(m_batteryLevel.load(std::memory_order_relaxed));
-  emit gpsLongitudeChanged(m_gpsLongitude.load(std::memory_order_relaxed));
-  emit gpsLatitudeChanged(m_gpsLatitude.load(std::memory_order_relaxed));
-  emit speedFLChanged(m_speedFL.load(std::memory_order_relaxed));
-  emit speedFRChanged(m_speedFR.load(std::memory_order_relaxed));
-  emit speedBLChanged(m_speedBL.load(std::memory_order_relaxed));
-  emit speedBRChanged(m_speedBR.load(std::memory_order_relaxed));
-  emit lateralGChanged(m_lateralG.load(std::memory_order_relaxed));
-  emit longitudinalGChanged(m_longitudinalG.load(std::memory_order_relaxed));
-  emit tempFLChanged(m_tempFL.load(std::memory_order_relaxed));
-  emit tempFRChanged(m_tempFR.load(std::memory_order_relaxed));
-  emit tempBLChanged(m_tempBL.load(std::memory_order_relaxed));
-  emit tempBRChanged(m_tempBR.load(std::memory_order_relaxed));
+  emit snapshotChanged(m_snapshot);
 }
 
 void SerialManager::handleError(const QString &error) {
@@ -218,16 +176,21 @@ void SerialManager::handleError(const QString &error) {
   emit errorOccurred(error);
 }
 
+void SerialManager::reportFrameErrors() {
+  const QString report =
+      m_frameErrors.takeReport(m_errorReportTimer.interval());
+  if (!report.isEmpty()) {
+    handleError("Serial: " + report);
+  }
+}
+
 void SerialManager::initializeParsers() {
   // Create parser instances
   for (int i = 0; i < m_parserThreadCount; ++i) {
-    SerialParserWorker *parser = new SerialParserWorker(m_debugMode);
-
-    // Connect signals for results
-    connect(parser, &SerialParserWorker::dataParsed, this,
-            &SerialManager::handleParsedData, Qt::QueuedConnection);
-    connect(parser, &SerialParserWorker::errorOccurred, this,
-            &SerialManager::handleError, Qt::QueuedConnection);
+    // Parsed values go straight into m_state; errors are counted in
+    // m_frameErrors
+    SerialParserWorker *parser = new SerialParserWorker(
+        m_state, m_deduplicator, &m_frameErrors, m_sourceId, m_debugMode);
 
     // Add to list
     m_parsers.append(parser);
@@ -242,6 +205,8 @@ void SerialManager::initializeParsers() {
 
   // Reset the next parser index
   m_nextParserIndex = 0;
+
+  m_errorReportTimer.start();
 }
 
 void SerialManager::cleanupParsers() {
@@ -251,14 +216,23 @@ void SerialManager::cleanupParsers() {
   }
 
   // Wait for all tasks to complete with timeout
-  if (!m_parserPool.waitForDone(3000)) {
+  const bool finished = m_parserPool.waitForDone(3000);
+  if (!finished) {
     qWarning() << "Serial parser pool did not finish in time";
   }
 
-
   // Clear the list (autoDelete already handled deletion)
   m_parsers.clear();
 
-  // Reset shared state to prevent stale data on reconnect
-  SerialParserWorker::resetSharedState();
+  // Report what the stopped parsers counted since the last tick
+  if (m_errorReportTimer.isActive()) {
+    m_errorReportTimer.stop();
+    reportFrameErrors();
+  }
+
+  // Reset our own state to prevent stale data on reconnect. Only safe once no
+  // parser can still be writing into it; a shared store is reset by its owner
+  if (finished && m_state == &m_ownState) {
+    m_ownState.reset();
+  }
 }
@@ -1,5 +1,6 @@
 
 #include "../include/serialreceiverworker.h"
+#include "../../can/include/candecoder.h"
 #include <QDebug>
 
 SerialReceiverWorker::SerialReceiverWorker(QObject *parent)
@@ -50,6 +51,9 @@ void SerialReceiverWorker::startReceiving(const QString &portName, qint32 baudRa
     m_serialPort->setStopBits(QSerialPort::OneStop);
     m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
 
+    // A new stream starts on a record boundary
+    m_pending.clear();
+
     if (m_serialPort->open(QIODevice::ReadOnly))
     {
         m_receiving = true;
@@ -76,9 +80,34 @@ void SerialReceiverWorker::readSerialData()
 {
     if (m_receiving && m_serialPort->bytesAvailable() > 0)
     {
-        QByteArray data = m_serialPort->readAll();
-        emit serialDataReceived(data);
+        m_pending.append(m_serialPort->readAll());
+        emitRecords();
+    }
+}
+
+void SerialReceiverWorker::emitRecords()
+{
+    // A read ends wherever the UART stopped, so cut the stream into records
+    // by their headers: 20 bytes for classic frames, up to 76 for CAN FD
+    qsizetype offset = 0;
+    while (m_pending.size() - offset >= CANDecoder::HEADER_SIZE)
+    {
+        const QByteArrayView rest = QByteArrayView(m_pending).sliced(offset);
+        const int size = CANDecoder::recordSize(rest);
+        if (size < 0)
+        {
+            // Invalid DLC: not a record boundary, resynchronise byte by byte
+            ++offset;
+            continue;
+        }
+        if (rest.size() < size)
+        {
+            break; // The rest of the record is still on the wire
+        }
+        emit serialDataReceived(m_pending.mid(offset, size));
+        offset += size;
     }
+    m_pending.remove(0, offset);
 }
 
 void SerialReceiverWorker::handleError(QSerialPort::SerialPortError serialPortError)
@@ -0,0 +1,122 @@
+#ifndef FRAMEDEDUPLICATOR_H
+#define FRAMEDEDUPLICATOR_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lock-free arbitration of CAN frames arriving over several links
+ *
+ * When the same car is received over more than one transport (e.g. serial
+ * umbilical and UDP radio), every frame can arrive once per link. Frames are
+ * identified by CAN ID plus the device timestamp in the packet header:
+ *
+ * - The first copy of a frame is accepted, later copies from other links
+ *   are duplicates. A repeat over the link that delivered the first copy is
+ *   a new frame: a 1 kHz sender stamps two frames with the same millisecond.
+ * - An accepted frame older than one already shown for its CAN ID is late:
+ *   it is worth logging but must not move the gauges backwards.
+ *
+ * Recently seen frames live in a direct-mapped table of atomic keys, each
+ * tagged with the link that claimed it, so
+ * parser threads of all transports can call classify() concurrently. A hash
+ * collision can only evict an entry early, which lets a duplicate through as
+ * late, or as fresh if it repeats the newest frame; it never drops a unique
+ * frame.
+ *
+ * Frames with a device timestamp of 0 carry no identity and are always fresh.
+ * A frame more than LATE_WINDOW_MS behind the newest of its CAN ID, or
+ * stamped within RESTART_WINDOW_MS of zero when the newest is not, means the
+ * device clock restarted (ECU reboot, sender restart): it is fresh and
+ * becomes the new newest, so the gauges follow the restarted clock.
+ *
+ * Arbitration is only useful with several links. The owner enables it
+ * while more than one runs; disabled, every frame is fresh and nothing is
+ * counted, so a lone link never has frames dropped or held back.
+ */
+class FrameDeduplicator
+{
+public:
+    static constexpr int MAX_SOURCES = 4;
+    static constexpr std::int32_t LATE_WINDOW_MS = 2000;   // Most one link lags another
+    static constexpr std::uint32_t RESTART_WINDOW_MS = 100; // Device time just after boot
+
+    enum Verdict {
+        Fresh,     // First copy and newest for its CAN ID: log and display
+        Late,      // First copy but older than what is displayed: log only
+        Duplicate  // Already received over another link: log as a copy only
+    };
+
+    struct SourceStats {
+        std::uint64_t received = 0;   // Frames with a device timestamp
+        std::uint64_t accepted = 0;   // First copies (fresh or late)
+        std::uint64_t late = 0;
+        std::uint64_t duplicates = 0;
+        double lossRatio = 0.0;       // Unique frames this source never delivered
+        double latencyMs = 0.0;       // Mean delay behind the fastest source
+    };
+
+    FrameDeduplicator();
+
+    /**
+     * @brief Classify one frame and update the statistics of @p source
+     * @param canId 11-bit ID, or 29-bit ID with bit 31 set (CANDecoder::Frame::id)
+     * @param hostTimeMs Host receive time, any monotonic millisecond clock
+     */
+    Verdict classify(int source, std::uint32_t canId, std::uint32_t deviceTimestamp, std::int64_t hostTimeMs);
+
+    SourceStats stats(int source) const;
+
+    /**
+     * @brief Arbitrate between links, or pass every frame as fresh
+     *
+     * Disabled by default. May be called while sources are running; frames
+     * classified while disabled are not remembered.
+     */
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Host clock for classify(): MonotonicClock in milliseconds
+     */
+    static std::int64_t hostTimeMs();
+
+    /**
+     * @brief Forget all frames and statistics; call only while no source is running
+     */
+    void reset();
+
+private:
+    static constexpr int WINDOW_BITS = 12;
+    static constexpr std::size_t WINDOW_SIZE = std::size_t(1) << WINDOW_BITS;
+    static constexpr std::size_t ID_SLOTS = 2048; // One per standard 11-bit ID
+    static constexpr int EXTENDED_SLOT_BITS = 11;
+    static constexpr std::size_t EXTENDED_SLOTS = std::size_t(1) << EXTENDED_SLOT_BITS; // Hashed 29-bit IDs
+    static constexpr std::int64_t NO_OFFSET = INT64_MAX;
+
+    struct alignas(64) SourceCounters {
+        std::atomic<std::uint64_t> received{0};
+        std::atomic<std::uint64_t> accepted{0};
+        std::atomic<std::uint64_t> late{0};
+        std::atomic<std::uint64_t> duplicates{0};
+        std::atomic<std::int64_t> offsetSum{0};   // host - device, over all received frames
+        std::atomic<std::int64_t> offsetMin{NO_OFFSET};
+    };
+
+    static void updateMin(std::atomic<std::int64_t> &min, std::int64_t value);
+
+    // Bits 62-63: the source that claimed the entry
+    static constexpr int WINDOW_SOURCE_SHIFT = 62;
+    static_assert(MAX_SOURCES <= 4, "Sources must fit in the window's two tag bits");
+
+    std::array<std::atomic<std::uint64_t>, WINDOW_SIZE> m_window;
+    // Newest accepted device time per CAN ID; 0 = none yet. The upper half is
+    // a tag: bit 32 for standard IDs, the ID itself for shared extended slots
+    std::array<std::atomic<std::uint64_t>, ID_SLOTS + EXTENDED_SLOTS> m_newest;
+    std::array<SourceCounters, MAX_SOURCES> m_sources;
+    std::atomic<std::uint64_t> m_unique{0};
+    std::atomic<bool> m_enabled{false};
+};
+
+#endif // FRAMEDEDUPLICATOR_H
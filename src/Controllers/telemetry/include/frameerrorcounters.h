@@ -0,0 +1,81 @@
+#ifndef FRAMEERRORCOUNTERS_H
+#define FRAMEERRORCOUNTERS_H
+
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lock-free accounting of bad frames, reported as one line per interval
+ *
+ * Parser threads count malformed records, unknown CAN IDs and decode
+ * failures with a few relaxed atomic increments instead of emitting a
+ * string per frame. The owning transport calls takeReport() on a timer
+ * and forwards the coalesced line, e.g.
+ * "unknown ID 0x1a0 ×4312 in last 1 s", so a babbling node costs the GUI
+ * thread one event per interval at most.
+ *
+ * Unknown standard IDs are counted per ID. Unknown extended IDs share a
+ * small hashed table; an ID that collides is still counted in the
+ * category, just not listed by name.
+ */
+class FrameErrorCounters
+{
+public:
+    enum Category {
+        InvalidRecord, // Wrong size, DLC or ID bits
+        UnknownId,     // No handler registered
+        DecodeFailure, // Exception while decoding
+        CategoryCount
+    };
+
+    static constexpr int REPORT_INTERVAL_MS = 1000; // How often owners call takeReport()
+
+    FrameErrorCounters();
+
+    void countInvalidRecord() { count(InvalidRecord); }
+    void countDecodeFailure() { count(DecodeFailure); }
+
+    /**
+     * @param canId CANDecoder::Frame::id of the unhandled frame
+     */
+    void countUnknownId(uint32_t canId);
+
+    /**
+     * @brief Errors of @p category since construction or reset()
+     */
+    quint64 total(Category category) const { return m_totals[category].load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Coalesce the errors counted since the previous call into one line
+     * @param intervalMs Time covered by the report, for the message
+     * @return Empty string if nothing was counted
+     */
+    QString takeReport(qint64 intervalMs);
+
+    /**
+     * @brief Clear all counters; call only while no parser is running
+     */
+    void reset();
+
+private:
+    static constexpr int REPORTED_IDS = 3; // Most frequent unknown IDs named per report
+    static constexpr int EXTENDED_SLOT_BITS = 8;
+    static constexpr std::size_t STANDARD_IDS = 2048;
+    static constexpr std::size_t EXTENDED_SLOTS = std::size_t(1) << EXTENDED_SLOT_BITS;
+
+    void count(Category category)
+    {
+        m_totals[category].fetch_add(1, std::memory_order_relaxed);
+        m_pending[category].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<quint64>, CategoryCount> m_totals;
+    std::array<std::atomic<quint64>, CategoryCount> m_pending; // Since the last report
+    std::array<std::atomic<std::uint32_t>, STANDARD_IDS> m_unknownStandard;
+    std::array<std::atomic<std::uint64_t>, EXTENDED_SLOTS> m_unknownExtended; // ID << 32 | count; 0 = free
+};
+
+#endif // FRAMEERRORCOUNTERS_H
@@ -0,0 +1,98 @@
+#ifndef FRAMEPUBLISHER_H
+#define FRAMEPUBLISHER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <atomic>
+#include <cstdint>
+
+class QQuickWindow;
+
+/**
+ * @brief Paces GUI publishing to the frames the window actually renders
+ *
+ * Transports report pending data with requestFrame(). The publisher asks the
+ * window for a frame and emits publish() from QQuickWindow::afterAnimating,
+ * so every transport flushes exactly once per rendered frame, right before the
+ * scene graph synchronizes. Nothing is scheduled while no data is pending, and
+ * a hidden window renders no frames at all.
+ *
+ * Without a window (or after it is destroyed) a single-shot timer at the
+ * nominal 60 Hz frame interval takes its place.
+ *
+ * State-to-pixel latency is measured from the first unpublished parser write
+ * to QQuickWindow::frameSwapped of the frame that shows it (to publish() in
+ * timer mode), and reported about once per second.
+ */
+class FramePublisher : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double latencyMs READ latencyMs NOTIFY latencyChanged)
+    Q_PROPERTY(double maxLatencyMs READ maxLatencyMs NOTIFY latencyChanged)
+    Q_PROPERTY(bool vsyncAligned READ vsyncAligned NOTIFY vsyncAlignedChanged)
+
+public:
+    static FramePublisher &instance();
+
+    /**
+     * @brief Drive publishing from @p window, or from the timer if nullptr
+     */
+    void setWindow(QQuickWindow *window);
+
+    double latencyMs() const { return m_latencyMs; }
+    double maxLatencyMs() const { return m_maxLatencyMs; }
+    bool vsyncAligned() const { return !m_window.isNull(); }
+
+public slots:
+    /**
+     * @brief Ask for a publish on the next frame
+     * @param stateTimeNs MonotonicClock time (ns) of the oldest unpublished write
+     */
+    void requestFrame(qint64 stateTimeNs);
+
+signals:
+    /**
+     * @brief Flush pending state now; emitted at most once per frame
+     */
+    void publish();
+
+    void latencyChanged();
+    void vsyncAlignedChanged(bool vsyncAligned);
+
+private slots:
+    void handleAfterAnimating();
+    void handleFallbackTimeout();
+
+private:
+    explicit FramePublisher(QObject *parent = nullptr);
+
+    void emitPublish();
+    void handleFrameSwapped(); // Render thread
+    void addLatencySample(std::int64_t latencyNs);
+    void reportLatency();
+
+    static std::int64_t nowNs();
+
+    static constexpr int FALLBACK_INTERVAL_MS = 16;
+    static constexpr std::int64_t REPORT_INTERVAL_NS = 1000000000;
+
+    QPointer<QQuickWindow> m_window;
+    QTimer m_fallbackTimer;
+    bool m_frameRequested;
+    std::int64_t m_oldestStateNs; // 0 = nothing pending
+
+    // Publish awaiting its frameSwapped; 0 = none. Shared with the render thread
+    std::atomic<std::int64_t> m_inFlightStateNs;
+
+    // Latency samples since the last report, written from either thread
+    std::atomic<std::int64_t> m_latencySumNs;
+    std::atomic<std::int64_t> m_latencyMaxNs;
+    std::atomic<std::int64_t> m_latencyCount;
+
+    std::int64_t m_lastReportNs;
+    double m_latencyMs;
+    double m_maxLatencyMs;
+};
+
+#endif // FRAMEPUBLISHER_H
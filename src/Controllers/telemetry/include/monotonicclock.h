@@ -0,0 +1,59 @@
+#ifndef MONOTONICCLOCK_H
+#define MONOTONICCLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Host clock for every telemetry and log timestamp
+ *
+ * std::chrono::steady_clock, which is CLOCK_MONOTONIC on Linux: nanosecond
+ * resolution, read through the vDSO without a system call, and never stepped
+ * by NTP or a manual clock change, so samples taken microseconds apart keep
+ * distinct, ordered timestamps. Its zero is arbitrary (usually boot), so a
+ * log stores one Anchor per session to turn readings back into wall-clock
+ * time.
+ */
+class MonotonicClock
+{
+public:
+    /**
+     * @brief One wall-clock reading and the monotonic time it was taken at
+     */
+    struct Anchor {
+        std::int64_t wallNs;       // ns since the Unix epoch
+        std::int64_t monotonicNs;  // nowNs() at the same instant
+    };
+
+    static std::int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Pair the wall clock with nowNs()
+     *
+     * The wall clock is read between two monotonic readings and paired with
+     * their midpoint, so the anchor is off by at most half the time between
+     * them, a few tens of nanoseconds unless the thread is preempted.
+     */
+    static Anchor anchor()
+    {
+        const std::int64_t before = nowNs();
+        const std::int64_t wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        const std::int64_t after = nowNs();
+        return {wall, before + (after - before) / 2};
+    }
+
+    /**
+     * @brief Wall-clock time of monotonic reading @p monotonicNs, ns since the epoch
+     */
+    static std::int64_t toWallNs(const Anchor &anchor, std::int64_t monotonicNs)
+    {
+        return anchor.wallNs + (monotonicNs - anchor.monotonicNs);
+    }
+};
+
+#endif // MONOTONICCLOCK_H
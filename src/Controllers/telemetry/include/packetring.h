@@ -0,0 +1,70 @@
+#ifndef PACKETRING_H
+#define PACKETRING_H
+
+#include <QByteArray>
+#include <array>
+#include <utility>
+
+/**
+ * @brief Fixed-capacity FIFO between a transport and its parser workers
+ *
+ * All slots exist up front, and push() and pop() only move QByteArray
+ * handles that share the receiver's buffer, so queueing a packet never
+ * allocates. When full, push() overwrites the oldest packet, which keeps the
+ * display on the most recent data under load.
+ *
+ * Not thread-safe: the parser workers guard it with their queue mutex.
+ */
+template <int Capacity>
+class PacketRing
+{
+    static_assert(Capacity > 0, "PacketRing needs at least one slot");
+
+public:
+    bool isEmpty() const { return m_size == 0; }
+    int size() const { return m_size; }
+
+    /**
+     * @brief Append @p packet, dropping the oldest one if the ring is full
+     * @return False if a packet was dropped
+     */
+    bool push(const QByteArray &packet)
+    {
+        const bool full = m_size == Capacity;
+        m_slots[(m_head + m_size) % Capacity] = packet;
+        if (full) {
+            m_head = (m_head + 1) % Capacity;
+        } else {
+            ++m_size;
+        }
+        return !full;
+    }
+
+    /**
+     * @brief Move the oldest packet into @p packet; the ring must not be empty
+     *
+     * The slot is emptied so the ring holds no reference to parsed data.
+     */
+    void pop(QByteArray &packet)
+    {
+        packet = std::exchange(m_slots[m_head], QByteArray());
+        m_head = (m_head + 1) % Capacity;
+        --m_size;
+    }
+
+    void clear()
+    {
+        for (QByteArray &slot : m_slots) {
+            slot = QByteArray();
+        }
+        m_head = 0;
+        m_size = 0;
+    }
+
+private:
+    std::array<QByteArray, Capacity> m_slots;
+    int m_head = 0;
+    int m_size = 0;
+};
+
+#endif // PACKETRING_H
@@ -0,0 +1,84 @@
+#ifndef SIGNALFILTER_H
+#define SIGNALFILTER_H
+
+#include "telemetrysnapshot.h"
+#include <QString>
+#include <cstdint>
+
+/**
+ * @brief Per-signal deadband and display quantization for published values
+ *
+ * Sits between the merged telemetry state and the QML NOTIFY signals. A field
+ * is only republished when its raw value moves at least @c deadband away from
+ * the last published value and still lands on a different display step after
+ * rounding to @c resolution. Held-back changes are counted as suppressed.
+ *
+ * A deadband slightly below the resolution acts as hysteresis, so noise
+ * around a rounding boundary does not toggle the displayed digit.
+ */
+class SignalFilter
+{
+public:
+    // One entry per TelemetrySnapshot field, in declaration order
+    enum Field {
+        Speed,
+        Rpm,
+        AccPedal,
+        BrakePedal,
+        EncoderAngle,
+        Temperature,
+        BatteryLevel,
+        GpsLongitude,
+        GpsLatitude,
+        SpeedFL,
+        SpeedFR,
+        SpeedBL,
+        SpeedBR,
+        LateralG,
+        LongitudinalG,
+        TempFL,
+        TempFR,
+        TempBL,
+        TempBR,
+        FieldCount
+    };
+
+    struct Settings {
+        double deadband = 0.0;   // Minimum raw change to republish, 0 = any change
+        double resolution = 0.0; // Display step values are rounded to, 0 = none
+    };
+
+    SignalFilter();
+
+    void setSettings(Field field, const Settings &settings);
+    Settings settings(Field field) const { return m_settings[field]; }
+
+    /**
+     * @brief Look up a field by its QML property name (e.g. "lateralG")
+     * @return False if @p name is not a telemetry field
+     */
+    static bool fieldFromName(const QString &name, Field &field);
+
+    static quint32 fieldBit(Field field) { return 1u << field; }
+
+    /**
+     * @brief Filter @p raw into @p published
+     * @return Bit mask (fieldBit()) of the fields whose published value changed
+     */
+    quint32 apply(const TelemetrySnapshot &raw, TelemetrySnapshot &published);
+
+    quint64 emittedCount() const { return m_emitted; }
+    quint64 suppressedCount() const { return m_suppressed; }
+
+private:
+    static double value(const TelemetrySnapshot &snapshot, Field field);
+    static void setValue(TelemetrySnapshot &snapshot, Field field, double value);
+    static double storedValue(Field field, double value);
+
+    Settings m_settings[FieldCount];
+    TelemetrySnapshot m_lastRaw;
+    quint64 m_emitted;
+    quint64 m_suppressed;
+};
+
+#endif // SIGNALFILTER_H
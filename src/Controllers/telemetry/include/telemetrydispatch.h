@@ -0,0 +1,86 @@
+#ifndef TELEMETRYDISPATCH_H
+#define TELEMETRYDISPATCH_H
+
+#include <QByteArrayView>
+#include <utility>
+#include "../../can/include/candispatchtable.h"
+#include "telemetrystate.h"
+
+class FrameDeduplicator;
+class FrameErrorCounters;
+
+/**
+ * @brief Frame pipeline and CAN ID dispatch shared by the UDP, serial and
+ * MQTT parser workers
+ *
+ * Each parser hands every received record to process(), which owns the
+ * order of the steps, so a change to it is made once for all transports.
+ * The built-in handlers decode the car's messages and write them into the
+ * parser's TelemetryState slot. Further IDs are added by registering a
+ * handler on table() at startup, before any transport is started.
+ */
+class TelemetryDispatch
+{
+public:
+    /**
+     * @brief What a handler may write to for the current frame
+     */
+    struct Context {
+        TelemetryState::Writer *writer; // Parser's state slot, or nullptr
+        bool fresh;                     // Frame may update the displayed state
+
+        /**
+         * @brief Publish one CAN message group through the parser's slot
+         * @return False if the parser has no slot or the frame is late
+         */
+        template <typename Fn>
+        bool update(TelemetryState::Group group, Fn &&fn)
+        {
+            if (!writer || !fresh) {
+                return false;
+            }
+            writer->update(group, std::forward<Fn>(fn));
+            return true;
+        }
+    };
+
+    using Table = CANDispatchTable<Context>;
+
+    /**
+     * @brief One parser's connections, passed to process()
+     */
+    struct Source {
+        TelemetryState::Writer *writer;  // Parser's state slot, or nullptr
+        FrameDeduplicator *deduplicator; // Cross-link arbitration, or nullptr
+        FrameErrorCounters *errors;      // Where rejected frames are counted, or nullptr
+        int id;                          // Index in deduplicator, logged with every frame
+    };
+
+    enum Outcome {
+        Invalid,    // Not a valid CAN record; counted
+        Duplicate,  // Logged, not applied: already received over another link
+        UnknownId,  // Logged, no handler; counted
+        Failed,     // The handler threw; counted
+        NotApplied, // Handled without a state update (late, log-only or no slot)
+        Applied     // Updated the shared state
+    };
+
+    /**
+     * @brief Run one received record through the whole pipeline
+     *
+     * Parse the record in place (invalid ones are counted), arbitrate
+     * between links, log the frame to AsyncLogger (copies from other links
+     * flagged, never left out), then dispatch it by CAN ID (unknown IDs and
+     * handler exceptions are counted). Duplicates stop after logging; late
+     * frames reach their handler but do not update the display.
+     * @param record One classic or CAN FD record
+     */
+    static Outcome process(QByteArrayView record, const Source &source);
+
+    /**
+     * @brief Process-wide table; the built-in messages are registered on first use
+     */
+    static Table &table();
+};
+
+#endif // TELEMETRYDISPATCH_H
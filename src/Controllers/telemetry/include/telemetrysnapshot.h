@@ -0,0 +1,61 @@
+#ifndef TELEMETRYSNAPSHOT_H
+#define TELEMETRYSNAPSHOT_H
+
+#include <QObject>
+#include <QtQml/qqmlregistration.h>
+
+/**
+ * @brief Value snapshot of every telemetry field shown on the dashboard
+ *
+ * A snapshot is built once per GUI flush by each transport and published
+ * through a single signal, instead of one signal per field. QML reads it as
+ * a value type (communicationManager.snapshot.speed, ...).
+ */
+struct TelemetrySnapshot
+{
+    Q_GADGET
+    QML_VALUE_TYPE(telemetrySnapshot)
+
+    Q_PROPERTY(float speed MEMBER speed)
+    Q_PROPERTY(int rpm MEMBER rpm)
+    Q_PROPERTY(int accPedal MEMBER accPedal)
+    Q_PROPERTY(int brakePedal MEMBER brakePedal)
+    Q_PROPERTY(double encoderAngle MEMBER encoderAngle)
+    Q_PROPERTY(float temperature MEMBER temperature)
+    Q_PROPERTY(int batteryLevel MEMBER batteryLevel)
+    Q_PROPERTY(double gpsLongitude MEMBER gpsLongitude)
+    Q_PROPERTY(double gpsLatitude MEMBER gpsLatitude)
+    Q_PROPERTY(int speedFL MEMBER speedFL)
+    Q_PROPERTY(int speedFR MEMBER speedFR)
+    Q_PROPERTY(int speedBL MEMBER speedBL)
+    Q_PROPERTY(int speedBR MEMBER speedBR)
+    Q_PROPERTY(double lateralG MEMBER lateralG)
+    Q_PROPERTY(double longitudinalG MEMBER longitudinalG)
+    Q_PROPERTY(int tempFL MEMBER tempFL)
+    Q_PROPERTY(int tempFR MEMBER tempFR)
+    Q_PROPERTY(int tempBL MEMBER tempBL)
+    Q_PROPERTY(int tempBR MEMBER tempBR)
+
+public:
+    float speed = 0.0f;
+    int rpm = 0;
+    int accPedal = 0;
+    int brakePedal = 0;
+    double encoderAngle = 0.0;
+    float temperature = 0.0f;
+    int batteryLevel = 0;
+    double gpsLongitude = 0.0;
+    double gpsLatitude = 0.0;
+    int speedFL = 0;
+    int speedFR = 0;
+    int speedBL = 0;
+    int speedBR = 0;
+    double lateralG = 0.0;
+    double longitudinalG = 0.0;
+    int tempFL = 0;
+    int tempFR = 0;
+    int tempBL = 0;
+    int tempBR = 0;
+};
+
+#endif // TELEMETRYSNAPSHOT_H
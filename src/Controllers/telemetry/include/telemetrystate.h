@@ -0,0 +1,199 @@
+#ifndef TELEMETRYSTATE_H
+#define TELEMETRYSTATE_H
+
+#include "monotonicclock.h"
+#include "telemetrysnapshot.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Single-writer sequence lock around a trivially copyable value
+ *
+ * The writer never blocks. Readers retry while a store is in progress, so a
+ * load always returns one complete store and never a mix of two. The value is
+ * copied word by word through relaxed atomics, which keeps the read side free
+ * of data races.
+ */
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires a trivially copyable type");
+
+public:
+    void store(const T &value)
+    {
+        std::uint64_t words[WordCount] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const std::uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed); // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WordCount; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    T load() const
+    {
+        std::uint64_t words[WordCount];
+        std::uint32_t before;
+        std::uint32_t after;
+        do {
+            before = m_sequence.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < WordCount; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_sequence.load(std::memory_order_relaxed);
+        } while ((before & 1u) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Current sequence number; changes on every store
+     */
+    std::uint32_t sequence() const { return m_sequence.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::size_t WordCount = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint32_t> m_sequence{0};
+    std::array<std::atomic<std::uint64_t>, WordCount> m_words{};
+};
+
+/**
+ * @brief Shared telemetry state written by parser threads and read by the GUI
+ *
+ * Every parser owns one Writer slot, so writers never contend with each other
+ * and never take a lock. Each slot is a seqlock holding the writer's latest
+ * values plus a timestamp per CAN message group. A reader merges the slots by
+ * taking each group from the writer that updated it last, which yields a
+ * consistent snapshot even when frames of one ID are spread over parsers.
+ */
+class TelemetryState
+{
+public:
+    // Fields are grouped by the CAN message that carries them
+    enum Group {
+        ImuAccel,         // 0x072: lateralG, longitudinalG
+        Adc,              // 0x073: accPedal, brakePedal
+        ProximityEncoder, // 0x074: speed, wheel speeds, encoderAngle
+        Gps,              // 0x075: gpsLongitude, gpsLatitude
+        Temperatures,     // 0x076: tire temperatures
+        GroupCount
+    };
+
+    struct Block {
+        TelemetrySnapshot values;
+        std::int64_t updatedAt[GroupCount] = {}; // MonotonicClock ns, 0 = never written
+    };
+
+    /**
+     * @brief Per-parser write handle; must only be used from one thread at a time
+     */
+    class alignas(64) Writer
+    {
+    public:
+        /**
+         * @brief Apply @p update to this writer's values and publish the group
+         * @param group Group whose fields @p update changes
+         * @param update Callable taking a TelemetrySnapshot & to modify
+         */
+        template <typename Fn>
+        void update(Group group, Fn &&update)
+        {
+            update(m_block.values);
+            const std::int64_t now = MonotonicClock::nowNs();
+            m_block.updatedAt[group] = now;
+            m_slot.store(m_block);
+            m_owner->markDirty(now);
+        }
+
+    private:
+        friend class TelemetryState;
+
+        TelemetryState *m_owner = nullptr;
+        Block m_block;
+        SeqLock<Block> m_slot;
+        std::atomic<bool> m_inUse{false};
+    };
+
+    /**
+     * @param maxWriters Number of writer slots (at most one per parser thread)
+     */
+    explicit TelemetryState(int maxWriters = 64);
+    ~TelemetryState();
+
+    TelemetryState(const TelemetryState &) = delete;
+    TelemetryState &operator=(const TelemetryState &) = delete;
+
+    /**
+     * @brief Set a callback run when the state goes from clean to dirty
+     *
+     * Runs on the writing parser thread, at most once between two
+     * takeSnapshot() calls, with the MonotonicClock time (ns) of the write.
+     * Set it before any writer is active.
+     */
+    void setUpdateNotifier(std::function<void(std::int64_t)> notifier);
+
+    /**
+     * @brief Claim a free writer slot
+     * @return The slot, or nullptr if every slot is taken
+     */
+    Writer *acquireWriter();
+
+    /**
+     * @brief Return a slot; its last values stay visible to readers
+     */
+    void releaseWriter(Writer *writer);
+
+    /**
+     * @brief Merge all writer slots into @p snapshot if anything changed
+     *
+     * Intended for a single reader thread (the GUI thread).
+     * @return False if no writer stored anything since the previous call
+     */
+    bool takeSnapshot(TelemetrySnapshot &snapshot);
+
+    /**
+     * @brief Consistent merge of all writer slots, regardless of changes
+     */
+    TelemetrySnapshot snapshot() const;
+
+    /**
+     * @brief Clear all values; call only while no writer is active
+     */
+    void reset();
+
+private:
+    void markDirty(std::int64_t now)
+    {
+        // Pairs with the store in takeSnapshot(): either the reader sees this
+        // write, or this writer sees the flag cleared and notifies again
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!m_dirty.load(std::memory_order_relaxed) && !m_dirty.exchange(true, std::memory_order_acq_rel)) {
+            if (m_notifier) {
+                m_notifier(now);
+            }
+        }
+    }
+
+    static void copyGroup(Group group, const TelemetrySnapshot &from, TelemetrySnapshot &to);
+
+    int m_maxWriters;
+    std::unique_ptr<Writer[]> m_writers;
+    std::unique_ptr<std::uint32_t[]> m_lastSequence; // reader side only
+    std::function<void(std::int64_t)> m_notifier;
+    alignas(64) std::atomic<bool> m_dirty{false}; // read-mostly; written once per flush
+};
+
+#endif // TELEMETRYSTATE_H
@@ -0,0 +1,142 @@
+#include "../include/framededuplicator.h"
+#include "../include/monotonicclock.h"
+#include <algorithm>
+
+FrameDeduplicator::FrameDeduplicator()
+{
+    reset();
+}
+
+FrameDeduplicator::Verdict FrameDeduplicator::classify(int source, std::uint32_t canId, std::uint32_t deviceTimestamp, std::int64_t hostTimeMs)
+{
+    if (!m_enabled.load(std::memory_order_relaxed)) {
+        return Fresh; // Single link: nothing to arbitrate
+    }
+    if (deviceTimestamp == 0 || source < 0 || source >= MAX_SOURCES) {
+        return Fresh; // No identity to deduplicate on
+    }
+
+    SourceCounters &counters = m_sources[source];
+    counters.received.fetch_add(1, std::memory_order_relaxed);
+    const std::int64_t offset = hostTimeMs - deviceTimestamp;
+    counters.offsetSum.fetch_add(offset, std::memory_order_relaxed);
+    updateMin(counters.offsetMin, offset);
+
+    // Fold the extended-ID flag (bit 31) into bit 29, so standard and
+    // extended frames with the same number stay apart in 31 bits
+    const bool extended = (canId & 0x80000000u) != 0;
+    const std::uint32_t id = (canId & 0x1FFFFFFFu) | (extended ? 0x20000000u : 0u);
+
+    // The device timestamp is not 0, so a key never matches an empty entry.
+    // The entry also records which source claimed it: only a copy from
+    // another source is a duplicate
+    const std::uint64_t key = (std::uint64_t(id) << 32) | deviceTimestamp;
+    const std::uint64_t claim = key | (std::uint64_t(source) << WINDOW_SOURCE_SHIFT);
+    const std::uint64_t keyMask = (std::uint64_t(1) << WINDOW_SOURCE_SHIFT) - 1;
+    std::atomic<std::uint64_t> &entry = m_window[(key * 0x9E3779B97F4A7C15ull) >> (64 - WINDOW_BITS)];
+
+    std::uint64_t seen = entry.load(std::memory_order_relaxed);
+    do {
+        if ((seen & keyMask) == key) {
+            if (seen != claim) {
+                counters.duplicates.fetch_add(1, std::memory_order_relaxed);
+                return Duplicate;
+            }
+            break; // Same source again: another frame stamped in the same ms
+        }
+    } while (!entry.compare_exchange_weak(seen, claim, std::memory_order_relaxed));
+
+    counters.accepted.fetch_add(1, std::memory_order_relaxed);
+    m_unique.fetch_add(1, std::memory_order_relaxed);
+
+    // Advance the newest device time for this ID; wrap-safe comparison.
+    // Extended IDs share hashed slots: another ID's entry is evicted, so a
+    // collision reads as a first frame rather than a late one
+    const std::size_t slot = extended
+        ? ID_SLOTS + ((id * 0x9E3779B1u) >> (32 - EXTENDED_SLOT_BITS))
+        : id % ID_SLOTS;
+    const std::uint64_t tag = std::uint64_t(extended ? id : 1u) << 32;
+    std::atomic<std::uint64_t> &newest = m_newest[slot];
+    const std::uint64_t tagged = tag | deviceTimestamp;
+    std::uint64_t current = newest.load(std::memory_order_relaxed);
+    do {
+        if (current == 0 || (current & ~std::uint64_t(0xFFFFFFFFu)) != tag) {
+            continue; // First frame of this ID
+        }
+        const std::uint32_t newestTimestamp = static_cast<std::uint32_t>(current);
+        const std::int32_t behind = static_cast<std::int32_t>(newestTimestamp - deviceTimestamp);
+        const bool restarted = behind > LATE_WINDOW_MS
+            || (deviceTimestamp < RESTART_WINDOW_MS && newestTimestamp >= RESTART_WINDOW_MS);
+        // Equal timestamps are the same-millisecond repeats accepted above
+        if (behind > 0 && !restarted) {
+            counters.late.fetch_add(1, std::memory_order_relaxed);
+            return Late;
+        }
+        // Newer, or the device clock restarted: reseed this ID
+    } while (!newest.compare_exchange_weak(current, tagged, std::memory_order_relaxed));
+
+    return Fresh;
+}
+
+FrameDeduplicator::SourceStats FrameDeduplicator::stats(int source) const
+{
+    SourceStats stats;
+    if (source < 0 || source >= MAX_SOURCES) {
+        return stats;
+    }
+
+    const SourceCounters &counters = m_sources[source];
+    stats.received = counters.received.load(std::memory_order_relaxed);
+    stats.accepted = counters.accepted.load(std::memory_order_relaxed);
+    stats.late = counters.late.load(std::memory_order_relaxed);
+    stats.duplicates = counters.duplicates.load(std::memory_order_relaxed);
+
+    const std::uint64_t unique = m_unique.load(std::memory_order_relaxed);
+    if (unique > 0) {
+        stats.lossRatio = std::max(0.0, 1.0 - static_cast<double>(stats.received) / unique);
+    }
+
+    // The smallest host-device offset over all sources is the fastest path;
+    // a source's latency is how far its average offset sits above it
+    std::int64_t fastest = NO_OFFSET;
+    for (const SourceCounters &other : m_sources) {
+        fastest = std::min(fastest, other.offsetMin.load(std::memory_order_relaxed));
+    }
+    if (stats.received > 0 && fastest != NO_OFFSET) {
+        const double meanOffset = static_cast<double>(counters.offsetSum.load(std::memory_order_relaxed)) / stats.received;
+        stats.latencyMs = meanOffset - static_cast<double>(fastest);
+    }
+
+    return stats;
+}
+
+std::int64_t FrameDeduplicator::hostTimeMs()
+{
+    return MonotonicClock::nowNs() / 1000000;
+}
+
+void FrameDeduplicator::reset()
+{
+    for (std::atomic<std::uint64_t> &entry : m_window) {
+        entry.store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<std::uint64_t> &newest : m_newest) {
+        newest.store(0, std::memory_order_relaxed);
+    }
+    for (SourceCounters &counters : m_sources) {
+        counters.received.store(0, std::memory_order_relaxed);
+        counters.accepted.store(0, std::memory_order_relaxed);
+        counters.late.store(0, std::memory_order_relaxed);
+        counters.duplicates.store(0, std::memory_order_relaxed);
+        counters.offsetSum.store(0, std::memory_order_relaxed);
+        counters.offsetMin.store(NO_OFFSET, std::memory_order_relaxed);
+    }
+    m_unique.store(0, std::memory_order_relaxed);
+}
+
+void FrameDeduplicator::updateMin(std::atomic<std::int64_t> &min, std::int64_t value)
+{
+    std::int64_t current = min.load(std::memory_order_relaxed);
+    while (value < current && !min.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
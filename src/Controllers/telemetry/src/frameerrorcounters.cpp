@@ -0,0 +1,125 @@
+#include "../include/frameerrorcounters.h"
+#include "../../can/include/candecoder.h"
+#include <QStringList>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace {
+
+QString times(quint64 count)
+{
+    return QChar(0x00D7) + QString::number(count);
+}
+
+QString formatId(uint32_t canId)
+{
+    if (canId & CANDecoder::CAN_EFF_FLAG) {
+        return QString("0x%1 (ext)").arg(canId & CANDecoder::CAN_EFF_MASK, 0, 16);
+    }
+    return QString("0x%1").arg(canId, 0, 16);
+}
+
+} // namespace
+
+FrameErrorCounters::FrameErrorCounters()
+{
+    reset();
+}
+
+void FrameErrorCounters::countUnknownId(uint32_t canId)
+{
+    count(UnknownId);
+
+    if (!(canId & CANDecoder::CAN_EFF_FLAG)) {
+        if (canId < STANDARD_IDS) {
+            m_unknownStandard[canId].fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    // Claim or bump the hashed slot; on a collision the frame stays in the
+    // category count only
+    std::atomic<std::uint64_t> &slot = m_unknownExtended[(canId * 0x9E3779B1u) >> (32 - EXTENDED_SLOT_BITS)];
+    std::uint64_t current = slot.load(std::memory_order_relaxed);
+    std::uint64_t next;
+    do {
+        if (current != 0 && static_cast<uint32_t>(current >> 32) != canId) {
+            return;
+        }
+        next = (std::uint64_t(canId) << 32) | ((current & 0xFFFFFFFFu) + 1);
+    } while (!slot.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+QString FrameErrorCounters::takeReport(qint64 intervalMs)
+{
+    std::array<quint64, CategoryCount> pending;
+    bool any = false;
+    for (int category = 0; category < CategoryCount; ++category) {
+        pending[category] = m_pending[category].exchange(0, std::memory_order_relaxed);
+        any = any || pending[category] != 0;
+    }
+    if (!any) {
+        return QString();
+    }
+
+    QStringList parts;
+    if (pending[UnknownId] != 0) {
+        std::vector<std::pair<quint64, uint32_t>> ids; // Count, ID
+        for (std::size_t id = 0; id < STANDARD_IDS; ++id) {
+            if (const uint32_t n = m_unknownStandard[id].exchange(0, std::memory_order_relaxed)) {
+                ids.emplace_back(n, static_cast<uint32_t>(id));
+            }
+        }
+        for (std::atomic<std::uint64_t> &slot : m_unknownExtended) {
+            if (const std::uint64_t entry = slot.exchange(0, std::memory_order_relaxed)) {
+                ids.emplace_back(entry & 0xFFFFFFFFu, static_cast<uint32_t>(entry >> 32));
+            }
+        }
+
+        const std::size_t named = std::min<std::size_t>(ids.size(), REPORTED_IDS);
+        std::partial_sort(ids.begin(), ids.begin() + named, ids.end(),
+                          [](const auto &a, const auto &b) { return a.first > b.first; });
+
+        QStringList listed;
+        quint64 listedFrames = 0;
+        for (std::size_t i = 0; i < named; ++i) {
+            listed << formatId(ids[i].second) + QLatin1Char(' ') + times(ids[i].first);
+            listedFrames += ids[i].first;
+        }
+
+        QString unknown = QStringLiteral("unknown ID ");
+        if (listed.isEmpty()) {
+            unknown += times(pending[UnknownId]); // Only colliding extended IDs
+        } else {
+            unknown += listed.join(QStringLiteral(", "));
+            if (pending[UnknownId] > listedFrames) {
+                unknown += QString(" and %1 more").arg(pending[UnknownId] - listedFrames);
+            }
+        }
+        parts << unknown;
+    }
+    if (pending[InvalidRecord] != 0) {
+        parts << QStringLiteral("invalid record ") + times(pending[InvalidRecord]);
+    }
+    if (pending[DecodeFailure] != 0) {
+        parts << QStringLiteral("decode failure ") + times(pending[DecodeFailure]);
+    }
+
+    return parts.join(QStringLiteral(", "))
+        + QString(" in last %1 s").arg(static_cast<double>(intervalMs) / 1000.0);
+}
+
+void FrameErrorCounters::reset()
+{
+    for (int category = 0; category < CategoryCount; ++category) {
+        m_totals[category].store(0, std::memory_order_relaxed);
+        m_pending[category].store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<std::uint32_t> &id : m_unknownStandard) {
+        id.store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<std::uint64_t> &slot : m_unknownExtended) {
+        slot.store(0, std::memory_order_relaxed);
+    }
+}
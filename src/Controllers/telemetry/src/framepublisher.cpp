@@ -0,0 +1,178 @@
+#include "../include/framepublisher.h"
+#include "../include/monotonicclock.h"
+#include <QQuickWindow>
+
+FramePublisher &FramePublisher::instance()
+{
+    static FramePublisher instance;
+    return instance;
+}
+
+FramePublisher::FramePublisher(QObject *parent)
+    : QObject(parent),
+    m_frameRequested(false),
+    m_oldestStateNs(0),
+    m_inFlightStateNs(0),
+    m_latencySumNs(0),
+    m_latencyMaxNs(0),
+    m_latencyCount(0),
+    m_lastReportNs(nowNs()),
+    m_latencyMs(0.0),
+    m_maxLatencyMs(0.0)
+{
+    m_fallbackTimer.setSingleShot(true);
+    m_fallbackTimer.setInterval(FALLBACK_INTERVAL_MS);
+    m_fallbackTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_fallbackTimer, &QTimer::timeout, this, &FramePublisher::handleFallbackTimeout);
+}
+
+void FramePublisher::setWindow(QQuickWindow *window)
+{
+    if (m_window == window)
+    {
+        return;
+    }
+
+    if (m_window)
+    {
+        disconnect(m_window, nullptr, this, nullptr);
+    }
+
+    m_window = window;
+    m_inFlightStateNs.store(0, std::memory_order_relaxed);
+
+    if (m_window)
+    {
+        m_fallbackTimer.stop();
+        connect(m_window, &QQuickWindow::afterAnimating, this, &FramePublisher::handleAfterAnimating);
+        // frameSwapped is emitted on the render thread; handled there directly
+        connect(m_window, &QQuickWindow::frameSwapped, this, &FramePublisher::handleFrameSwapped, Qt::DirectConnection);
+        connect(m_window, &QObject::destroyed, this, [this]() {
+            // m_window is already null here; continue on the timer
+            m_inFlightStateNs.store(0, std::memory_order_relaxed);
+            if (m_frameRequested)
+            {
+                m_fallbackTimer.start();
+            }
+            emit vsyncAlignedChanged(false);
+        });
+
+        if (m_frameRequested)
+        {
+            m_window->update();
+        }
+    }
+    else if (m_frameRequested)
+    {
+        m_fallbackTimer.start();
+    }
+
+    emit vsyncAlignedChanged(vsyncAligned());
+}
+
+void FramePublisher::requestFrame(qint64 stateTimeNs)
+{
+    if (m_oldestStateNs == 0 || stateTimeNs < m_oldestStateNs)
+    {
+        m_oldestStateNs = stateTimeNs;
+    }
+
+    if (m_frameRequested)
+    {
+        return; // Already scheduled for the next frame
+    }
+    m_frameRequested = true;
+
+    if (m_window)
+    {
+        m_window->update();
+    }
+    else
+    {
+        m_fallbackTimer.start();
+    }
+}
+
+void FramePublisher::handleAfterAnimating()
+{
+    if (!m_frameRequested)
+    {
+        return; // Frame rendered for another reason, nothing to publish
+    }
+
+    // Only one publish is timed at a time; if the previous one has not been
+    // swapped yet this frame is not sampled
+    std::int64_t expected = 0;
+    m_inFlightStateNs.compare_exchange_strong(expected, m_oldestStateNs, std::memory_order_relaxed);
+
+    emitPublish();
+    reportLatency();
+}
+
+void FramePublisher::handleFallbackTimeout()
+{
+    if (!m_frameRequested)
+    {
+        return;
+    }
+
+    const std::int64_t stateNs = m_oldestStateNs;
+    emitPublish();
+    addLatencySample(nowNs() - stateNs);
+    reportLatency();
+}
+
+void FramePublisher::emitPublish()
+{
+    m_frameRequested = false;
+    m_oldestStateNs = 0;
+    emit publish();
+}
+
+void FramePublisher::handleFrameSwapped()
+{
+    const std::int64_t stateNs = m_inFlightStateNs.exchange(0, std::memory_order_relaxed);
+    if (stateNs != 0)
+    {
+        addLatencySample(nowNs() - stateNs);
+    }
+}
+
+void FramePublisher::addLatencySample(std::int64_t latencyNs)
+{
+    m_latencySumNs.fetch_add(latencyNs, std::memory_order_relaxed);
+    m_latencyCount.fetch_add(1, std::memory_order_relaxed);
+
+    std::int64_t max = m_latencyMaxNs.load(std::memory_order_relaxed);
+    while (latencyNs > max && !m_latencyMaxNs.compare_exchange_weak(max, latencyNs, std::memory_order_relaxed))
+    {
+    }
+}
+
+void FramePublisher::reportLatency()
+{
+    const std::int64_t now = nowNs();
+    if (now - m_lastReportNs < REPORT_INTERVAL_NS)
+    {
+        return;
+    }
+    m_lastReportNs = now;
+
+    const std::int64_t count = m_latencyCount.exchange(0, std::memory_order_relaxed);
+    const std::int64_t sum = m_latencySumNs.exchange(0, std::memory_order_relaxed);
+    const std::int64_t max = m_latencyMaxNs.exchange(0, std::memory_order_relaxed);
+    if (count == 0)
+    {
+        return;
+    }
+
+    m_latencyMs = static_cast<double>(sum) / count / 1e6;
+    m_maxLatencyMs = static_cast<double>(max) / 1e6;
+    emit latencyChanged();
+}
+
+std::int64_t FramePublisher::nowNs()
+{
+    // Same clock as the TelemetryState write timestamps
+    return MonotonicClock::nowNs();
+}
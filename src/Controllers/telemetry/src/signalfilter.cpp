@@ -0,0 +1,158 @@
+#include "../include/signalfilter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// QML property names, indexed by SignalFilter::Field
+const char *const FIELD_NAMES[SignalFilter::FieldCount] = {
+    "speed", "rpm", "accPedal", "brakePedal", "encoderAngle", "temperature",
+    "batteryLevel", "gpsLongitude", "gpsLatitude", "speedFL", "speedFR",
+    "speedBL", "speedBR", "lateralG", "longitudinalG", "tempFL", "tempFR",
+    "tempBL", "tempBR"
+};
+
+} // namespace
+
+SignalFilter::SignalFilter()
+    : m_emitted(0),
+    m_suppressed(0)
+{
+    // Defaults follow what the dashboard displays; integer fields stay exact
+    m_settings[Speed] = {0.075, 0.1};           // "%.1f km/h"
+    m_settings[EncoderAngle] = {0.075, 0.1};
+    m_settings[Temperature] = {0.075, 0.1};     // "%.1f °C"
+    m_settings[GpsLongitude] = {0.0, 1e-6};     // ~0.1 m
+    m_settings[GpsLatitude] = {0.0, 1e-6};
+    m_settings[LateralG] = {0.0075, 0.01};      // "%.2f G"
+    m_settings[LongitudinalG] = {0.0075, 0.01};
+}
+
+void SignalFilter::setSettings(Field field, const Settings &settings)
+{
+    m_settings[field].deadband = std::max(0.0, settings.deadband);
+    m_settings[field].resolution = std::max(0.0, settings.resolution);
+}
+
+bool SignalFilter::fieldFromName(const QString &name, Field &field)
+{
+    for (int i = 0; i < FieldCount; ++i)
+    {
+        if (name == QLatin1String(FIELD_NAMES[i]))
+        {
+            field = static_cast<Field>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+quint32 SignalFilter::apply(const TelemetrySnapshot &raw, TelemetrySnapshot &published)
+{
+    quint32 changed = 0;
+
+    for (int i = 0; i < FieldCount; ++i)
+    {
+        const Field field = static_cast<Field>(i);
+        const Settings &settings = m_settings[i];
+        const double current = value(published, field);
+        const double next = value(raw, field);
+
+        // Only a raw change would have produced a notification before filtering
+        if (next == value(m_lastRaw, field))
+        {
+            continue;
+        }
+
+        if (next == current)
+        {
+            continue;
+        }
+
+        double display = next;
+        if (settings.resolution > 0.0)
+        {
+            display = std::round(next / settings.resolution) * settings.resolution;
+        }
+        display = storedValue(field, display);
+
+        if (std::abs(next - current) < settings.deadband || display == current)
+        {
+            ++m_suppressed;
+            continue;
+        }
+
+        setValue(published, field, display);
+        changed |= fieldBit(field);
+        ++m_emitted;
+    }
+
+    m_lastRaw = raw;
+    return changed;
+}
+
+double SignalFilter::value(const TelemetrySnapshot &snapshot, Field field)
+{
+    switch (field)
+    {
+    case Speed: return snapshot.speed;
+    case Rpm: return snapshot.rpm;
+    case AccPedal: return snapshot.accPedal;
+    case BrakePedal: return snapshot.brakePedal;
+    case EncoderAngle: return snapshot.encoderAngle;
+    case Temperature: return snapshot.temperature;
+    case BatteryLevel: return snapshot.batteryLevel;
+    case GpsLongitude: return snapshot.gpsLongitude;
+    case GpsLatitude: return snapshot.gpsLatitude;
+    case SpeedFL: return snapshot.speedFL;
+    case SpeedFR: return snapshot.speedFR;
+    case SpeedBL: return snapshot.speedBL;
+    case SpeedBR: return snapshot.speedBR;
+    case LateralG: return snapshot.lateralG;
+    case LongitudinalG: return snapshot.longitudinalG;
+    case TempFL: return snapshot.tempFL;
+    case TempFR: return snapshot.tempFR;
+    case TempBL: return snapshot.tempBL;
+    case TempBR: return snapshot.tempBR;
+    case FieldCount: break;
+    }
+    return 0.0;
+}
+
+double SignalFilter::storedValue(Field field, double value)
+{
+    // Compare in the field's own type, so a float field does not look changed
+    // forever because its double display value is not representable
+    TelemetrySnapshot snapshot;
+    setValue(snapshot, field, value);
+    return SignalFilter::value(snapshot, field);
+}
+
+void SignalFilter::setValue(TelemetrySnapshot &snapshot, Field field, double value)
+{
+    const int rounded = static_cast<int>(std::lround(value));
+
+    switch (field)
+    {
+    case Speed: snapshot.speed = static_cast<float>(value); break;
+    case Rpm: snapshot.rpm = rounded; break;
+    case AccPedal: snapshot.accPedal = rounded; break;
+    case BrakePedal: snapshot.brakePedal = rounded; break;
+    case EncoderAngle: snapshot.encoderAngle = value; break;
+    case Temperature: snapshot.temperature = static_cast<float>(value); break;
+    case BatteryLevel: snapshot.batteryLevel = rounded; break;
+    case GpsLongitude: snapshot.gpsLongitude = value; break;
+    case GpsLatitude: snapshot.gpsLatitude = value; break;
+    case SpeedFL: snapshot.speedFL = rounded; break;
+    case SpeedFR: snapshot.speedFR = rounded; break;
+    case SpeedBL: snapshot.speedBL = rounded; break;
+    case SpeedBR: snapshot.speedBR = rounded; break;
+    case LateralG: snapshot.lateralG = value; break;
+    case LongitudinalG: snapshot.longitudinalG = value; break;
+    case TempFL: snapshot.tempFL = rounded; break;
+    case TempFR: snapshot.tempFR = rounded; break;
+    case TempBL: snapshot.tempBL = rounded; break;
+    case TempBR: snapshot.tempBR = rounded; break;
+    case FieldCount: break;
+    }
+}
@@ -0,0 +1,127 @@
+#include "../include/telemetrydispatch.h"
+#include "../../logging/include/asynclogger.h"
+#include "../include/framededuplicator.h"
+#include "../include/frameerrorcounters.h"
+
+namespace {
+
+using Context = TelemetryDispatch::Context;
+
+bool handleIMUAngle(const CANDecoder::Frame &, Context &)
+{
+    return false; // Logged by the parser like every frame, not displayed
+}
+
+bool handleIMUAccel(const CANDecoder::Frame &frame, Context &context)
+{
+    const CANDecoder::IMUAccel imuAccel = CANDecoder::decodeIMUAccel(frame.payload);
+    return context.update(TelemetryState::ImuAccel, [&](TelemetrySnapshot &s) {
+        s.lateralG = imuAccel.lateral_g;
+        s.longitudinalG = imuAccel.longitudinal_g;
+    });
+}
+
+bool handleADC(const CANDecoder::Frame &frame, Context &context)
+{
+    const CANDecoder::ADCData adc = CANDecoder::decodeADC(frame.payload);
+    // Suspension channels are decoded offline from the raw log
+    return context.update(TelemetryState::Adc, [&](TelemetrySnapshot &s) {
+        s.accPedal = adc.acc_pedal;
+        s.brakePedal = adc.brake_pedal;
+    });
+}
+
+bool handleProximityEncoder(const CANDecoder::Frame &frame, Context &context)
+{
+    const CANDecoder::ProximityAndEncoder prox = CANDecoder::decodeProximityAndEncoder(frame.payload);
+    return context.update(TelemetryState::ProximityEncoder, [&](TelemetrySnapshot &s) {
+        s.speed = static_cast<float>(prox.speed_kmh);
+        s.speedFL = static_cast<int>(prox.speed_fl);
+        s.speedFR = static_cast<int>(prox.speed_fr);
+        s.speedBL = static_cast<int>(prox.speed_bl);
+        s.speedBR = static_cast<int>(prox.speed_br);
+        s.encoderAngle = static_cast<double>(prox.encoder_angle);
+    });
+}
+
+bool handleGPS(const CANDecoder::Frame &frame, Context &context)
+{
+    const CANDecoder::GPS gps = CANDecoder::decodeGPS(frame.payload);
+    return context.update(TelemetryState::Gps, [&](TelemetrySnapshot &s) {
+        s.gpsLongitude = static_cast<double>(gps.longitude);
+        s.gpsLatitude = static_cast<double>(gps.latitude);
+    });
+}
+
+bool handleTemperatures(const CANDecoder::Frame &frame, Context &context)
+{
+    const CANDecoder::Temperatures temps = CANDecoder::decodeTemperatures(frame.payload);
+    return context.update(TelemetryState::Temperatures, [&](TelemetrySnapshot &s) {
+        s.tempFL = static_cast<int>(temps.temp_fl);
+        s.tempFR = static_cast<int>(temps.temp_fr);
+        s.tempBL = static_cast<int>(temps.temp_rl);
+        s.tempBR = static_cast<int>(temps.temp_rr);
+    });
+}
+
+} // namespace
+
+TelemetryDispatch::Table &TelemetryDispatch::table()
+{
+    static Table table = [] {
+        Table builtIn;
+        builtIn.registerHandler(CANDecoder::CAN_ID_IMU_ANGLE, handleIMUAngle);
+        builtIn.registerHandler(CANDecoder::CAN_ID_IMU_ACCEL, handleIMUAccel);
+        builtIn.registerHandler(CANDecoder::CAN_ID_ADC, handleADC);
+        builtIn.registerHandler(CANDecoder::CAN_ID_PROXIMITY_ENCODER, handleProximityEncoder);
+        builtIn.registerHandler(CANDecoder::CAN_ID_GPS, handleGPS);
+        builtIn.registerHandler(CANDecoder::CAN_ID_TEMPERATURES, handleTemperatures);
+        return builtIn;
+    }();
+    return table;
+}
+
+TelemetryDispatch::Outcome TelemetryDispatch::process(QByteArrayView record, const Source &source)
+{
+    // The payload is a view into the record, so the steady-state path does not allocate
+    CANDecoder::Frame frame;
+    if (!CANDecoder::parseFrame(record, frame)) {
+        if (source.errors) {
+            source.errors->countInvalidRecord();
+        }
+        return Invalid;
+    }
+
+    const FrameDeduplicator::Verdict verdict = source.deduplicator
+        ? source.deduplicator->classify(source.id, frame.id, frame.timestamp, FrameDeduplicator::hostTimeMs())
+        : FrameDeduplicator::Fresh;
+
+    // Capture every received frame, known ID or not and copies from other
+    // links included, for offline reconstruction
+    const quint8 logFlags = verdict == FrameDeduplicator::Duplicate ? TelemetryLog::Duplicate
+        : verdict == FrameDeduplicator::Late ? TelemetryLog::Late : 0;
+    AsyncLogger::instance().logFrame(frame, source.id, logFlags);
+
+    // Copies already received over another link are not applied again
+    if (verdict == FrameDeduplicator::Duplicate) {
+        return Duplicate;
+    }
+
+    const Table::Handler handler = table().find(frame.id);
+    if (!handler) {
+        if (source.errors) {
+            source.errors->countUnknownId(frame.id);
+        }
+        return UnknownId;
+    }
+
+    Context context{source.writer, verdict == FrameDeduplicator::Fresh};
+    try {
+        return handler(frame, context) ? Applied : NotApplied;
+    } catch (...) {
+        if (source.errors) {
+            source.errors->countDecodeFailure();
+        }
+        return Failed;
+    }
+}
@@ -0,0 +1,124 @@
+#include "../include/telemetrystate.h"
+
+TelemetryState::TelemetryState(int maxWriters)
+    : m_maxWriters(maxWriters > 0 ? maxWriters : 1),
+      m_writers(new Writer[m_maxWriters]),
+      m_lastSequence(new std::uint32_t[m_maxWriters]())
+{
+    for (int i = 0; i < m_maxWriters; ++i) {
+        m_writers[i].m_owner = this;
+    }
+}
+
+TelemetryState::~TelemetryState() = default;
+
+void TelemetryState::setUpdateNotifier(std::function<void(std::int64_t)> notifier)
+{
+    m_notifier = std::move(notifier);
+}
+
+TelemetryState::Writer *TelemetryState::acquireWriter()
+{
+    for (int i = 0; i < m_maxWriters; ++i) {
+        bool expected = false;
+        if (m_writers[i].m_inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            return &m_writers[i];
+        }
+    }
+    return nullptr;
+}
+
+void TelemetryState::releaseWriter(Writer *writer)
+{
+    if (writer) {
+        writer->m_inUse.store(false, std::memory_order_release);
+    }
+}
+
+bool TelemetryState::takeSnapshot(TelemetrySnapshot &snapshot)
+{
+    // Clear before scanning so a write racing with this call is either seen
+    // below or raises a fresh notification
+    m_dirty.store(false, std::memory_order_seq_cst);
+
+    bool changed = false;
+    for (int i = 0; i < m_maxWriters; ++i) {
+        const std::uint32_t sequence = m_writers[i].m_slot.sequence();
+        if (sequence != m_lastSequence[i]) {
+            m_lastSequence[i] = sequence;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        snapshot = this->snapshot();
+    }
+    return changed;
+}
+
+TelemetrySnapshot TelemetryState::snapshot() const
+{
+    TelemetrySnapshot merged;
+    std::int64_t newest[GroupCount] = {};
+
+    for (int i = 0; i < m_maxWriters; ++i) {
+        if (m_writers[i].m_slot.sequence() == 0) {
+            continue; // Never written
+        }
+
+        const Block block = m_writers[i].m_slot.load();
+        for (int group = 0; group < GroupCount; ++group) {
+            if (block.updatedAt[group] > newest[group]) {
+                newest[group] = block.updatedAt[group];
+                copyGroup(static_cast<Group>(group), block.values, merged);
+            }
+        }
+    }
+
+    return merged;
+}
+
+void TelemetryState::reset()
+{
+    for (int i = 0; i < m_maxWriters; ++i) {
+        m_writers[i].m_block = Block();
+        m_writers[i].m_slot.store(m_writers[i].m_block);
+        // Clearing is not an update the GUI needs to see
+        m_lastSequence[i] = m_writers[i].m_slot.sequence();
+    }
+    m_dirty.store(false, std::memory_order_relaxed);
+}
+
+void TelemetryState::copyGroup(Group group, const TelemetrySnapshot &from, TelemetrySnapshot &to)
+{
+    switch (group) {
+    case ImuAccel:
+        to.lateralG = from.lateralG;
+        to.longitudinalG = from.longitudinalG;
+        break;
+    case Adc:
+        to.accPedal = from.accPedal;
+        to.brakePedal = from.brakePedal;
+        break;
+    case ProximityEncoder:
+        to.speed = from.speed;
+        to.speedFL = from.speedFL;
+        to.speedFR = from.speedFR;
+        to.speedBL = from.speedBL;
+        to.speedBR = from.speedBR;
+        to.encoderAngle = from.encoderAngle;
+        break;
+    case Gps:
+        to.gpsLongitude = from.gpsLongitude;
+        to.gpsLatitude = from.gpsLatitude;
+        break;
+    case Temperatures:
+        to.tempFL = from.tempFL;
+        to.tempFR = from.tempFR;
+        to.tempBL = from.tempBL;
+        to.tempBR = from.tempBR;
+        break;
+    case GroupCount:
+        break;
+    }
+}
@@ -4,10 +4,15 @@
 #include <QObject>
 #include <QRunnable>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QMutex>
-#include <QQueue>
 #include <QWaitCondition>
 #include <atomic>
+#include "../../telemetry/include/framededuplicator.h"
+#include "../../telemetry/include/frameerrorcounters.h"
+#include "../../telemetry/include/packetring.h"
+#include "../../telemetry/include/telemetrydispatch.h"
+#include "../../telemetry/include/telemetrystate.h"
 
 /**
  * @brief The UdpParserWorker class parses UDP datagrams in a thread pool
@@ -20,7 +25,15 @@ class UdpParserWorker : public QObject, public QRunnable
     Q_OBJECT
 
 public:
-    explicit UdpParserWorker(bool debugMode = false, QObject *parent = nullptr);
+    /**
+     * @param state Shared state that parsed values are written into
+     * @param deduplicator Cross-link frame arbitration, or nullptr for none
+     * @param errors Where rejected frames are counted, or nullptr for none
+     * @param sourceId This transport's index in @p deduplicator
+     */
+    explicit UdpParserWorker(TelemetryState *state, FrameDeduplicator *deduplicator,
+                             FrameErrorCounters *errors, int sourceId,
+                             bool debugMode = false, QObject *parent = nullptr);
     ~UdpParserWorker();
 
     /**
@@ -29,48 +42,42 @@ public:
      */
     void run() override;
 
-public slots:
     /**
-     * @brief Queue a datagram for parsing
-     * @param data The datagram data to parse
+     * @brief Number of datagrams that updated the shared state
      */
-    void queueDatagram(const QByteArray &data);
+    quint64 datagramsParsed() const { return m_datagramsParsed.load(std::memory_order_relaxed); }
 
     /**
-     * @brief Stop the parser worker
+     * @brief Parse a single datagram on the calling thread
+     *
+     * run() calls this for every queued datagram; the benchmarks call it
+     * directly to time the parse path without the queue.
+     * @param data The datagram data to parse
      */
-    void stop();
+    void parseDatagram(QByteArrayView data);
 
-signals:
+public slots:
     /**
-     * @brief Signal emitted when a datagram is successfully parsed
+     * @brief Queue a datagram for parsing
+     * @param data The datagram data to parse
      */
-    void datagramParsed(float speed, int rpm, int accPedal, int brakePedal,
-                        double encoderAngle, float temperature, int batteryLevel,
-                        double gpsLongitude, double gpsLatitude,
-                        int speedFL, int speedFR, int speedBL, int speedBR,
-                        double lateralG, double longitudinalG,
-                        int tempFL, int tempFR, int tempBL, int tempBR);
+    void queueDatagram(const QByteArray &data);
 
     /**
-     * @brief Signal emitted when an error occurs during parsing
-     * @param error The error message
+     * @brief Stop the parser worker
      */
-    void errorOccurred(const QString &error);
+    void stop();
 
 private:
-    /**
-     * @brief Parse a single datagram
-     * @param data The datagram data to parse
-     */
-    void parseDatagram(const QByteArray &data);
-
+    TelemetryState *m_state;
+    TelemetryDispatch::Source m_source; // State slot, arbitration, error counters and link index
     bool m_debugMode;
     std::atomic<bool> m_running;
     std::atomic<quint64> m_datagramsParsed;
 
-    // Thread-safe queue for datagrams
-    QQueue<QByteArray> m_queue;
+    // Datagrams waiting to be parsed; guarded by m_queueMutex
+    static constexpr int MAX_QUEUE_DEPTH = 50;
+    PacketRing<MAX_QUEUE_DEPTH> m_queue;
     QMutex m_queueMutex;
     QWaitCondition m_queueCondition;
 };
@@ -1,22 +1,28 @@
 #include "../include/udpparserworker.h"
-#include "../../can/include/candecoder.h"
-#include "../../logging/include/asynclogger.h"
 #include <QDebug>
 #include <QStringList>
 #include <QThread>
 
 /*A worker class responsible for parsing raw datagram data. It is designed to run in a thread pool,
  *  using a thread-safe queue (internally) to receive datagrams, parse them into numeric values,
- *   and then emit a signal with the parsed values or an error if parsing fails.
+ *   and then write the parsed values into the shared TelemetryState or count an error if parsing fails.
  */
 
-UdpParserWorker::UdpParserWorker(bool debugMode, QObject *parent)
+UdpParserWorker::UdpParserWorker(TelemetryState *state, FrameDeduplicator *deduplicator,
+                                 FrameErrorCounters *errors, int sourceId, bool debugMode, QObject *parent)
     : QObject(parent),
+    m_state(state),
+    m_source{state ? state->acquireWriter() : nullptr, deduplicator, errors, sourceId},
     m_debugMode(debugMode),
     m_running(true),
     m_datagramsParsed(0)
 {
     setAutoDelete(true);
+
+    if (!m_source.writer)
+    {
+        qWarning() << "UDP parser: no free telemetry state slot, parsed values will not reach the GUI";
+    }
 }
 
 UdpParserWorker::~UdpParserWorker()
@@ -24,8 +30,15 @@ UdpParserWorker::~UdpParserWorker()
     stop();
 
     // Clear the queue
-    QMutexLocker locker(&m_queueMutex);
-    m_queue.clear();
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_queue.clear();
+    }
+
+    if (m_state)
+    {
+        m_state->releaseWriter(m_source.writer);
+    }
 }
 
 void UdpParserWorker::run()
@@ -72,7 +85,7 @@ void UdpParserWorker::run()
             // Get the next datagram
             if (!m_queue.isEmpty())
             {
-                datagram = m_queue.dequeue();
+                m_queue.pop(datagram);
             }
             else
             {
@@ -94,14 +107,9 @@ void UdpParserWorker::queueDatagram(const QByteArray &data)
 {
     QMutexLocker locker(&m_queueMutex);
 
-    // Drop oldest datagrams if queue is too deep (prevents unbounded growth)
-    static const int MAX_QUEUE_DEPTH = 50;
-    while (m_queue.size() >= MAX_QUEUE_DEPTH) {
-        m_queue.dequeue();
-    }
-
-    // Add datagram to queue
-    m_queue.enqueue(data);
+    // Add datagram to queue; the oldest one is dropped if the queue is full
+    // (prevents unbounded growth)
+    m_queue.push(data);
 
     // Wake up the worker thread
     m_queueCondition.wakeOne();
@@ -116,142 +124,19 @@ void UdpParserWorker::stop()
     m_queueCondition.wakeAll(); // wake up any thread that might be blocked waiting on the condition variable
 }
 
-void UdpParserWorker::parseDatagram(const QByteArray &data)
+void UdpParserWorker::parseDatagram(QByteArrayView data)
 {
-    try
+    // Only frames that reached the shared state count as parsed
+    if (TelemetryDispatch::process(data, m_source) == TelemetryDispatch::Applied)
     {
-        // Validate CAN packet size (20 bytes)
-        if (data.size() != CANDecoder::PACKET_SIZE)
-        {
-            emit errorOccurred(QString("UDP: Invalid CAN packet size (expected %1 bytes, got %2)")
-                .arg(CANDecoder::PACKET_SIZE).arg(data.size()));
-            return;
-        }
+        m_datagramsParsed++;
 
-        // Extract CAN ID
-        uint32_t canId = CANDecoder::extractCANId(data);
-        QByteArray payload = CANDecoder::extractPayload(data);
-        
-        // Initialize default values
-        float speed = 0.0f;
-        int rpm = 0;
-        int accPedal = 0;
-        int brakePedal = 0;
-        double encoderAngle = 0.0;
-        float temperature = 0.0f;
-        int batteryLevel = 0;
-        double gpsLongitude = 0.0;
-        double gpsLatitude = 0.0;
-        int speedFL = 0;
-        int speedFR = 0;
-        int speedBL = 0;
-        int speedBR = 0;
-        double lateralG = 0.0;
-        double longitudinalG = 0.0;
-        int tempFL = 0;
-        int tempFR = 0;
-        int tempBL = 0;
-        int tempBR = 0;
-        
-        bool shouldEmit = false;
-        
-        // Decode based on CAN ID
-        switch (canId)
+        // Log debug info occasionally
+        if (m_debugMode && m_datagramsParsed % 1000 == 0)
         {
-        case CANDecoder::CAN_ID_IMU_ANGLE: // 0x071
-        {
-            auto imuAngle = CANDecoder::decodeIMUAngle(payload);
-            AsyncLogger::instance().logIMU(imuAngle.ang_x, imuAngle.ang_y, imuAngle.ang_z);
-            // Log only, no GUI update
-            break;
-        }
-        
-        case CANDecoder::CAN_ID_IMU_ACCEL: // 0x072
-        {
-            auto imuAccel = CANDecoder::decodeIMUAccel(payload);
-            lateralG = imuAccel.lateral_g;
-            longitudinalG = imuAccel.longitudinal_g;
-            shouldEmit = true;
-            break;
+            qDebug() << "Parser" << QThread::currentThreadId()
+                     << "has processed" << m_datagramsParsed << "datagrams";
         }
-        
-        case CANDecoder::CAN_ID_ADC: // 0x073
-        {
-            auto adc = CANDecoder::decodeADC(payload);
-            accPedal = adc.acc_pedal;
-            brakePedal = adc.brake_pedal;
-            AsyncLogger::instance().logSuspension(adc.sus_1, adc.sus_2, adc.sus_3, adc.sus_4);
-            shouldEmit = true;
-            break;
-        }
-        
-        case CANDecoder::CAN_ID_PROXIMITY_ENCODER: // 0x074
-        {
-            auto prox = CANDecoder::decodeProximityAndEncoder(payload);
-            speed = prox.speed_kmh;
-            speedFL = static_cast<int>(prox.speed_fl);
-            speedFR = static_cast<int>(prox.speed_fr);
-            speedBL = static_cast<int>(prox.speed_bl);
-            speedBR = static_cast<int>(prox.speed_br);
-            encoderAngle = prox.encoder_angle;
-            shouldEmit = true;
-            break;
-        }
-        
-        case CANDecoder::CAN_ID_GPS: // 0x075
-        {
-            auto gps = CANDecoder::decodeGPS(payload);
-            gpsLongitude = gps.longitude;
-            gpsLatitude = gps.latitude;
-            shouldEmit = true;
-            break;
-        }
-        
-        case CANDecoder::CAN_ID_TEMPERATURES: // 0x076
-        {
-            auto temps = CANDecoder::decodeTemperatures(payload);
-            tempFL = static_cast<int>(temps.temp_fl);
-            tempFR = static_cast<int>(temps.temp_fr);
-            tempBL = static_cast<int>(temps.temp_rl);
-            tempBR = static_cast<int>(temps.temp_rr);
-            shouldEmit = true;
-            break;
-        }
-        
-        default:
-            emit errorOccurred(QString("UDP: Unknown CAN ID: 0x%1").arg(canId, 0, 16));
-            return;
-        }
-        
-        // Emit parsed data if needed
-        if (shouldEmit)
-        {
-            // Increment counter
-            m_datagramsParsed++;
-            
-            emit datagramParsed(
-                speed, rpm, accPedal, brakePedal,
-                encoderAngle, temperature, batteryLevel,
-                gpsLongitude, gpsLatitude,
-                speedFL, speedFR, speedBL, speedBR,
-                lateralG, longitudinalG,
-                tempFL, tempFR, tempBL, tempBR);
-            
-            // Log debug info occasionally
-            if (m_debugMode && m_datagramsParsed % 1000 == 0)
-            {
-                qDebug() << "Parser" << QThread::currentThreadId()
-                         << "has processed" << m_datagramsParsed << "datagrams";
-            }
-        }
-    }
-    catch (const std::exception &e)
-    {
-        emit errorOccurred(QString("UDP: Exception during CAN decoding: %1").arg(e.what()));
-    }
-    catch (...)
-    {
-        emit errorOccurred("UDP: Unknown exception during CAN decoding");
     }
 }
 
@@ -61,6 +61,22 @@ Rectangle {
         }
     }
 
+    Text {
+        id : latencyText
+        // Mean state-to-pixel latency over the last second
+        text : "Latency : " + framePublisher.latencyMs.toFixed(1) + " ms"
+        color : "white"
+        font {
+            family : "DS-Digital"
+            pixelSize : Math.max(12, 18 * scaleFactor)
+        }
+        anchors {
+            verticalCenter : parent.verticalCenter
+            right : portNumberText.left
+            rightMargin : 20 * scaleFactor
+        }
+    }
+
     Timer {
         interval: 1000 // Updates every second
         running: true